@@ -0,0 +1,59 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* include/kernel/acpi.h
+ *
+ * ACPI tables lookup header file
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#ifndef ACPI_H
+#define ACPI_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Tables are read before the memory managers exist, through two 4MB pages
+ * mapped at ACPI_WINDOW. The window is only valid until acpi_done.
+ */
+#define ACPI_WINDOW			0xFF000000
+#define ACPI_WINDOW_SIZE	(8 * 1024 * 1024)
+
+#define ACPI_RSDP_SIGNATURE	"RSD PTR "
+
+struct acpi_rsdp {
+	char signature[8];
+	uint8_t checksum;
+	char oem[6];
+	uint8_t revision;
+	uint32_t rsdt;
+} __attribute__((packed));
+
+struct acpi_header {
+	char signature[4];
+	uint32_t length;
+	uint8_t revision;
+	uint8_t checksum;
+	char oem[6];
+	char oem_table[8];
+	uint32_t oem_revision;
+	uint32_t creator;
+	uint32_t creator_revision;
+} __attribute__((packed));
+
+/*
+ * Returns the table whose signature is @signature, mapped in the window,
+ * or NULL if there is no such table. The table stays mapped until the
+ * next call.
+ */
+struct acpi_header *acpi_find(const char *signature);
+
+/*
+ * Unmaps the window, called by numa_init once SRAT/SLIT are parsed.
+ */
+void acpi_done();
+
+#endif
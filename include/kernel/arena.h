@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* include/kernel/arena.h
+ *
+ * Bump allocator arenas header file
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#include <kernel/kpm.h>
+
+/*
+ * Arenas grow by chunks of page frames from kpm, mapped in the vmalloc
+ * area. Allocations are carved one after the other from the last chunk
+ * and never released one by one: the whole arena, or everything allocated
+ * since a mark, is released at once.
+ */
+#define ARENA_CHUNK_SIZE	(16 * PAGE_SIZE)
+#define ARENA_ALIGN			8
+
+/*
+ * A chunk starts with this header. @used counts its bytes in use, header
+ * included.
+ */
+struct arena_chunk {
+	struct arena_chunk *prev;
+	kpm_chunk_t frames;
+	size_t used;
+};
+
+/*
+ * @current is the chunk allocations are made from, the previous ones are
+ * linked from it. @spare is a released chunk kept for the next growth, so
+ * that an arena reset after each use does not go through kpm each time.
+ */
+struct arena {
+	struct arena_chunk *current;
+	struct arena_chunk *spare;
+};
+
+/*
+ * The state of an arena at some point, to go back to with arena_reset
+ */
+struct arena_mark {
+	struct arena_chunk *chunk;
+	size_t used;
+};
+
+#define ARENA_INIT	{NULL, NULL}
+
+/*
+ * Allocates @size bytes aligned on ARENA_ALIGN from @arena.
+ * Returns NULL when out of memory
+ */
+void *arena_alloc(struct arena *arena, size_t size);
+
+/*
+ * Returns the current state of @arena
+ */
+struct arena_mark arena_mark(struct arena *arena);
+
+/*
+ * Releases everything allocated from @arena since @mark was taken.
+ */
+void arena_reset(struct arena *arena, struct arena_mark mark);
+
+/*
+ * Releases all the memory of @arena, spare chunk included.
+ */
+void arena_release(struct arena *arena);
+
+#endif
@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* include/kernel/bitmap.h
+ *
+ * Bitmaps of 32-bit words
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#ifndef BITMAP_H
+#define BITMAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Bit i of a bitmap is bit i % 32 of its word i / 32: on x86, the same
+ * layout as bit i % 8 of its byte i / 8.
+ * Searches return the index of the bit found, or -1.
+ */
+typedef uint32_t bitmap_t;
+
+#define BITMAP_WORD_BITS	32
+#define BITMAP_WORDS(nbits)	(((nbits) + BITMAP_WORD_BITS - 1) / BITMAP_WORD_BITS)
+#define BITMAP_WORD(bit)	((bit) / BITMAP_WORD_BITS)
+#define BITMAP_MASK(bit)	((bitmap_t)1 << ((bit) % BITMAP_WORD_BITS))
+
+static inline void bitmap_set_bit(bitmap_t *map, size_t bit) {
+	map[BITMAP_WORD(bit)] |= BITMAP_MASK(bit);
+}
+
+static inline void bitmap_clear_bit(bitmap_t *map, size_t bit) {
+	map[BITMAP_WORD(bit)] &= ~BITMAP_MASK(bit);
+}
+
+static inline int bitmap_test_bit(const bitmap_t *map, size_t bit) {
+	return (map[BITMAP_WORD(bit)] & BITMAP_MASK(bit)) != 0;
+}
+
+/*
+ * Sets or clears the @len bits from @start.
+ */
+void bitmap_set(bitmap_t *map, size_t start, size_t len);
+void bitmap_clear(bitmap_t *map, size_t start, size_t len);
+
+/*
+ * Returns the first bit set, or clear, from @start in the @nbits bits of
+ * @map.
+ */
+int bitmap_find_next_bit(const bitmap_t *map, size_t nbits, size_t start);
+int bitmap_find_next_zero(const bitmap_t *map, size_t nbits, size_t start);
+
+static inline int bitmap_find_first_bit(const bitmap_t *map, size_t nbits) {
+	return bitmap_find_next_bit(map, nbits, 0);
+}
+
+static inline int bitmap_find_first_zero(const bitmap_t *map, size_t nbits) {
+	return bitmap_find_next_zero(map, nbits, 0);
+}
+
+/*
+ * Returns the last bit set in the @nbits bits of @map.
+ */
+int bitmap_find_last_bit(const bitmap_t *map, size_t nbits);
+
+/*
+ * Returns the first bit from @start, a multiple of @align, starting @len
+ * clear bits in the @nbits bits of @map. @align is a power of two.
+ */
+int bitmap_find_next_zero_area(const bitmap_t *map, size_t nbits, size_t start, size_t len, size_t align);
+
+/*
+ * Returns the number of bits set in the @nbits bits of @map.
+ */
+size_t bitmap_weight(const bitmap_t *map, size_t nbits);
+
+#endif
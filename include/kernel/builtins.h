@@ -6,7 +6,7 @@
  * Builtins functions for shell.
  *
  * created: 2022/11/17 - mrxx0 <chcoutur@student.42.fr>
- * updated: 2022/12/09 - xlmod <glafond-@student.42.fr>
+ * updated: 2026/10/19 - agent <agent@local>
  */
 
 #ifndef BUILTINS_H
@@ -30,4 +30,8 @@ int interrupt(int argc, char **argv);
 
 int hexdump(int argc, char **argv);
 
+int bench(int argc, char **argv);
+int numa(int argc, char **argv);
+int vt(int argc, char **argv);
+
 #endif
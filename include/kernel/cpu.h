@@ -0,0 +1,136 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* include/kernel/cpu.h
+ *
+ * Small wrappers around x86 instructions and control registers
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#ifndef CPU_H
+#define CPU_H
+
+#include <stdint.h>
+
+/*
+ * Returns the number of cycles since reset (time stamp counter)
+ */
+static inline uint64_t rdtsc() {
+	uint32_t lo, hi;
+
+	__asm__ volatile ("rdtsc" : "=a" (lo), "=d" (hi));
+	return ((uint64_t)hi << 32) | lo;
+}
+
+/*
+ * Returns the index of the current cpu, there is only one for now
+ */
+static inline int cpu_id() {
+	return 0;
+}
+
+#define EFLAGS_IF	(1 << 9)
+
+/*
+ * Disables interrupts.
+ * Returns the previous EFLAGS, to give to cpu_irq_restore
+ */
+static inline uint32_t cpu_irq_save() {
+	uint32_t flags;
+
+	__asm__ volatile ("pushf\n\tpop %0\n\tcli" : "=r" (flags) :: "memory");
+	return flags;
+}
+
+/*
+ * Enables interrupts again if they were enabled when @flags were saved.
+ */
+static inline void cpu_irq_restore(uint32_t flags) {
+	if (flags & EFLAGS_IF)
+		__asm__ volatile ("sti" ::: "memory");
+}
+
+/*
+ * Executes cpuid for @leaf (sub-leaf 0), filling @regs with eax, ebx, ecx
+ * and edx
+ */
+static inline void cpuid(uint32_t leaf, uint32_t regs[4]) {
+	__asm__ volatile ("cpuid"
+		: "=a" (regs[0]), "=b" (regs[1]), "=c" (regs[2]), "=d" (regs[3])
+		: "a" (leaf), "c" (0));
+}
+
+#define CPUID_1_EDX_PSE		(1 << 3)
+#define CPUID_1_EDX_FXSR	(1 << 24)
+#define CPUID_1_EDX_SSE		(1 << 25)
+#define CPUID_1_EDX_SSE2	(1 << 26)
+#define CPUID_7_EBX_ERMS	(1 << 9)
+#define CPUID_7_EDX_FSRM	(1 << 4)
+
+/*
+ * Returns the local APIC id of the current cpu
+ */
+static inline uint8_t cpu_apic_id() {
+	uint32_t regs[4];
+
+	cpuid(1, regs);
+	return regs[1] >> 24;
+}
+
+/*
+ * Returns the size of a cache line, as used by clflush
+ */
+static inline uint32_t cpu_cache_line() {
+	uint32_t regs[4];
+	uint32_t line;
+
+	cpuid(1, regs);
+	line = ((regs[1] >> 8) & 0xff) * 8;
+	return line ? line : 64;
+}
+
+#define CR0_MP	(1 << 1)
+#define CR0_EM	(1 << 2)
+#define CR0_TS	(1 << 3)
+#define CR0_NE	(1 << 5)
+#define CR0_WP	(1 << 16)
+
+static inline uint32_t read_cr0() {
+	uint32_t cr0;
+
+	__asm__ volatile ("movl %%cr0, %0" : "=r" (cr0));
+	return cr0;
+}
+
+static inline void write_cr0(uint32_t cr0) {
+	__asm__ volatile ("movl %0, %%cr0" :: "r" (cr0) : "memory");
+}
+
+#define CR4_PSE			(1 << 4)
+#define CR4_OSFXSR		(1 << 9)
+#define CR4_OSXMMEXCPT	(1 << 10)
+
+static inline uint32_t read_cr4() {
+	uint32_t cr4;
+
+	__asm__ volatile ("movl %%cr4, %0" : "=r" (cr4));
+	return cr4;
+}
+
+static inline void write_cr4(uint32_t cr4) {
+	__asm__ volatile ("movl %0, %%cr4" :: "r" (cr4) : "memory");
+}
+
+/*
+ * Returns the linear address that caused the last page fault
+ */
+static inline uint32_t read_cr2() {
+	uint32_t cr2;
+
+	__asm__ volatile ("movl %%cr2, %0" : "=r" (cr2));
+	return cr2;
+}
+
+#endif
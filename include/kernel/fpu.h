@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* include/kernel/fpu.h
+ *
+ * Kernel SIMD sections and SSE2 page kernels header file
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#ifndef FPU_H
+#define FPU_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * The kernel is built with -mgeneral-regs-only, SIMD registers are only
+ * used by the assembly kernels of sse.s, between kernel_fpu_begin and
+ * kernel_fpu_end.
+ */
+
+/* Sections nested in interrupt handlers that can save the state they cut */
+#define FPU_MAX_DEPTH	4
+
+/* Size of the FXSAVE area */
+#define FPU_STATE_SIZE	512
+
+/* 1 if SSE2 was enabled by fpu_init, may be set to 0 to use scalar code */
+extern int fpu_sse2;
+
+/*
+ * Enables the FPU and, when the cpu has them, SSE and SSE2 with FXSAVE
+ * (CR4.OSFXSR) and SIMD exceptions (CR4.OSXMMEXCPT).
+ */
+void fpu_init();
+
+/*
+ * Starts a section using the SIMD registers. Sections may nest, when an
+ * interrupt handler uses them while another section runs: the state of
+ * the interrupted section is then saved with FXSAVE. The outermost section
+ * has nothing to save. Nesting deeper than FPU_MAX_DEPTH halts the kernel.
+ */
+void kernel_fpu_begin();
+
+/*
+ * Ends the section started by the last kernel_fpu_begin, restoring the
+ * state of the section it interrupted.
+ */
+void kernel_fpu_end();
+
+/*
+ * Copies the page at @src to @dst, both page aligned.
+ */
+void copy_page(void *dst, const void *src);
+
+/*
+ * Zeroes the page @page with non-temporal stores, which do not fill the
+ * cache: for pages that are not used right away.
+ */
+void clear_page(void *page);
+
+/*
+ * Returns the Internet checksum (RFC 1071) of the @n bytes at @buf: the
+ * ones' complement of the ones' complement sum of their 16-bit words.
+ */
+uint16_t csum(const void *buf, size_t n);
+
+/* SSE2 kernels of sse.s, for sections only */
+void sse2_copy_page(void *dst, const void *src);
+void sse2_clear_page(void *page);
+
+/*
+ * Returns the sum of the 16-bit words of @nblocks blocks of 64 bytes at
+ * @buf, at most 1024 so that it fits on 32 bits.
+ */
+uint32_t sse2_csum(const void *buf, size_t nblocks);
+
+#endif
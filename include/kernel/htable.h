@@ -0,0 +1,110 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* include/kernel/htable.h
+ *
+ * Open addressing hash tables
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#ifndef HTABLE_H
+#define HTABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Slot of a table, given by the caller with the table: the table stores
+ * pointers to the elements with their hash, so that probes only compare
+ * the keys of elements with the same hash.
+ */
+struct htable_slot {
+	void *elem;
+	uint32_t hash;
+};
+
+/*
+ * Linear probing hash table, filled up to 7/8 of its slots. Removals move
+ * the following elements of the probe sequence back instead of leaving
+ * tombstones.
+ */
+struct htable {
+	struct htable_slot *slots;
+	size_t mask;
+	size_t count;
+	// Returns non zero if the key of @elem is @key
+	int (*match)(const void *elem, const void *key);
+};
+
+/*
+ * Initializes @table over the @nslots slots at @slots, a power of two.
+ */
+void htable_init(struct htable *table, struct htable_slot *slots, size_t nslots, int (*match)(const void *, const void *));
+
+/*
+ * Inserts @elem, whose key is @key, hashing to @hash.
+ * Returns 0, or -1 if an element with the same key is already in the
+ * table or the table is full.
+ */
+int htable_insert(struct htable *table, void *elem, const void *key, uint32_t hash);
+
+/*
+ * Returns the element whose key is @key, hashing to @hash, or NULL.
+ */
+void *htable_find(const struct htable *table, const void *key, uint32_t hash);
+
+/*
+ * Removes and returns the element whose key is @key, hashing to @hash, or
+ * returns NULL.
+ */
+void *htable_remove(struct htable *table, const void *key, uint32_t hash);
+
+/*
+ * Hash functions
+ */
+static inline uint32_t hash_u32(uint32_t x) {
+	// Finalizer of MurmurHash3
+	x ^= x >> 16;
+	x *= 0x85EBCA6B;
+	x ^= x >> 13;
+	x *= 0xC2B2AE35;
+	x ^= x >> 16;
+	return x;
+}
+
+static inline uint32_t hash_str(const char *s) {
+	// FNV-1a
+	uint32_t h = 2166136261U;
+
+	while (*s)
+		h = (h ^ (uint8_t)*s++) * 16777619U;
+	return h;
+}
+
+/*
+ * Defines the functions name_init, name_insert, name_find and name_remove
+ * over tables of @type elements, whose key is the const @keytype pointer
+ * returned by @keyof for an element. @hash hashes a key and @equal returns
+ * non zero if two keys are equal, both taking const @keytype pointers.
+ */
+#define HTABLE_DEFINE(name, type, keytype, keyof, hash, equal) \
+static int name##_match(const void *elem, const void *key) { \
+	return equal(keyof((const type *)elem), (const keytype *)key); \
+} \
+static inline void name##_init(struct htable *table, struct htable_slot *slots, size_t nslots) { \
+	htable_init(table, slots, nslots, name##_match); \
+} \
+static inline int name##_insert(struct htable *table, type *elem) { \
+	const keytype *key = keyof(elem); \
+	return htable_insert(table, elem, key, hash(key)); \
+} \
+static inline type *name##_find(const struct htable *table, const keytype *key) { \
+	return htable_find(table, key, hash(key)); \
+} \
+static inline type *name##_remove(struct htable *table, const keytype *key) { \
+	return htable_remove(table, key, hash(key)); \
+}
+
+#endif
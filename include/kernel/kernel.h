@@ -6,12 +6,20 @@
  * Header file of the kernel
  *
  * created: 2022/12/12 - xlmod <glafond-@student.42.fr>
- * updated: 2022/12/15 - glafond- <glafond-@student.42.fr>
+ * updated: 2026/10/19 - agent <agent@local>
  */
 
 #ifndef KERNEL_H
 #define KERNEL_H
 
+#include <stddef.h>
+
 #define KERNEL_VIRT_OFFSET	0xC0000000
 
+/*
+ * Returns the struct of type @type holding @ptr, the address of its
+ * member @member.
+ */
+#define container_of(ptr, type, member)	((type *)((char *)(ptr) - offsetof(type, member)))
+
 #endif
@@ -6,7 +6,7 @@
  * Header file for the keyboard driver
  *
  * created: 2022/10/15 - lfalkau <lfalkau@student.42.fr>
- * updated: 2022/12/14 - glafond- <glafond-@student.42.fr>
+ * updated: 2026/10/19 - agent <agent@local>
  */
 
 #ifndef KEYBOARD_H
@@ -185,6 +185,8 @@ struct kbd_state {
 	int ext;
 };
 
+extern struct kbd_state kbd_st;
+
 /* keymap entry flags */
 #define NO_MOD   0b100 /* No modifier has effect (regular form is used) */
 #define CAPSLOCK 0b010 /* Capslock has effect (is xored with shift) */
@@ -0,0 +1,44 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* include/kernel/kmap.h
+ *
+ * Temporary mappings of arbitrary page frames header file
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#ifndef KMAP_H
+#define KMAP_H
+
+#include <stdint.h>
+
+#include <kernel/paging.h>
+
+/*
+ * The fixmap area is covered by a single page table allocated at boot,
+ * so that mapping a slot never needs to allocate memory.
+ * Each cpu owns KMAP_SLOTS consecutive pages of it.
+ */
+#define FIXMAP_BASE		0xFF800000
+#define KMAP_NCPUS		1
+#define KMAP_SLOTS		16
+
+#define PFN(phys)		(((uintptr_t)(phys)) >> 12)
+
+void kmap_init();
+
+/*
+ * Maps the page frame @pfn in the next free slot of the current cpu and
+ * returns its virtual address. Costs one page table entry write and one
+ * invlpg. Mappings are released in reverse order with kunmap_atomic.
+ */
+void *kmap_atomic(uint32_t pfn);
+
+/*
+ * Releases the last mapping made by kmap_atomic, @addr being its address.
+ */
+void kunmap_atomic(void *addr);
+
+#endif
@@ -6,7 +6,7 @@
  * Kernel Physical Memory management header file
  *
  * created: 2022/11/23 - lfalkau <lfalkau@student.42.fr>
- * updated: 2022/12/07 - lfalkau <lfalkau@student.42.fr>
+ * updated: 2026/10/19 - agent <agent@local>
  */
 
 #ifndef KPM_H
@@ -15,7 +15,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
-#include <kernel/multiboot.h>
+#include <kernel/numa.h>
+#include <kernel/bitmap.h>
 
 #define PAGE_SIZE		4096
 
@@ -27,20 +28,18 @@
 #define KPM_NORDERS		11
 
 /*
- * Represents a page frame.
+ * Each page frame, or block of an order, is a bit of a bitmap.
  */
-typedef uint8_t bitmap_t;
+#define KPM_NBYTES_FROM_NBITS(n)		(BITMAP_WORDS(n) * sizeof(bitmap_t))
 
-#define KPM_NBYTES_FROM_NBITS(n)		(ALIGNNEXT(n, 8) / 8)
+#define KPM_ALLOC(b, order, index)			bitmap_set_bit((b)->orders[order].bitmap, index)
+#define KPM_FREE(b, order, index)			bitmap_clear_bit((b)->orders[order].bitmap, index)
+#define KPM_GET(b, order, index)			bitmap_test_bit((b)->orders[order].bitmap, index)
+#define KPM_IS_ALLOCATED(b, order, index)	(KPM_GET(b, order, index) != 0)
 
-#define KPM_ALLOC(order, index)			(buddy->orders[order].bitmap[(index)/8] |= (1 << ((index) % 8)))
-#define KPM_FREE(order, index)			(buddy->orders[order].bitmap[(index)/8] &= ~(1 << ((index) % 8)))
-#define KPM_GET(order, index)			(buddy->orders[order].bitmap[(index)/8] & (1 << ((index) % 8)))
-#define KPM_IS_ALLOCATED(order, index)	(KPM_GET(order, index) != 0)
-
-#define KPM_ENABLE(index)				(buddy->enabled_frames[(index)/8] |= (1 << ((index) % 8)))
-#define KPM_DISABLE(index)				(buddy->enabled_frames[(index)/8] &= ~(1 << ((index) % 8)))
-#define KPM_IS_ENABLED(index)			((buddy->enabled_frames[(index)/8] & (1 << ((index) % 8))) != 0)
+#define KPM_ENABLE(b, index)				bitmap_set_bit((b)->enabled_frames, index)
+#define KPM_DISABLE(b, index)				bitmap_clear_bit((b)->enabled_frames, index)
+#define KPM_IS_ENABLED(b, index)			bitmap_test_bit((b)->enabled_frames, index)
 
 struct order {
 	bitmap_t *bitmap;
@@ -54,9 +53,11 @@ struct order {
  * than the previous.
  *
  * @nareas is the number of page frame of the smallest size (KB).
+ * @base is the first page frame it covers, indexes are relative to it.
  * @orders is the pointer to the array of orders.
  */
 typedef struct buddy {
+	size_t base;
 	size_t nframes;
 	size_t size;
 	bitmap_t *enabled_frames;
@@ -76,13 +77,47 @@ typedef struct kpm_chunk {
 } kpm_chunk_t;
 
 /*
- * Creates and itinialize the buddy allocator with memory maps information.
+ * One buddy allocator per memory node.
+ * @free is the number of free page frames.
+ * @hits counts the allocations that wanted this node and got it, @misses
+ * those that wanted another node but got this one, @foreign those that
+ * wanted this node but got another one.
+ * @fallback lists the nodes by increasing distance, this one first.
+ */
+struct kpm_node {
+	buddy_t *buddy;
+	uint32_t free;
+	uint32_t hits;
+	uint32_t misses;
+	uint32_t foreign;
+	uint8_t fallback[NUMA_MAX_NODES];
+};
+
+/*
+ * What happens when the wanted node has no free memory: KPM_PREFERRED
+ * falls back to the nearest node that has some, KPM_BIND fails.
+ */
+enum kpm_policy {
+	KPM_PREFERRED,
+	KPM_BIND,
+};
+
+extern struct kpm_node kpm_nodes[NUMA_MAX_NODES];
+extern enum kpm_policy kpm_policy;
+
+/* Number of page frames the nodes span, from the first one */
+extern size_t kpm_nframes;
+
+/*
+ * Creates and itinialize the buddy allocator with the RAM ranges of the
+ * resource tree, resource_init must have been called.
  * Our buddy allocator contains 11 levels, allowing for allocations from
  * 4KB to 4MB.
  *
- * Internally stores the address of the buddy structure
+ * There is one buddy allocator per node found by numa_init, they are
+ * stored after the kernel image.
  */
-void kpm_init(struct multiboot_mmap_entry *mmap_entries, size_t n, size_t memsize);
+void kpm_init(size_t memsize);
 
 /*
  * Enables or disable memory regison to make them available or not
@@ -99,11 +134,17 @@ int kpm_isenabled(void *addr);
 int kpm_isalloc(void *addr);
 
 /*
- * Allocate @size bytes of memory
+ * Allocate @size bytes of memory, on the node of the current cpu
  * Returns the address of the newly allocated region, or NULL on error
  */
 int kpm_alloc(kpm_chunk_t *chunk, size_t size);
 
+/*
+ * Same as kpm_alloc, on the node @node, then on others depending on
+ * kpm_policy.
+ */
+int kpm_alloc_node(kpm_chunk_t *chunk, size_t size, int node);
+
 /*
  * Release the buddy node starting at addr @addr
  */
@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* include/kernel/ksm.h
+ *
+ * Same page merging header file
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#ifndef KSM_H
+#define KSM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Candidate pages are remembered by content hash, one per bucket */
+#define KSM_NBUCKETS		1024
+#define KSM_PAGES_PER_TICK	64
+
+/*
+ * @shared is the number of merged frames and @sharing the number of
+ * mappings of them, both as of the last full scan, so that
+ * @sharing - @shared frames are saved.
+ * @merged counts every page merged so far, @cycles the time spent scanning.
+ */
+struct ksm_stats {
+	uint32_t scanned;
+	uint32_t full_scans;
+	uint32_t merged;
+	uint32_t shared;
+	uint32_t sharing;
+	uint64_t cycles;
+};
+
+extern struct ksm_stats ksm_stats;
+extern uint32_t ksm_pages_to_scan;
+
+/*
+ * Starts scanning ksm_pages_to_scan pages every timer tick,
+ * must be called after timer_init.
+ */
+void ksm_init();
+
+/*
+ * Scans the next @n anonymous pages of the current address space,
+ * merging those whose content is already held by another frame.
+ */
+void ksm_scan(size_t n);
+
+#endif
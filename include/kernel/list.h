@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* include/kernel/list.h
+ *
+ * Intrusive doubly linked lists
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#ifndef LIST_H
+#define LIST_H
+
+#include <kernel/kernel.h>
+
+/*
+ * Node embedded in the elements of a list, and head of the list: lists
+ * are circular, the head being the node before the first element and
+ * after the last one. An empty list is a head pointing to itself.
+ */
+struct list_head {
+	struct list_head *next;
+	struct list_head *prev;
+};
+
+#define LIST_HEAD_INIT(name)	{ &(name), &(name) }
+
+static inline void list_init(struct list_head *head) {
+	head->next = head;
+	head->prev = head;
+}
+
+static inline int list_empty(const struct list_head *head) {
+	return head->next == head;
+}
+
+static inline void __list_insert(struct list_head *node, struct list_head *prev, struct list_head *next) {
+	node->prev = prev;
+	node->next = next;
+	prev->next = node;
+	next->prev = node;
+}
+
+/*
+ * Inserts @node at the start of the list @head.
+ */
+static inline void list_add(struct list_head *head, struct list_head *node) {
+	__list_insert(node, head, head->next);
+}
+
+/*
+ * Inserts @node at the end of the list @head.
+ */
+static inline void list_add_tail(struct list_head *head, struct list_head *node) {
+	__list_insert(node, head->prev, head);
+}
+
+/*
+ * Removes @node from its list. It is left pointing to itself, so that
+ * removing it again does nothing.
+ */
+static inline void list_del(struct list_head *node) {
+	node->prev->next = node->next;
+	node->next->prev = node->prev;
+	list_init(node);
+}
+
+#define list_for_each(pos, head) \
+	for ((pos) = (head)->next; (pos) != (head); (pos) = (pos)->next)
+
+/* Iterates over the list @head, @pos may be removed from it */
+#define list_for_each_safe(pos, tmp, head) \
+	for ((pos) = (head)->next, (tmp) = (pos)->next; (pos) != (head); (pos) = (tmp), (tmp) = (pos)->next)
+
+/*
+ * Defines the functions name_add, name_add_tail, name_del, name_first,
+ * name_last, name_next and name_prev over lists of @type elements linked
+ * by their struct list_head @member. name_first, name_last, name_next and
+ * name_prev return NULL past the ends of the list.
+ */
+#define LIST_DEFINE(name, type, member) \
+static inline void name##_add(struct list_head *head, type *elem) { \
+	list_add(head, &elem->member); \
+} \
+static inline void name##_add_tail(struct list_head *head, type *elem) { \
+	list_add_tail(head, &elem->member); \
+} \
+static inline void name##_del(type *elem) { \
+	list_del(&elem->member); \
+} \
+static inline type *name##_first(struct list_head *head) { \
+	return list_empty(head) ? NULL : container_of(head->next, type, member); \
+} \
+static inline type *name##_last(struct list_head *head) { \
+	return list_empty(head) ? NULL : container_of(head->prev, type, member); \
+} \
+static inline type *name##_next(struct list_head *head, type *elem) { \
+	return elem->member.next == head ? NULL : container_of(elem->member.next, type, member); \
+} \
+static inline type *name##_prev(struct list_head *head, type *elem) { \
+	return elem->member.prev == head ? NULL : container_of(elem->member.prev, type, member); \
+}
+
+#endif
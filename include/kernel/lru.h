@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* include/kernel/lru.h
+ *
+ * Page aging with active/inactive lists and working set estimation
+ * header file
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#ifndef LRU_H
+#define LRU_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <kernel/paging.h>
+
+struct vmm_space;
+
+/*
+ * One descriptor per page frame, demand paged like the reference counts.
+ * @prev and @next are page frame numbers plus one, 0 ending the list.
+ * @space is NULL when the frame is on no list.
+ */
+#define LRU_PAGES			((struct lru_page *)0xF0400000)
+
+#define LRU_INACTIVE		0
+#define LRU_ACTIVE			1
+
+/* Aging runs every LRU_PERIOD ticks on LRU_SCAN pages of each list */
+#define LRU_PERIOD			10
+#define LRU_SCAN			32
+
+struct lru_page {
+	uint32_t prev;
+	uint32_t next;
+	uintptr_t va;
+	struct vmm_space *space;
+};
+
+struct lru_list {
+	uint32_t head;
+	uint32_t tail;
+	uint32_t count;
+};
+
+/*
+ * Per address space state: the lists, the working set size (pages
+ * referenced during the last complete sweep of both lists), and the
+ * position of the walk adopting pages mapped outside of the fault path.
+ */
+struct vmm_lru {
+	struct lru_list lists[2];
+	uint32_t wss;
+	uint32_t sweep_seen;
+	uint32_t sweep_accessed;
+	uintptr_t hand;
+};
+
+/*
+ * Reserves the descriptors and starts aging, must be called after vmm_init
+ * and timer_init.
+ */
+void lru_init();
+
+/*
+ * Puts the frame @phys, just mapped at @va in @space, at the head of its
+ * active list.
+ */
+void lru_add(struct vmm_space *space, uintptr_t va, void *phys);
+
+/*
+ * Empties the lists of @space, before it is destroyed.
+ */
+void lru_drain(struct vmm_space *space);
+
+/*
+ * Ages the pages of the current address space: @n pages are taken from
+ * the tail of each list, referenced ones move to the active head, others
+ * to the inactive head.
+ */
+void lru_scan(size_t n);
+
+/*
+ * Adopts @n pages of the current address space that were mapped without
+ * going through the fault path.
+ */
+void lru_refill(size_t n);
+
+/*
+ * Takes the coldest evictable page of the current address space off its
+ * lists and returns its page table entry, its address being stored in @va.
+ * Returns NULL if there is no such page.
+ */
+struct page_table_entry *lru_victim(uintptr_t *va);
+
+#endif
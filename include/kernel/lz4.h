@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* include/kernel/lz4.h
+ *
+ * LZ4 block format compression header file
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#ifndef LZ4_H
+#define LZ4_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Match positions are stored on 16 bits, so are input sizes */
+#define LZ4_MAX_INPUT	65535
+#define LZ4_HASHLOG		12
+
+/*
+ * Worst case compressed size of @n bytes
+ */
+#define LZ4_BOUND(n)	((n) + (n) / 255 + 16)
+
+/*
+ * Compression state, kept out of the stack because of its size.
+ */
+struct lz4_state {
+	uint16_t table[1 << LZ4_HASHLOG];
+};
+
+/*
+ * Compresses the @len bytes at @src into @dst, a buffer of @cap bytes,
+ * using @state as scratch memory.
+ * Returns the compressed size, or 0 if it does not fit in @cap bytes or
+ * @len is larger than LZ4_MAX_INPUT.
+ */
+size_t lz4_compress(struct lz4_state *state, const void *src, size_t len, void *dst, size_t cap);
+
+/*
+ * Decompresses the @len bytes of the LZ4 block @src into @dst, a buffer
+ * of @cap bytes. Malformed input never reads or writes out of bounds.
+ * Returns the decompressed size, or -1 if the block is malformed or does
+ * not fit in @cap bytes.
+ */
+int lz4_decompress(const void *src, size_t len, void *dst, size_t cap);
+
+#endif
@@ -6,12 +6,14 @@
  * Nulix shell header file
  *
  * created: 2022/12/08 - xlmod <glafond-@student.42.fr>
- * updated: 2022/12/14 - glafond- <glafond-@student.42.fr>
+ * updated: 2026/10/19 - agent <agent@local>
  */
 
 #ifndef NSH_H
 #define NSH_H
 
+#include <kernel/arena.h>
+
 #define NSH_BUFSIZE 1024
 
 struct builtin {
@@ -20,6 +22,12 @@ struct builtin {
 	char *description;
 };
 
+/*
+ * Scratch memory of the running builtin, everything allocated from it is
+ * released when the builtin returns
+ */
+extern struct arena nsh_arena;
+
 void nsh();
 
 #endif
@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* include/kernel/numa.h
+ *
+ * Memory topology from the ACPI static resource affinity table header file
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#ifndef NUMA_H
+#define NUMA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define NUMA_MAX_NODES		4
+#define NUMA_MAX_RANGES		16
+
+/* Relative access costs, as in the system locality information table */
+#define NUMA_LOCAL_DISTANCE		10
+#define NUMA_REMOTE_DISTANCE	20
+
+/*
+ * A range of physical memory attached to the node @node, in page frame
+ * numbers, @end excluded. Ranges do not overlap, frames that no range
+ * covers are not used.
+ */
+struct numa_range {
+	uint32_t start;
+	uint32_t end;
+	int node;
+};
+
+extern struct numa_range numa_ranges[NUMA_MAX_RANGES];
+extern int numa_nranges;
+extern int numa_nnodes;
+extern uint8_t numa_distance[NUMA_MAX_NODES][NUMA_MAX_NODES];
+extern int numa_cpu_node;
+
+/*
+ * Reads the memory ranges of each node and the node of the current cpu
+ * from the firmware. Without them, all of the @nframes first frames are
+ * given to a single node.
+ * Called by kpm_init, before any allocation.
+ */
+void numa_init(size_t nframes);
+
+/*
+ * Returns the node of the current cpu
+ */
+static inline int numa_node_id() {
+	return numa_cpu_node;
+}
+
+/*
+ * Returns the node of the page frame @pfn, or -1 if it is not in memory
+ */
+int numa_node_of(uint32_t pfn);
+
+#endif
@@ -6,7 +6,7 @@
  * Header for pagination related things
  *
  * created: 2022/12/12 - xlmod <glafond-@student.42.fr>
- * updated: 2022/12/16 - glafond- <glafond-@student.42.fr>
+ * updated: 2026/10/19 - agent <agent@local>
  */
 
 #ifndef PAGING_H
@@ -21,6 +21,10 @@
 
 #define LAST_PAGE_ENTRY			(PAGE_DIRECTORY_LENGTH - 1)
 
+#define PAGE_PRESENT			(1 << 0)
+#define PAGE_WRITABLE			(1 << 1)
+#define PAGE_USER				(1 << 2)
+
 struct page_entry {
 	uint32_t present: 1;
 	uint32_t writable: 1;
@@ -61,9 +65,9 @@ struct page_table_entry {
 	uint32_t dirty: 1;
 	uint32_t page_attribute_table: 1;
 	uint32_t global: 1;
-	uint32_t avl_3: 1;
-	uint32_t avl_4: 1;
-	uint32_t avl_5: 1;
+	uint32_t cow: 1;		// avl_3: copy-on-write page
+	uint32_t swap: 1;		// avl_4: swapped out, zram handle in address
+	uint32_t ksm: 1;		// avl_5: maps a frame merged by ksm
 	uint32_t address: 20;
 };
 
@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* include/kernel/pgtable.h
+ *
+ * Cache of zeroed paging structure frames header file
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#ifndef PGTABLE_H
+#define PGTABLE_H
+
+#include <stdint.h>
+
+#include <kernel/kpm.h>
+
+/*
+ * Page tables and directories are taken from a quicklist of zeroed frames.
+ * Page tables are empty when they are released, so they go back to the
+ * quicklist as is. The quicklist is topped up to PGTABLE_LOW frames when
+ * the kernel is idle, and frames over PGTABLE_MAX go back to kpm.
+ */
+#define PGTABLE_MAX		32
+#define PGTABLE_LOW		8
+#define PGTABLE_PERIOD	10
+
+struct pgtable_stats {
+	uint32_t hits;
+	uint32_t misses;
+	uint32_t recycled;	// frames released into the quicklist
+	uint32_t released;	// frames released to kpm, the quicklist being full
+	uint32_t refilled;	// frames zeroed ahead of time
+};
+
+extern struct pgtable_stats pgtable_stats;
+
+/*
+ * Starts the idle time refill, must be called after kmap_init and
+ * timer_init.
+ */
+void pgtable_init();
+
+/*
+ * Allocates a frame for a page table or directory.
+ * Returns 1 if the frame is already zeroed, 0 if the caller has to zero
+ * it, -1 on error.
+ */
+int pgtable_alloc(kpm_chunk_t *chunk);
+
+/*
+ * Releases the paging structure frame @phys, whose entries must all be
+ * zero.
+ */
+void pgtable_free(void *phys);
+
+/*
+ * Gives every cached frame back to kpm.
+ * Returns the number of frames released
+ */
+int pgtable_shrink();
+
+/*
+ * Returns the number of cached frames.
+ */
+int pgtable_cached();
+
+#endif
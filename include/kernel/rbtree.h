@@ -0,0 +1,139 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* include/kernel/rbtree.h
+ *
+ * Intrusive red-black trees
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#ifndef RBTREE_H
+#define RBTREE_H
+
+#include <kernel/kernel.h>
+
+#define RB_RED		0
+#define RB_BLACK	1
+
+/*
+ * Node embedded in the elements of a tree
+ */
+struct rb_node {
+	struct rb_node *parent;
+	struct rb_node *left;
+	struct rb_node *right;
+	int color;
+};
+
+struct rb_root {
+	struct rb_node *node;
+};
+
+#define RB_ROOT_INIT	{ NULL }
+
+/*
+ * Augmentation hook: recomputes the data @node keeps about its subtree,
+ * such as the largest end of an interval tree, from its own and its
+ * children's. The tree calls it bottom up on every node whose subtree
+ * changes.
+ */
+typedef void (*rb_update_t)(struct rb_node *node);
+
+/*
+ * Links @node as the child of @parent at @link, the null child pointer
+ * the search for its place stopped on, or the root if @parent is NULL.
+ * rb_insert must then rebalance the tree.
+ */
+static inline void rb_link(struct rb_node *node, struct rb_node *parent, struct rb_node **link) {
+	node->parent = parent;
+	node->left = NULL;
+	node->right = NULL;
+	node->color = RB_RED;
+	*link = node;
+}
+
+/*
+ * Rebalances @root after @node was linked with rb_link. @update may be
+ * NULL if the tree is not augmented.
+ */
+void rb_insert(struct rb_root *root, struct rb_node *node, rb_update_t update);
+
+/*
+ * Removes @node from @root. @update may be NULL if the tree is not
+ * augmented.
+ */
+void rb_erase(struct rb_root *root, struct rb_node *node, rb_update_t update);
+
+/*
+ * In order traversal, returning NULL past the ends of the tree
+ */
+struct rb_node *rb_first(const struct rb_root *root);
+struct rb_node *rb_last(const struct rb_root *root);
+struct rb_node *rb_next(const struct rb_node *node);
+struct rb_node *rb_prev(const struct rb_node *node);
+
+/*
+ * Defines the functions name_insert, name_find, name_erase, name_first,
+ * name_next over trees of @type elements linked by their struct rb_node
+ * @member and ordered by @cmp, a function comparing two const @type
+ * pointers like strcmp. name_find is given an element holding the key
+ * searched for.
+ * name_insert returns NULL, or the element already in the tree that
+ * compares equal to @elem, which is then not inserted.
+ */
+#define RB_DEFINE(name, type, member, cmp) \
+	__RB_DEFINE(name, type, member, cmp, NULL)
+
+/*
+ * Same as RB_DEFINE for an augmented tree, @update being a function
+ * recomputing the data of the @type element it is given.
+ */
+#define RB_DEFINE_AUGMENTED(name, type, member, cmp, update) \
+static void name##_update(struct rb_node *node) { \
+	update(container_of(node, type, member)); \
+} \
+__RB_DEFINE(name, type, member, cmp, name##_update)
+
+#define __RB_DEFINE(name, type, member, cmp, update) \
+static inline type *name##_entry(const struct rb_node *node) { \
+	return node ? container_of(node, type, member) : NULL; \
+} \
+static inline type *name##_insert(struct rb_root *root, type *elem) { \
+	struct rb_node **link = &root->node; \
+	struct rb_node *parent = NULL; \
+	int c; \
+	while (*link) { \
+		parent = *link; \
+		c = cmp(elem, name##_entry(parent)); \
+		if (c == 0) \
+			return name##_entry(parent); \
+		link = c < 0 ? &parent->left : &parent->right; \
+	} \
+	rb_link(&elem->member, parent, link); \
+	rb_insert(root, &elem->member, update); \
+	return NULL; \
+} \
+static inline type *name##_find(const struct rb_root *root, const type *key) { \
+	struct rb_node *node = root->node; \
+	int c; \
+	while (node) { \
+		c = cmp(key, name##_entry(node)); \
+		if (c == 0) \
+			return name##_entry(node); \
+		node = c < 0 ? node->left : node->right; \
+	} \
+	return NULL; \
+} \
+static inline void name##_erase(struct rb_root *root, type *elem) { \
+	rb_erase(root, &elem->member, update); \
+} \
+static inline type *name##_first(const struct rb_root *root) { \
+	return name##_entry(rb_first(root)); \
+} \
+static inline type *name##_next(const type *elem) { \
+	return name##_entry(rb_next(&elem->member)); \
+}
+
+#endif
@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* include/kernel/resource.h
+ *
+ * Physical address space resource tree header file
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#ifndef RESOURCE_H
+#define RESOURCE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <kernel/multiboot.h>
+
+/*
+ * What a range of the physical address space is. Addresses no resource
+ * covers are unknown and must be treated as device memory.
+ */
+#define RESOURCE_RAM		(1 << 0)	// usable memory
+#define RESOURCE_RESERVED	(1 << 1)	// memory the firmware keeps (ACPI, BIOS...)
+#define RESOURCE_DEVICE		(1 << 2)	// memory mapped device
+#define RESOURCE_BUSY		(1 << 3)	// used by the kernel, never given to kpm
+
+/* Resources created by resource_init */
+#define RESOURCE_MAX		64
+
+/* Spans of the lookup index, each resource adds at most two of them */
+#define RESOURCE_MAX_SPANS	(4 * RESOURCE_MAX)
+
+/*
+ * A range of physical addresses, @end included. Resources form a tree:
+ * @child is the first of the resources nested in this one, sorted and
+ * linked through @sibling. Siblings never overlap.
+ */
+struct resource {
+	uint32_t start;
+	uint32_t end;
+	const char *name;
+	uint32_t flags;
+	struct resource *parent;
+	struct resource *sibling;
+	struct resource *child;
+};
+
+/* Root of the tree, spanning the whole physical address space */
+extern struct resource iomem_resource;
+
+/*
+ * Builds the tree from the @n entries of the multiboot memory map
+ * @entries, the kernel image and the legacy VGA memory.
+ * Must be called before kpm_init.
+ */
+void resource_init(struct multiboot_mmap_entry *entries, size_t n);
+
+/*
+ * Inserts @res at its place in the tree, the resources it covers becoming
+ * its children. @res must stay valid as long as the tree exists.
+ * Returns 0 on success, -1 if @res partially overlaps another resource or
+ * the index is full
+ */
+int resource_insert(struct resource *res);
+
+/*
+ * Returns the innermost resource containing the physical address @addr,
+ * or NULL if it is unknown
+ */
+struct resource *resource_find(uint32_t addr);
+
+/*
+ * Returns 1 if every address of the @size bytes at @start belongs to a
+ * resource having one of the @flags (innermost resource only), 0 otherwise
+ */
+int resource_check(uint32_t start, size_t size, uint32_t flags);
+
+#endif
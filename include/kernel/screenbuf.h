@@ -3,19 +3,24 @@
  * Insert file description here
  *
  * created: 2022/10/19 - xlmod <glafond-@student.42.fr>
- * updated: 2022/10/19 - xlmod <glafond-@student.42.fr>
+ * updated: 2026/10/19 - agent <agent@local>
  */
 
 #ifndef SCREENBUF_H
 #define SCREENBUF_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #define VGA_WIDTH	80
 #define VGA_HEIGHT	25
 #define VGA_PTR		(uint16_t *)0xB8000
+/* The text memory holds 8 screens, of which the CRTC shows one */
+#define VGA_MEM_SIZE	0x8000
+#define VGA_MEM_LINES	(VGA_MEM_SIZE / 2 / VGA_WIDTH)
 
-#define SB_HEIGHT		VGA_HEIGHT * 8
+/* Lines always backed, the first screen and the line after it */
+#define SB_MIN_LINES	(VGA_HEIGHT + 1)
 
 enum sb_color {
 	SB_COLOR_BLACK = 0,
@@ -44,8 +49,19 @@ enum sb_color {
 #define SB_CURSOR_PORT1	0x3D4
 #define SB_CURSOR_PORT2	0x3D5
 
+/* CRTC registers of the address of the first character shown */
+#define SB_CRTC_START_HIGH	0x0c
+#define SB_CRTC_START_LOW	0x0d
+
 #define TABSIZE 4
 
+/* Rate of the flushes of the deferred mode */
+#define SB_FLUSH_HZ		50
+
+/*
+ * A ring of @nlines lines at @buf, the first @mapped bytes of which are
+ * backed by page frames. @endbuf ends the lines in use of the ring.
+ */
 struct screenbuf {
 	uint16_t		*top;
 	uint16_t		*viewport;
@@ -54,10 +70,51 @@ struct screenbuf {
 	unsigned short	cursor_offset;
 	uint8_t			color;
 	int				loaded;
-	uint16_t		buf[VGA_WIDTH * SB_HEIGHT];
+	uint16_t		*buf;
+	size_t			nlines;
+	size_t			mapped;
 };
 
-void sb_init(struct screenbuf *sb);
+/*
+ * 1 when scrolling moves the start address of the CRTC in the VGA text
+ * memory, writing only the lines coming into view. 0 when it copies all
+ * the visible lines to the start of the text memory, it may be set to
+ * compare both.
+ */
+extern int sb_hwscroll;
+
+/*
+ * 1 when writes to the loaded screenbuf only update it and mark its lines
+ * dirty, the timer interrupt copying them to VGA memory SB_FLUSH_HZ times
+ * per second. 0, the default, when they go to VGA memory right away.
+ */
+extern int sb_deferred;
+
+/*
+ * Sets sb_deferred to @on, flushing the pending lines when it is cleared.
+ * Toggled from the shell with vt defer [on|off].
+ */
+void sb_set_deferred(int on);
+
+/*
+ * Flushes the changes of the loaded screenbuf to VGA memory, and moves the
+ * hardware cursor, every TIMER_HZ / SB_FLUSH_HZ ticks. Called by the timer
+ * interrupt handler.
+ */
+void sb_flush_tick();
+
+/*
+ * Inits @sb with a ring of @nlines lines, more than SB_MIN_LINES, at the
+ * unmapped kernel virtual address @buf. Lines are backed as they are used.
+ * Returns 0 on success, -1 on error
+ */
+int sb_init(struct screenbuf *sb, uint16_t *buf, size_t nlines);
+
+/*
+ * Gives the frames of the unloaded @sb back to kpm
+ */
+void sb_destroy(struct screenbuf *sb);
+
 void sb_load(struct screenbuf *sb);
 void sb_unload(struct screenbuf *sb);
 
@@ -65,6 +122,7 @@ void sb_scroll(struct screenbuf *sb, int n);
 void sb_scroll_top(struct screenbuf *sb);
 void sb_scroll_down(struct screenbuf *sb);
 
+void sb_write(struct screenbuf *sb, const char *buf, size_t len);
 void sb_putchar(struct screenbuf *sb, char c);
 void sb_putstr(struct screenbuf *sb, char *s);
 void sb_clear(struct screenbuf *sb);
@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* include/kernel/slab.h
+ *
+ * Slab allocator and kmalloc header file
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#ifndef SLAB_H
+#define SLAB_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Slabs are 2^order pages of a kernel virtual area, mapped page by page
+ * on frames from kpm, and aligned on their size. A slab starts with its
+ * descriptor and the index of the next free object for each object, the
+ * objects follow.
+ */
+#define SLAB_AREA			0xE1000000
+#define SLAB_AREA_SIZE		(16 * 1024 * 1024)
+
+#define SLAB_MAX_ORDER		3
+#define SLAB_MAX_CACHES		32
+
+/* Empty slabs kept by each cache, the others are given back to kpm */
+#define SLAB_KEEP_EMPTY		1
+
+/* Align objects on cache lines, or on the fraction of a line they fit in */
+#define SLAB_HWCACHE_ALIGN	(1 << 0)
+
+/* kmalloc size classes, bigger allocations go to vmalloc */
+#define KMALLOC_MIN_SHIFT	3
+#define KMALLOC_MAX_SHIFT	11
+#define KMALLOC_MAX_SIZE	(1 << KMALLOC_MAX_SHIFT)
+
+#define SLAB_NONE			0xFFFF
+
+struct kmem_cache;
+
+struct slab {
+	struct slab *prev;
+	struct slab *next;
+	struct kmem_cache *cache;
+	void *objects;
+	uint16_t free;
+	uint16_t inuse;
+};
+
+/*
+ * A cache of objects of @size bytes. Slabs are on the @partial, @full or
+ * @empty list depending on their number of objects in use. Objects are
+ * constructed by @ctor when their slab is created, and must be freed in
+ * their constructed state.
+ */
+struct kmem_cache {
+	const char *name;
+	size_t size;
+	size_t align;
+	void (*ctor)(void *);
+	uint32_t order;
+	uint32_t objs_per_slab;
+	struct slab *partial;
+	struct slab *full;
+	struct slab *empty;
+	uint32_t nslabs;
+	uint32_t nempty;
+	uint32_t active;		// objects in use
+	uint32_t allocs;
+	uint32_t hits;			// allocations served without growing
+	uint32_t frees;
+};
+
+extern struct kmem_cache slab_caches[SLAB_MAX_CACHES];
+extern int slab_ncaches;
+
+/*
+ * Reserves the slab area and creates the kmalloc caches, must be called
+ * after vmm_init.
+ */
+void slab_init();
+
+/*
+ * Creates a cache of objects of @size bytes aligned on @align (a power of
+ * two, or 0), @flags being a combination of SLAB_* flags. @ctor may be
+ * NULL.
+ * Returns the cache, or NULL if there are too many caches or objects are
+ * too big
+ */
+struct kmem_cache *kmem_cache_create(const char *name, size_t size, size_t align, int flags,
+	void (*ctor)(void *));
+
+/*
+ * Returns an object of @cache, or NULL when out of memory
+ */
+void *kmem_cache_alloc(struct kmem_cache *cache);
+
+/*
+ * Gives the object @obj back to @cache.
+ */
+void kmem_cache_free(struct kmem_cache *cache, void *obj);
+
+/*
+ * Gives the empty slabs of every cache back to kpm.
+ * Returns the number of page frames released
+ */
+size_t slab_shrink();
+
+/*
+ * Allocates @size bytes from the smallest kmalloc class they fit in.
+ * Returns NULL on error
+ */
+void *kmalloc(size_t size);
+
+/*
+ * Releases a kmalloc allocation.
+ */
+void kfree(void *ptr);
+
+#endif
@@ -6,13 +6,14 @@
  * Standard library.
  *
  * created: 2022/12/08 - xlmod <glafond-@student.42.fr>
- * updated: 2022/12/09 - xlmod <glafond-@student.42.fr>
+ * updated: 2026/10/19 - agent <agent@local>
  */
 
 #ifndef STDLIB_H
 #define STDLIB_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 int abs(int x);
 long labs(long x);
@@ -21,6 +22,23 @@ long long llabs(long long x);
 int atoi(const char *nptr);
 
 void *bsearch(const void *key, const void *base, size_t nitems, size_t size, int (*compar)(const void *, const void *));
+void qsort(void *base, size_t nitems, size_t size, int (*compar)(const void *, const void *));
+
+#define RADIX_PASSES	4
+#define RADIX_BUCKETS	256
+
+/*
+ * Radix sort counts, kept out of the stack because of their size.
+ */
+struct radix_state {
+	size_t count[RADIX_PASSES][RADIX_BUCKETS];
+};
+
+/*
+ * Sorts the @n keys at @keys in increasing order, using @state and @tmp,
+ * an array of @n keys, as scratch memory.
+ */
+void radix_sort(struct radix_state *state, uint32_t *keys, uint32_t *tmp, size_t n);
 
 long int strtol(const char *nptr, char **endptr, int base);
 long long int strtoll(const char *nptr, char **endptr, int base);
@@ -6,7 +6,7 @@
  * Header file for the string library
  *
  * created: 2022/10/12 - lfalkau <lfalkau@student.42.fr>
- * updated: 2022/10/19 - lfalkau <lfalkau@student.42.fr>
+ * updated: 2026/10/19 - agent <agent@local>
  */
 
 #ifndef STRING_H
@@ -44,4 +44,11 @@ void	*memcpy(void *dst, const void *src, size_t n);
 void	*memmove(void *dst, const void *src, size_t n);
 void	*memset(void *s, int c, size_t n);
 
+/*
+	1 when memcpy, memmove and memset use rep movsb/stosb alone, 0 when
+	they use rep movsd/stosd, -1 until the first call reads cpuid. It may be
+	set to 0 to force the dword path.
+*/
+extern int mem_erms;
+
 #endif
@@ -0,0 +1,60 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* include/kernel/timer.h
+ *
+ * Programmable interval timer and periodic kernel work header file
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <stdint.h>
+
+#define PIT_FREQUENCY	1193182
+#define PIT_CHANNEL0	0x40
+#define PIT_COMMAND		0x43
+/* Channel 0, low then high byte, square wave generator */
+#define PIT_MODE3		0x36
+
+#define TIMER_HZ		100
+#define TIMER_NWORKS	8
+
+/*
+ * A function called every @period ticks.
+ * Works are not run from the interrupt handler but from timer_run, so
+ * they may use any kernel service without racing with the interrupted code.
+ */
+struct timer_work {
+	void (*fn)();
+	uint32_t period;
+	uint32_t next;
+};
+
+extern volatile uint32_t timer_ticks;
+
+/*
+ * Programs the PIT to interrupt TIMER_HZ times per second.
+ */
+void timer_init();
+
+/*
+ * Accounts one tick, called by the timer interrupt handler.
+ */
+void timer_tick();
+
+/*
+ * Registers @fn to be called every @period ticks.
+ * Returns 0 on success, -1 if there is no room left
+ */
+int timer_register(void (*fn)(), uint32_t period);
+
+/*
+ * Runs the works that are due, called whenever the kernel is idle.
+ */
+void timer_run();
+
+#endif
@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* include/kernel/tlb.h
+ *
+ * Batched TLB invalidation header file
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#ifndef TLB_H
+#define TLB_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TLB_NRANGES		8
+#define TLB_NTABLES		32
+#define TLB_NPAGES		64
+
+/*
+ * Default number of pages above which a full flush (cr3 reload) is
+ * preferred over one invlpg per page.
+ */
+#define TLB_DFL_FLUSH_CEILING	33
+
+struct tlb_range {
+	uintptr_t start;
+	uintptr_t end;
+};
+
+/*
+ * Gathers everything an unmap operation leaves behind, so that the TLB is
+ * flushed once, and page table frames are released once, at the end.
+ *
+ * @ranges are the virtual ranges that were unmapped, merged when contiguous.
+ * @npages is the total number of pages in @ranges.
+ * @flush_all is set when the ranges overflowed and a full flush is required.
+ * @tables are the physical addresses of page tables to give back to kpm.
+ * @pages are the physical addresses of unmapped page frames to give back.
+ */
+struct tlb_gather {
+	struct tlb_range ranges[TLB_NRANGES];
+	size_t nranges;
+	size_t npages;
+	int flush_all;
+	void *tables[TLB_NTABLES];
+	size_t ntables;
+	void *pages[TLB_NPAGES];
+	size_t npages_freed;
+};
+
+struct tlb_stats {
+	uint32_t invlpg;
+	uint32_t full;
+	uint32_t tables;
+	uint32_t pages;
+};
+
+extern size_t tlb_flush_ceiling;
+extern struct tlb_stats tlb_stats;
+
+static inline void tlb_invlpg(void *virt) {
+	__asm__ volatile ("invlpg (%0)" :: "r" (virt) : "memory");
+}
+
+static inline void tlb_flush_all() {
+	uint32_t cr3;
+
+	__asm__ volatile ("movl %%cr3, %0" : "=r" (cr3));
+	__asm__ volatile ("movl %0, %%cr3" :: "r" (cr3) : "memory");
+}
+
+void tlb_gather_init(struct tlb_gather *tlb);
+void tlb_gather_range(struct tlb_gather *tlb, void *virt, size_t size);
+void tlb_gather_table(struct tlb_gather *tlb, void *phys);
+void tlb_gather_page(struct tlb_gather *tlb, void *phys);
+void tlb_flush(struct tlb_gather *tlb);
+void tlb_finish(struct tlb_gather *tlb);
+
+#endif
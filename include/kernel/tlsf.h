@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* include/kernel/tlsf.h
+ *
+ * Two-level segregated fit allocator header file
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#ifndef TLSF_H
+#define TLSF_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Free blocks are sorted in lists by size: the first level splits sizes
+ * in powers of two, the second level splits each power of two in
+ * TLSF_SL_COUNT ranges. Sizes below TLSF_SMALL_SIZE all go to the first
+ * level 0, in ranges of TLSF_ALIGN bytes, the size of a block header word.
+ */
+#if __SIZEOF_SIZE_T__ == 8
+#define TLSF_ALIGN_LOG2		3
+#else
+#define TLSF_ALIGN_LOG2		2
+#endif
+#define TLSF_ALIGN			(1 << TLSF_ALIGN_LOG2)
+#define TLSF_SL_LOG2		4
+#define TLSF_SL_COUNT		(1 << TLSF_SL_LOG2)
+#define TLSF_FL_SHIFT		(TLSF_SL_LOG2 + TLSF_ALIGN_LOG2)
+#define TLSF_FL_MAX			26
+#define TLSF_FL_COUNT		(TLSF_FL_MAX - TLSF_FL_SHIFT + 1)
+#define TLSF_SMALL_SIZE		(1 << TLSF_FL_SHIFT)
+
+/* Bigger requests could be rounded up past the last first level */
+#define TLSF_MAX_SIZE		(1 << (TLSF_FL_MAX - 1))
+
+/*
+ * Header of a block of a pool. Only @size, the size of the block after
+ * it, is kept while the block is used: @prev_phys is stored at the end of
+ * the previous block and only valid while that one is free, @next_free
+ * and @prev_free are part of the block itself and link the free blocks of
+ * a list.
+ */
+struct tlsf_block {
+	struct tlsf_block *prev_phys;
+	size_t size;
+	struct tlsf_block *next_free;
+	struct tlsf_block *prev_free;
+};
+
+/*
+ * An allocator over a single pool. Bit fl of @fl_bitmap is set when a list
+ * of the first level fl is not empty, bit sl of @sl_bitmap[fl] when
+ * @blocks[fl][sl] is not.
+ */
+struct tlsf {
+	uint32_t fl_bitmap;
+	uint32_t sl_bitmap[TLSF_FL_COUNT];
+	struct tlsf_block *blocks[TLSF_FL_COUNT][TLSF_SL_COUNT];
+	size_t size;			// bytes of the pool usable by blocks
+	size_t used;			// bytes of used blocks, headers included
+	size_t max_used;
+	uint32_t allocs;
+	uint32_t frees;
+	uint32_t failures;
+};
+
+/*
+ * Makes @t an allocator of the @size bytes at @mem, which must be aligned
+ * on TLSF_ALIGN.
+ * Returns 0 on success, -1 if the pool is too small or too big
+ */
+int tlsf_create(struct tlsf *t, void *mem, size_t size);
+
+/*
+ * Allocates @size bytes aligned on TLSF_ALIGN, in constant time.
+ * Returns NULL if no free block is big enough
+ */
+void *tlsf_malloc(struct tlsf *t, size_t size);
+
+/*
+ * Releases a tlsf_malloc allocation, merging it with its free neighbours,
+ * in constant time.
+ */
+void tlsf_free(struct tlsf *t, void *ptr);
+
+/*
+ * Returns the size of the largest free block
+ */
+size_t tlsf_largest(struct tlsf *t);
+
+/*
+ * Kernel real-time heap: a TLSF allocator over up to RTHEAP_SIZE bytes of
+ * page frames mapped once at boot, so that allocations never fault nor
+ * wait for kpm, and can be made with interrupts disabled.
+ */
+#define RTHEAP_SIZE			(1024 * 1024)
+
+extern struct tlsf rtheap;
+
+/*
+ * Creates the real-time heap, must be called after vmalloc_init.
+ */
+void rtheap_init();
+
+/*
+ * Allocates @size bytes from the real-time heap.
+ * Returns NULL on error
+ */
+void *rt_malloc(size_t size);
+
+/*
+ * Releases a rt_malloc allocation.
+ */
+void rt_free(void *ptr);
+
+#endif
@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* include/kernel/vmalloc.h
+ *
+ * Virtually contiguous kernel allocations header file
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#ifndef VMALLOC_H
+#define VMALLOC_H
+
+#include <stddef.h>
+
+#include <kernel/kpm.h>
+
+#define VMALLOC_START	0xD0000000
+#define VMALLOC_END		0xE0000000
+
+#define VMALLOC_NAREAS	128
+
+/*
+ * A used range of the vmalloc area.
+ *
+ * @addr is the first mapped address.
+ * @size is the mapped size, a guard page is left unmapped after it.
+ * @owned is set when the frames were allocated by vmalloc itself.
+ */
+struct vmalloc_area {
+	uintptr_t addr;
+	size_t size;
+	int owned;
+	struct vmalloc_area *next;
+};
+
+void vmalloc_init();
+
+/*
+ * Maps the @n page frame chunks of @chunks back to back, and returns the
+ * virtual address of the first one, or NULL on error.
+ * The frames still belong to the caller.
+ */
+void *vmap(kpm_chunk_t *chunks, size_t n);
+
+/*
+ * Removes a mapping created by vmap.
+ */
+void vunmap(void *addr);
+
+/*
+ * Allocates @size bytes of virtually contiguous memory, backed by page
+ * frames that do not need to be physically contiguous.
+ * Returns NULL on error.
+ */
+void *vmalloc(size_t size);
+
+/*
+ * Releases a vmalloc allocation, both its mapping and its page frames.
+ */
+void vfree(void *addr);
+
+/*
+ * Returns the list of used areas, sorted by address.
+ */
+struct vmalloc_area *vmalloc_areas();
+
+#endif
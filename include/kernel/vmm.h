@@ -0,0 +1,242 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* include/kernel/vmm.h
+ *
+ * Virtual memory manager header file
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#ifndef VMM_H
+#define VMM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <kernel/kernel.h>
+#include <kernel/paging.h>
+#include <kernel/lru.h>
+
+struct tlb_gather;
+
+/*
+ * The last page directory entry points to the page directory itself
+ * (see boot_init), so the active page directory and all of its page tables
+ * are always reachable at the top of the virtual address space.
+ */
+#define VMM_PAGE_DIRECTORY	((struct page_directory_entry *)0xFFFFF000)
+#define VMM_PAGE_TABLES		((struct page_table_entry *)0xFFC00000)
+
+#define PDE_INDEX(va)		(((uintptr_t)(va)) >> 22)
+#define PTE_INDEX(va)		((((uintptr_t)(va)) >> 12) & (PAGE_TABLE_LENGTH - 1))
+
+/* Address of the page table covering @va, through the recursive mapping */
+#define VMM_PAGE_TABLE(va)	(VMM_PAGE_TABLES + PDE_INDEX(va) * PAGE_TABLE_LENGTH)
+
+/*
+ * The kernel page directory, reachable through the boot mapping.
+ * It holds the reference copy of the kernel half page directory entries.
+ */
+#define VMM_KERNEL_PGDIR	((struct page_directory_entry *)(KERNEL_VIRT_OFFSET + kernel_space.pgdir))
+
+/*
+ * The first 4MB are identity mapped at boot and hold the IDT, the GDT and
+ * the boot paging structures, so the lower half really starts after them.
+ */
+#define VMM_USER_BASE		0x00400000
+#define VMM_USER_END		KERNEL_VIRT_OFFSET
+
+/*
+ * Kernel half layout:
+ *
+ * 0xC0000000 - 0xC0400000	kernel image and low memory, mapped at boot
+ * 0xD0000000 - 0xE0000000	vmalloc area
+ * 0xE0000000 - 0xE0800000	zram pool (see zram.h)
+ * 0xE1000000 - 0xE2000000	slabs (see slab.h)
+ * 0xE2000000 - 0xE3000000	virtual terminals scrollback (see vt.h)
+ * 0xF0000000 - 0xF0200000	page frames reference counts, demand paged
+ * 0xF0400000 - 0xF1400000	page frames LRU descriptors, demand paged (see lru.h)
+ * 0xFF000000 - 0xFF800000	ACPI tables, before kpm_init only (see acpi.h)
+ * 0xFF800000 - 0xFFC00000	fixmap, temporary mappings (see kmap.h)
+ * 0xFFC00000 - 0xFFFFFFFF	page tables (recursive mapping)
+ */
+#define VMM_PAGE_REFS		((void *)0xF0000000)
+
+#define VMM_WRITE			(1 << 0)
+#define VMM_USER			(1 << 1)
+#define VMM_PHYS			(1 << 2)
+
+#define VMM_NREGIONS		128
+
+/* Victims tried by vmm_swap_out before giving up */
+#define VMM_SWAP_TRIES		8
+
+/* Page fault error code bits */
+#define PF_PRESENT			(1 << 0)
+#define PF_WRITE			(1 << 1)
+#define PF_USER				(1 << 2)
+
+/*
+ * Fault latencies are bucketed by powers of two cycles, the first bucket
+ * holding everything under 2^VMM_FAULT_MINSHIFT cycles.
+ */
+#define VMM_FAULT_NBUCKETS	16
+#define VMM_FAULT_MINSHIFT	10
+
+/*
+ * A virtual memory region that is backed lazily, on first touch.
+ *
+ * @start, @end delimit the region, both page aligned.
+ * @flags are VMM_* flags. Without VMM_PHYS, pages are zero-filled frames
+ * allocated from kpm, with VMM_PHYS they map @phys + (addr - @start).
+ */
+struct vmm_region {
+	uintptr_t start;
+	uintptr_t end;
+	uintptr_t phys;
+	int flags;
+	struct vmm_region *next;
+};
+
+/*
+ * An address space: a page directory and its sorted list of regions.
+ *
+ * @pgdir is the physical address of the page directory.
+ * @lru ages its anonymous pages.
+ */
+struct vmm_space {
+	uintptr_t pgdir;
+	struct vmm_region *regions;
+	struct vmm_lru lru;
+};
+
+struct vmm_fault_stats {
+	uint32_t faults;
+	uint32_t zerofill;
+	uint32_t mapped;
+	uint32_t cow_copied;
+	uint32_t cow_reused;
+	uint32_t swapped_out;
+	uint32_t swapped_in;
+	uint32_t failed;
+	uint32_t latency[VMM_FAULT_NBUCKETS];
+};
+
+extern struct vmm_space kernel_space;
+extern struct vmm_space *vmm_current;
+extern struct vmm_fault_stats vmm_fault_stats;
+
+/*
+ * Reserves the boot paging structures, must be called after kpm_init.
+ */
+void vmm_init();
+
+/*
+ * Maps the page frame @phys at @virt in the current address space,
+ * allocating the page table if needed.
+ * Returns 0 on success, -1 on error
+ */
+int vmm_map(void *virt, void *phys, int flags);
+
+/*
+ * Unmaps [@virt, @virt + @size) from the current address space.
+ * TLB invalidations and page table frees are batched into @tlb, the
+ * caller is responsible for calling tlb_finish.
+ */
+void vmm_unmap(struct tlb_gather *tlb, void *virt, size_t size);
+
+/*
+ * Returns the page table entry mapping @virt, or NULL if there is no
+ * page table for it.
+ */
+struct page_table_entry *vmm_get_pte(void *virt);
+
+/*
+ * Same as vmm_unmap, but also queues the mapped page frames in @tlb so they
+ * are given back to kpm after the flush.
+ */
+void vmm_zap(struct tlb_gather *tlb, void *virt, size_t size);
+
+/*
+ * Returns the physical address mapped at @virt, or NULL if unmapped.
+ */
+void *vmm_virt_to_phys(void *virt);
+
+/*
+ * Switches to the address space @space.
+ */
+void vmm_switch(struct vmm_space *space);
+
+/*
+ * Page frames reference counting, for frames mapped more than once.
+ * A frame starts with no additional mapping.
+ */
+uint16_t vmm_page_shares(void *phys);
+void vmm_page_share(void *phys);
+int vmm_page_unshare(void *phys);
+
+/*
+ * Creates in @dst a copy of the current address space @src.
+ * Lower half pages are shared copy-on-write, kernel page tables are shared.
+ * Returns 0 on success, -1 on error
+ */
+int vmm_clone(struct vmm_space *dst, struct vmm_space *src);
+
+/*
+ * Destroys the address space @space, which must not be the current one.
+ */
+void vmm_destroy(struct vmm_space *space);
+
+/*
+ * Reserves [@virt, @virt + @size) in @space. Nothing is mapped until the
+ * region is touched. With VMM_PHYS, the region maps physical memory
+ * starting at @phys instead of zero-filled frames.
+ * Returns 0 on success, -1 if the range overlaps a region or no region
+ * descriptor is left.
+ */
+int vmm_reserve(struct vmm_space *space, void *virt, size_t size, void *phys, int flags);
+
+/*
+ * Releases the region starting at @virt, unmapping it and freeing its
+ * zero-filled frames. @space must be the current address space.
+ */
+int vmm_release(struct vmm_space *space, void *virt);
+
+/*
+ * Returns the region of @space containing @virt, or NULL.
+ */
+struct vmm_region *vmm_find_region(struct vmm_space *space, void *virt);
+
+/*
+ * Returns 1 if @region holds anonymous lower half memory, the only memory
+ * that may be evicted or merged: kernel data and physical mappings never are.
+ */
+static inline int vmm_region_anon(struct vmm_region *region) {
+	return region->end <= VMM_USER_END && !(region->flags & VMM_PHYS);
+}
+
+/*
+ * Returns the first page at or after @va that belongs to an anonymous
+ * lower half region of @space, wrapping around once, or 0 if there is none.
+ * Used by the scanners walking anonymous memory.
+ */
+uintptr_t vmm_next_anon(struct vmm_space *space, uintptr_t va);
+
+/*
+ * Page fault handler backend: resolves a fault at @addr with the page
+ * fault @error_code by backing the faulting page.
+ * Returns 0 if the fault was resolved, -1 otherwise.
+ */
+int vmm_fault(void *addr, uint32_t error_code);
+int vmm_fault_sync(void *addr);
+int vmm_fault_cow(void *addr);
+
+/*
+ * Evicts one anonymous page of the current address space to zram.
+ * Returns 0 if a page was evicted, -1 otherwise.
+ */
+int vmm_swap_out();
+
+#endif
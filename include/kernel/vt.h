@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* include/kernel/vt.h
+ *
+ * Virtual terminals header file
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#ifndef VT_H
+#define VT_H
+
+#include <stddef.h>
+
+#include <kernel/screenbuf.h>
+
+/*
+ * Each terminal owns a slot of the VT area, where the lines of its
+ * screenbuf are backed page by page as they are written.
+ */
+#define VT_AREA			0xE2000000
+#define VT_AREA_SIZE	(16 * 1024 * 1024)
+#define VT_MAX			16
+#define VT_SLOT_SIZE	(VT_AREA_SIZE / VT_MAX)
+
+/* Scrollback limits, in lines */
+#define VT_MIN_LINES	(VGA_HEIGHT * 2)
+#define VT_MAX_LINES	(VT_SLOT_SIZE / (VGA_WIDTH * 2))
+#define VT_DFL_LINES	1000
+
+/* Screenbuf of the terminal shown, where kprintf writes */
+extern struct screenbuf *sb_current;
+
+/*
+ * Opens the terminal 0 and shows it, must be called after vmm_init.
+ * Halts with a message on the screen if it cannot be opened.
+ */
+void vt_init();
+
+/*
+ * Opens the terminal @n, or the first one closed if @n is -1, with a
+ * scrollback of @nlines lines.
+ * Returns the terminal, or -1 if it is open or out of memory
+ */
+int vt_open(int n, size_t nlines);
+
+/*
+ * Closes the terminal @n, giving its scrollback back to kpm.
+ * Returns 0 on success, -1 if it is not open or shown
+ */
+int vt_close(int n);
+
+/*
+ * Shows the terminal @n.
+ * Returns 0 on success, -1 if it is not open
+ */
+int vt_switch(int n);
+
+/*
+ * Returns the terminal shown
+ */
+int vt_current();
+
+/*
+ * Returns the next open terminal after @n, @step being 1 or -1 for the
+ * previous one, wrapping around. @n itself if it is the only one.
+ */
+int vt_next(int n, int step);
+
+/*
+ * Returns the screenbuf of the terminal @n, or NULL if it is not open
+ */
+struct screenbuf *vt_get(int n);
+
+#endif
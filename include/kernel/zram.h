@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* include/kernel/zram.h
+ *
+ * Compressed in-memory page store header file
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#ifndef ZRAM_H
+#define ZRAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <kernel/kpm.h>
+#include <kernel/paging.h>
+
+/*
+ * Compressed pages live in a kernel virtual pool, backed page by page as
+ * it fills up and carved in blocks of ZRAM_BLOCK_SIZE bytes. A stored
+ * page is identified by its handle, an index in the entry table.
+ */
+#define ZRAM_POOL			0xE0000000
+#define ZRAM_POOL_SIZE		(8 * 1024 * 1024)
+#define ZRAM_BLOCK_SIZE		64
+#define ZRAM_NBLOCKS		(ZRAM_POOL_SIZE / ZRAM_BLOCK_SIZE)
+#define ZRAM_BLOCKS_PER_PAGE	(PAGE_SIZE / ZRAM_BLOCK_SIZE)
+#define ZRAM_NENTRIES		4096
+
+/* Pages compressing worse than this stay in memory */
+#define ZRAM_MAX_SIZE		(PAGE_SIZE * 3 / 4)
+
+/*
+ * @block is the first block of the compressed data, @len its size,
+ * zero if the entry is unused. @refs counts the swap entries referring
+ * to it, address space clones share them.
+ */
+struct zram_entry {
+	uint32_t block;
+	uint16_t len;
+	uint16_t refs;
+};
+
+struct zram_stats {
+	uint32_t stored;		// pages currently stored
+	uint32_t compr_size;	// bytes of compressed data
+	uint32_t pool_pages;	// page frames backing the pool
+	uint32_t rejected;		// pages that did not compress enough
+	uint32_t compressed;
+	uint32_t decompressed;
+	uint64_t compr_cycles;
+	uint64_t decompr_cycles;
+};
+
+extern struct zram_stats zram_stats;
+
+/*
+ * Creates the page tables of the pool, must be called after vmm_init.
+ */
+void zram_init();
+
+/*
+ * Compresses and stores the page at @page.
+ * @spare is a page frame the caller is about to free: if the pool needs
+ * to grow, it is used first and @spare->size is set to 0.
+ * Returns the handle of the stored page, or -1 if the page does not
+ * compress well enough or the pool is full.
+ */
+int zram_store(void *page, kpm_chunk_t *spare);
+
+/*
+ * Decompresses the page @handle into @page.
+ * Returns 0 on success, -1 on error
+ */
+int zram_load(uint32_t handle, void *page);
+
+/*
+ * Takes an additional reference on the page @handle.
+ */
+void zram_dup(uint32_t handle);
+
+/*
+ * Drops a reference on the page @handle, freeing it with the last one.
+ */
+void zram_free(uint32_t handle);
+
+#endif
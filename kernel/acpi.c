@@ -0,0 +1,148 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* kernel/acpi.c
+ *
+ * Early lookup of ACPI tables through the root system description table
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/acpi.h>
+#include <kernel/kernel.h>
+#include <kernel/kpm.h>
+#include <kernel/vmm.h>
+#include <kernel/tlb.h>
+#include <kernel/cpu.h>
+#include <kernel/string.h>
+
+#define ACPI_LARGE_PAGE		(4 * 1024 * 1024)
+
+/* Where the BIOS stores the segment of the extended BIOS data area */
+#define ACPI_EBDA_PTR		0x40E
+#define ACPI_BIOS_START		0xE0000
+#define ACPI_BIOS_END		0x100000
+
+static uint32_t acpi_base;
+static int acpi_mapped;
+
+/*
+ * Maps the @len bytes at the physical address @phys in the window.
+ * Returns their virtual address, or NULL if they do not fit in it
+ */
+static void *acpi_map(uint32_t phys, size_t len) {
+	uint32_t base = ALIGN(phys, ACPI_LARGE_PAGE);
+	struct page_directory_entry *pde;
+
+	if (phys + len < phys || phys + len - base > ACPI_WINDOW_SIZE)
+		return NULL;
+	if (acpi_mapped && base == acpi_base)
+		return (void *)(ACPI_WINDOW + phys - base);
+
+	write_cr4(read_cr4() | CR4_PSE);
+	for (uint32_t off = 0; off < ACPI_WINDOW_SIZE; off += ACPI_LARGE_PAGE) {
+		pde = VMM_PAGE_DIRECTORY + PDE_INDEX(ACPI_WINDOW + off);
+		page_clear((struct page_entry *)pde);
+		pde->present = 1;
+		pde->page_size = 1;
+		pde->address = (base + off) >> 12;
+		tlb_invlpg((void *)(ACPI_WINDOW + off));
+	}
+	acpi_base = base;
+	acpi_mapped = 1;
+	return (void *)(ACPI_WINDOW + phys - base);
+}
+
+void acpi_done() {
+	if (!acpi_mapped)
+		return;
+	for (uint32_t off = 0; off < ACPI_WINDOW_SIZE; off += ACPI_LARGE_PAGE) {
+		page_clear((struct page_entry *)(VMM_PAGE_DIRECTORY + PDE_INDEX(ACPI_WINDOW + off)));
+		tlb_invlpg((void *)(ACPI_WINDOW + off));
+	}
+	acpi_mapped = 0;
+}
+
+/*
+ * Returns 1 if the @len bytes at @ptr sum to 0
+ */
+static int acpi_checksum(void *ptr, size_t len) {
+	uint8_t sum = 0;
+
+	for (size_t i = 0; i < len; i++)
+		sum += ((uint8_t *)ptr)[i];
+	return sum == 0;
+}
+
+/*
+ * Searches the root system description pointer on the 16 bytes boundaries
+ * of the low memory range [@start, @end[.
+ */
+static struct acpi_rsdp *acpi_scan_rsdp(uint32_t start, uint32_t end) {
+	struct acpi_rsdp *rsdp;
+
+	for (uint32_t phys = start; phys + sizeof(*rsdp) <= end; phys += 16) {
+		rsdp = (struct acpi_rsdp *)(KERNEL_VIRT_OFFSET + phys);
+		if (!memcmp(rsdp->signature, ACPI_RSDP_SIGNATURE, 8) && acpi_checksum(rsdp, sizeof(*rsdp)))
+			return rsdp;
+	}
+	return NULL;
+}
+
+static struct acpi_rsdp *acpi_find_rsdp() {
+	uint32_t ebda = *(uint16_t *)(KERNEL_VIRT_OFFSET + ACPI_EBDA_PTR) << 4;
+	struct acpi_rsdp *rsdp = NULL;
+
+	if (ebda >= 0x80000 && ebda < 0xA0000)
+		rsdp = acpi_scan_rsdp(ebda, ebda + 1024);
+	if (rsdp == NULL)
+		rsdp = acpi_scan_rsdp(ACPI_BIOS_START, ACPI_BIOS_END);
+	return rsdp;
+}
+
+/*
+ * Maps the whole table at @phys and checks it.
+ * Returns the table, or NULL if it is corrupted
+ */
+static struct acpi_header *acpi_map_table(uint32_t phys) {
+	struct acpi_header *table;
+	uint32_t len;
+
+	if ((table = acpi_map(phys, sizeof(*table))) == NULL)
+		return NULL;
+	len = table->length;
+	if (len < sizeof(*table) || (table = acpi_map(phys, len)) == NULL)
+		return NULL;
+	return acpi_checksum(table, len) ? table : NULL;
+}
+
+struct acpi_header *acpi_find(const char *signature) {
+	struct acpi_header *rsdt, *table;
+	struct acpi_rsdp *rsdp;
+	uint32_t regs[4];
+	uint32_t rsdt_phys;
+	uint32_t phys;
+	size_t n;
+
+	// Tables may be anywhere in memory, large pages are needed to reach
+	// them without page tables
+	cpuid(1, regs);
+	if (!(regs[3] & CPUID_1_EDX_PSE) || (rsdp = acpi_find_rsdp()) == NULL)
+		return NULL;
+	rsdt_phys = rsdp->rsdt;
+	if ((rsdt = acpi_map_table(rsdt_phys)) == NULL)
+		return NULL;
+	n = (rsdt->length - sizeof(*rsdt)) / sizeof(uint32_t);
+	for (size_t i = 0; i < n; i++) {
+		// Mapping an entry may unmap the root table
+		if ((rsdt = acpi_map_table(rsdt_phys)) == NULL)
+			return NULL;
+		phys = ((uint32_t *)(rsdt + 1))[i];
+		table = acpi_map(phys, sizeof(*table));
+		if (table == NULL || memcmp(table->signature, signature, 4))
+			continue;
+		return acpi_map_table(phys);
+	}
+	return NULL;
+}
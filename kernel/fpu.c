@@ -0,0 +1,121 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* fpu.c
+ *
+ * Kernel SIMD sections and the page kernels built on them
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/fpu.h>
+#include <kernel/cpu.h>
+#include <kernel/kpm.h>
+#include <kernel/string.h>
+#include <kernel/print.h>
+
+/* Largest buffer sse2_csum sums at once */
+#define CSUM_MAX_BLOCKS		1024
+
+int fpu_sse2;
+
+/* State of the sections cut by nested ones, the outermost first */
+static uint8_t fpu_state[FPU_MAX_DEPTH][FPU_STATE_SIZE] __attribute__((aligned(16)));
+static int fpu_depth;
+
+void fpu_init() {
+	uint32_t regs[4];
+
+	write_cr0((read_cr0() | CR0_MP | CR0_NE) & ~(CR0_EM | CR0_TS));
+	__asm__ volatile ("fninit");
+
+	cpuid(1, regs);
+	if ((regs[3] & CPUID_1_EDX_FXSR) && (regs[3] & CPUID_1_EDX_SSE) && (regs[3] & CPUID_1_EDX_SSE2)) {
+		write_cr4(read_cr4() | CR4_OSFXSR | CR4_OSXMMEXCPT);
+		fpu_sse2 = 1;
+	}
+}
+
+/*
+ * Stops the kernel when sections nest deeper than there is room to save
+ * their state: going on would clobber the SIMD registers of a section.
+ */
+static void fpu_overflow() {
+	kprintf("kernel_fpu_begin: more than %u nested SIMD sections\n", FPU_MAX_DEPTH);
+	while (1)
+		__asm__ volatile ("cli\n\thlt");
+}
+
+void kernel_fpu_begin() {
+	uint32_t flags = cpu_irq_save();
+
+	if (fpu_depth > FPU_MAX_DEPTH)
+		fpu_overflow();
+	if (fpu_depth > 0)
+		__asm__ volatile ("fxsave %0" : "=m" (fpu_state[fpu_depth - 1]));
+	fpu_depth++;
+	cpu_irq_restore(flags);
+}
+
+void kernel_fpu_end() {
+	uint32_t flags = cpu_irq_save();
+
+	fpu_depth--;
+	if (fpu_depth > 0)
+		__asm__ volatile ("fxrstor %0" :: "m" (fpu_state[fpu_depth - 1]));
+	cpu_irq_restore(flags);
+}
+
+void copy_page(void *dst, const void *src) {
+	if (!fpu_sse2) {
+		memcpy(dst, src, PAGE_SIZE);
+		return;
+	}
+	kernel_fpu_begin();
+	sse2_copy_page(dst, src);
+	kernel_fpu_end();
+}
+
+void clear_page(void *page) {
+	if (!fpu_sse2) {
+		memset(page, 0, PAGE_SIZE);
+		return;
+	}
+	kernel_fpu_begin();
+	sse2_clear_page(page);
+	kernel_fpu_end();
+}
+
+/*
+ * Adds @a and @b with the end around carry of ones' complement sums, 2^32
+ * being 1 modulo 0xFFFF.
+ */
+static inline uint32_t csum_add(uint32_t a, uint32_t b) {
+	a += b;
+	return a + (a < b);
+}
+
+uint16_t csum(const void *buf, size_t n) {
+	const uint8_t *p = buf;
+	uint32_t sum = 0;
+	size_t blocks;
+
+	if (fpu_sse2 && n >= 64) {
+		kernel_fpu_begin();
+		while (n >= 64) {
+			blocks = n / 64 < CSUM_MAX_BLOCKS ? n / 64 : CSUM_MAX_BLOCKS;
+			sum = csum_add(sum, sse2_csum(p, blocks));
+			p += blocks * 64;
+			n -= blocks * 64;
+		}
+		kernel_fpu_end();
+	}
+	for (; n >= 2; p += 2, n -= 2)
+		sum = csum_add(sum, p[0] | p[1] << 8);
+	if (n)
+		sum = csum_add(sum, p[0]);
+	while (sum >> 16)
+		sum = (sum & 0xFFFF) + (sum >> 16);
+	return ~sum;
+}
@@ -7,7 +7,7 @@
  * and interrupts
  *
  * created: 2022/10/18 - xlmod <glafond-@student.42.fr>
- * updated: 2022/11/25 - lfalkau <lfalkau@student.42.fr>
+ * updated: 2026/10/19 - agent <agent@local>
  */
 
 #include <stdint.h>
@@ -36,6 +36,7 @@ void idt_init() {
 	idt_set_descriptor(ISR_DE, divide_error_handler, TRAP_GATE_FLAGS);
 	idt_set_descriptor(ISR_OF, overflow_handler, TRAP_GATE_FLAGS);
 	idt_set_descriptor(ISR_DF, double_fault_handler, TRAP_GATE_FLAGS);
+	idt_set_descriptor(ISR_PF, page_fault_handler, INT_GATE_FLAGS);
 	idt_set_descriptor(ISR_TM, timer_handler, INT_GATE_FLAGS);
 	idt_set_descriptor(ISR_KB, keyboard_handler, INT_GATE_FLAGS);
 
@@ -6,7 +6,7 @@
  * Declaration of idt internal structures and functions.
  *
  * created: 2022/10/18 - xlmod <glafond-@student.42.fr>
- * updated: 2022/10/21 - mrxx0 <chcoutur@student.42.fr>
+ * updated: 2026/10/19 - agent <agent@local>
  */
 
 #ifndef IDT_INTERNAL_H
@@ -29,6 +29,7 @@
 #define ISR_DE 0
 #define ISR_OF 4
 #define ISR_DF 8
+#define ISR_PF 14
 #define ISR_TM 32
 #define ISR_KB 33
 
@@ -40,10 +41,13 @@
 #define IRQ_KB ISR_KB - ISR_IRQ
 
 /* Macro to load kernel data segment in segment registers.
+ * The direction flag is cleared, as the interrupted code may be in the
+ * middle of a backward string copy.
  */
 #define LOAD_INTERRUPT_STACK \
 	__asm__ volatile (\
 			"cli\n"\
+			"cld\n"\
 			"mov %ds, %ax\n"\
 			"push %eax\n"\
 			"mov $0x10, %ax\n"\
@@ -67,6 +71,20 @@
 			"sti\n"\
 			)
 
+/* Same as RESET_INTERRUPT_STACK without the sti, for the handlers entered
+ * through an interrupt gate from any context: iret restores the interrupt
+ * flag of the interrupted code.
+ */
+#define RESET_FAULT_STACK \
+	__asm__ volatile (\
+			"sub $4, %esp\n"\
+			"pop %eax\n"\
+			"mov %ax, %ds\n"\
+			"mov %ax, %es\n"\
+			"mov %ax, %fs\n"\
+			"mov %ax, %gs\n"\
+			)
+
 /* Entry in the IDT
  */
 typedef struct {
@@ -100,6 +118,7 @@ typedef struct {
 __attribute__ ((interrupt)) void divide_error_handler(t_int_frame *int_frame);
 __attribute__ ((interrupt)) void overflow_handler(t_int_frame *int_frame);
 __attribute__ ((interrupt)) void double_fault_handler(t_int_frame *int_frame, uint32_t error_code);
+__attribute__ ((interrupt)) void page_fault_handler(t_int_frame *int_frame, uint32_t error_code);
 
 /* IRQ
  * Hardware Interrupt
@@ -7,11 +7,15 @@
  * and interrupts
  *
  * created: 2022/10/18 - xlmod <glafond-@student.42.fr>
- * updated: 2022/10/21 - mrxx0 <chcoutur@student.42.fr>
+ * updated: 2026/10/19 - agent <agent@local>
  */
 
 #include <kernel/print.h>
 #include <kernel/pic_8259.h>
+#include <kernel/vmm.h>
+#include <kernel/cpu.h>
+#include <kernel/timer.h>
+#include <kernel/screenbuf.h>
 
 #include "idt_internal.h"
 
@@ -77,6 +81,31 @@ __attribute__ ((interrupt)) void double_fault_handler(t_int_frame *int_frame, ui
 	RESET_INTERRUPT_STACK;
 }
 
+/* PAGE FAULT (14)
+ * Occurs when a page is not present or when its protection is violated.
+ * Faults in reserved regions are resolved by the vmm, the others are fatal.
+ * Entered through an interrupt gate, so that no IRQ runs before cr2 is read,
+ * and left with the interrupt flag of the faulting code, which may be a
+ * handler itself in the middle of list updates.
+ *
+ * @arg(int_frame): interrupt frame structure.
+ * @arg(error_code): page fault error code.
+ */
+__attribute__ ((interrupt)) void page_fault_handler(t_int_frame *int_frame, uint32_t error_code)
+{
+	uint32_t addr = read_cr2();
+
+	LOAD_INTERRUPT_STACK;
+
+	if (vmm_fault((void *)addr, error_code) < 0) {
+		kprintf("PAGE FAULT at %8p\n", addr);
+		print_int_frame(int_frame, &error_code);
+		asm volatile ("hlt");
+	}
+
+	RESET_FAULT_STACK;
+}
+
 /* TIMER HANDLER (32)
  * Occurs when 8259 PIC receive an IRQ0 (timer hardware interrupt)
  *
@@ -85,6 +114,8 @@ __attribute__ ((interrupt)) void double_fault_handler(t_int_frame *int_frame, ui
 __attribute__ ((interrupt)) void timer_handler(t_int_frame *int_frame)
 {
 	LOAD_INTERRUPT_STACK;
+	timer_tick();
+	sb_flush_tick();
 	pic_8259_eoi(IRQ_TM);
 	RESET_INTERRUPT_STACK;
 }
@@ -6,24 +6,30 @@
  * Entrypoint of the KFS kernel
  *
  * created: 2022/10/11 - lfalkau <lfalkau@student.42.fr>
- * updated: 2022/12/15 - mrxx0 <chcoutur@student.42.fr>
+ * updated: 2026/10/19 - agent <agent@local>
  */
 
 #include <kernel/gdt.h>
 #include <kernel/idt.h>
 #include <kernel/keyboard.h>
 #include <kernel/pic_8259.h>
+#include <kernel/timer.h>
+#include <kernel/fpu.h>
 #include <kernel/multiboot.h>
+#include <kernel/resource.h>
 #include <kernel/kpm.h>
-#include <kernel/screenbuf.h>
+#include <kernel/vmm.h>
+#include <kernel/vmalloc.h>
+#include <kernel/kmap.h>
+#include <kernel/zram.h>
+#include <kernel/ksm.h>
+#include <kernel/lru.h>
+#include <kernel/pgtable.h>
+#include <kernel/slab.h>
+#include <kernel/tlsf.h>
+#include <kernel/vt.h>
 #include <kernel/nsh.h>
 
-#define NBSCREENBUF 2
-
-struct screenbuf sb[NBSCREENBUF];
-struct screenbuf *sb_current;
-int sb_nbscreen = NBSCREENBUF;
-
 /* Initialize all descriptor tables (gdt, idt, ...)
  *
  */
@@ -37,18 +43,23 @@ void kernel_main(unsigned long multiboot_info_addr) {
 	multiboot_info_t *mbi = (multiboot_info_t *)multiboot_info_addr;
 
 	init_descriptor_tables();
+	fpu_init();
+	timer_init();
 	KBD_initialize();
 
-	kpm_init((void *)mbi->mmap_addr,
-		mbi->mmap_length / sizeof(struct multiboot_mmap_entry),
-		mbi->mem_upper - mbi->mem_lower);
-
-	for (int i = 0; i < NBSCREENBUF; i++) {
-		sb_init(sb + i);
-		sb_putstr(sb + i, "Welcome to nulix-2.0.1\n");
-	};
-	sb_current = sb;
-	sb_load(sb_current);
+	resource_init((void *)mbi->mmap_addr,
+		mbi->mmap_length / sizeof(struct multiboot_mmap_entry));
+	kpm_init(mbi->mem_upper - mbi->mem_lower);
+	vmm_init();
+	kmap_init();
+	zram_init();
+	vmalloc_init();
+	slab_init();
+	rtheap_init();
+	ksm_init();
+	lru_init();
+	pgtable_init();
+	vt_init();
 
 	nsh();
 }
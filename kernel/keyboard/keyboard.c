@@ -6,12 +6,13 @@
  * Keyboard driver
  *
  * created: 2022/10/15 - lfalkau <lfalkau@student.42.fr>
- * updated: 2022/12/14 - glafond- <glafond-@student.42.fr>
+ * updated: 2026/10/19 - agent <agent@local>
  */
 
 #include <kernel/keyboard.h>
 #include <kernel/port.h>
 #include <kernel/ps2.h>
+#include <kernel/timer.h>
 #include <stdint.h>
 
 /* Used to translate scancodes to keycodes. Defined in scancodes.c */
@@ -154,7 +155,9 @@ int KBD_getevent(struct kbd_event *evt) {
  */
 void KBD_geteventbytype(struct kbd_event *evt, enum kbd_eventtype type) {
 	while (1) {
-		while (!KBD_poll());
+		// Waiting for a key is the kernel idle loop
+		while (!KBD_poll())
+			timer_run();
 		if (KBD_getevent(evt) == 0 && evt->type == type)
 			return ;
 	}
@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* kernel/memory/arena.c
+ *
+ * Bump allocator arenas
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/arena.h>
+#include <kernel/vmalloc.h>
+
+#define ARENA_HEADER		ALIGNNEXT(sizeof(struct arena_chunk), ARENA_ALIGN)
+
+/* kpm does not give more than its biggest order at once */
+#define ARENA_MAX_CHUNK		(PAGE_SIZE << (KPM_NORDERS - 1))
+
+static void arena_free_chunk(struct arena_chunk *chunk) {
+	kpm_chunk_t frames = chunk->frames;
+
+	vunmap(chunk);
+	kpm_free(&frames);
+}
+
+/*
+ * Adds a chunk with room for @size bytes to @arena.
+ * Returns the chunk, or NULL when out of memory
+ */
+static struct arena_chunk *arena_grow(struct arena *arena, size_t size) {
+	size_t need = ARENA_HEADER + size;
+	struct arena_chunk *chunk;
+	kpm_chunk_t frames;
+
+	if (arena->spare && arena->spare->frames.size >= need) {
+		chunk = arena->spare;
+		arena->spare = NULL;
+	} else {
+		if (need < ARENA_CHUNK_SIZE)
+			need = ARENA_CHUNK_SIZE;
+		if (kpm_alloc(&frames, need) < 0)
+			return NULL;
+		// kpm gives the biggest region it has up to @need bytes
+		if (frames.size < ARENA_HEADER + size) {
+			kpm_free(&frames);
+			return NULL;
+		}
+		if ((chunk = vmap(&frames, 1)) == NULL) {
+			kpm_free(&frames);
+			return NULL;
+		}
+		chunk->frames = frames;
+	}
+	chunk->prev = arena->current;
+	chunk->used = ARENA_HEADER;
+	arena->current = chunk;
+	return chunk;
+}
+
+/*
+ * Removes the current chunk of @arena, keeping it as spare if it has the
+ * default size and there is none yet.
+ */
+static void arena_shrink(struct arena *arena) {
+	struct arena_chunk *chunk = arena->current;
+
+	arena->current = chunk->prev;
+	if (arena->spare == NULL && chunk->frames.size == ARENA_CHUNK_SIZE)
+		arena->spare = chunk;
+	else
+		arena_free_chunk(chunk);
+}
+
+void *arena_alloc(struct arena *arena, size_t size) {
+	struct arena_chunk *chunk = arena->current;
+	void *ptr;
+
+	if (size == 0 || size > ARENA_MAX_CHUNK - ARENA_HEADER)
+		return NULL;
+	size = ALIGNNEXT(size, ARENA_ALIGN);
+	if (chunk == NULL || chunk->frames.size - chunk->used < size) {
+		if ((chunk = arena_grow(arena, size)) == NULL)
+			return NULL;
+	}
+	ptr = (void *)chunk + chunk->used;
+	chunk->used += size;
+	return ptr;
+}
+
+struct arena_mark arena_mark(struct arena *arena) {
+	struct arena_mark mark = {arena->current, 0};
+
+	if (arena->current)
+		mark.used = arena->current->used;
+	return mark;
+}
+
+void arena_reset(struct arena *arena, struct arena_mark mark) {
+	while (arena->current && arena->current != mark.chunk)
+		arena_shrink(arena);
+	if (arena->current)
+		arena->current->used = mark.used;
+}
+
+void arena_release(struct arena *arena) {
+	while (arena->current)
+		arena_shrink(arena);
+	if (arena->spare) {
+		arena_free_chunk(arena->spare);
+		arena->spare = NULL;
+	}
+}
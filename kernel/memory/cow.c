@@ -0,0 +1,227 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* kernel/memory/cow.c
+ *
+ * Address space cloning with copy-on-write page sharing
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/vmm.h>
+#include <kernel/tlb.h>
+#include <kernel/kpm.h>
+#include <kernel/kmap.h>
+#include <kernel/zram.h>
+#include <kernel/lru.h>
+#include <kernel/pgtable.h>
+#include <kernel/string.h>
+#include <kernel/fpu.h>
+
+/*
+ * Copies the lower half regions of @src into @dst.
+ *
+ * Returns 0 on success, -1 on error
+ */
+static int vmm_clone_regions(struct vmm_space *dst, struct vmm_space *src) {
+	for (struct vmm_region *r = src->regions; r != NULL; r = r->next) {
+		if (r->start >= VMM_USER_END)
+			break;
+		if (vmm_reserve(dst, (void *)r->start, r->end - r->start, (void *)r->phys, r->flags) < 0)
+			return -1;
+	}
+	return 0;
+}
+
+/*
+ * Fills the page table @dst with the entries of the current page table
+ * covering @base. Every page but physical mappings becomes shared:
+ * writable ones are write protected and marked copy-on-write in both
+ * address spaces. Swapped out pages share their zram entry.
+ */
+static void vmm_clone_table(struct vmm_space *src, struct page_table_entry *dst, uintptr_t base) {
+	struct page_table_entry *table = VMM_PAGE_TABLE(base);
+	struct page_table_entry *pte;
+	struct vmm_region *region = NULL;
+	uintptr_t va;
+
+	for (size_t i = 0; i < PAGE_TABLE_LENGTH; i++) {
+		pte = table + i;
+		if (!pte->present) {
+			if (pte->swap) {
+				zram_dup(pte->address);
+				dst[i] = *pte;
+			} else {
+				page_clear((struct page_entry *)(dst + i));
+			}
+			continue;
+		}
+		va = base + i * PAGE_SIZE;
+		if (region == NULL || va < region->start || va >= region->end)
+			region = vmm_find_region(src, (void *)va);
+		if (region == NULL || !(region->flags & VMM_PHYS)) {
+			if (pte->writable) {
+				pte->writable = 0;
+				pte->cow = 1;
+			}
+			vmm_page_share((void *)((uint32_t)pte->address << 12));
+		}
+		dst[i] = *pte;
+	}
+}
+
+/*
+ * Gives back the page table @chunk from pgtable_alloc, unused: only a
+ * @zeroed one may go back to the quicklist.
+ */
+static void vmm_clone_put(kpm_chunk_t *chunk, int zeroed) {
+	if (zeroed)
+		pgtable_free(chunk->addr);
+	else
+		kpm_free(chunk);
+}
+
+/*
+ * Creates in @dst a copy of the current address space @src.
+ *
+ * Only paging structures are copied: the identity mapped low memory and
+ * the kernel half page tables are shared, lower half page tables are
+ * duplicated with their pages shared copy-on-write. The cost is then
+ * proportional to the number of page tables and not to the memory in use.
+ *
+ * Returns 0 on success, -1 on error
+ */
+int vmm_clone(struct vmm_space *dst, struct vmm_space *src) {
+	struct page_directory_entry *pgdir;
+	struct page_table_entry *table;
+	kpm_chunk_t chunk;
+	int zeroed;
+	int ret = 0;
+
+	if (src != vmm_current || (zeroed = pgtable_alloc(&chunk)) < 0)
+		return -1;
+	if ((pgdir = kmap_atomic(PFN(chunk.addr))) == NULL) {
+		vmm_clone_put(&chunk, zeroed);
+		return -1;
+	}
+	dst->pgdir = (uintptr_t)chunk.addr;
+	dst->regions = NULL;
+	memset(&dst->lru, 0, sizeof(dst->lru));
+
+	if (!zeroed)
+		memset(pgdir, 0, PAGE_SIZE);
+	pgdir[0] = VMM_PAGE_DIRECTORY[0];
+	for (size_t i = PDE_INDEX(KERNEL_VIRT_OFFSET); i < LAST_PAGE_ENTRY; i++)
+		pgdir[i] = VMM_KERNEL_PGDIR[i];
+	page_init((struct page_entry *)(pgdir + LAST_PAGE_ENTRY), chunk.addr, 1, 0);
+
+	ret = vmm_clone_regions(dst, src);
+	for (size_t i = PDE_INDEX(VMM_USER_BASE); ret == 0 && i < PDE_INDEX(VMM_USER_END); i++) {
+		if (!VMM_PAGE_DIRECTORY[i].present)
+			continue;
+		// Every entry is written, zeroed or not
+		if ((zeroed = pgtable_alloc(&chunk)) < 0) {
+			ret = -1;
+			break;
+		}
+		if ((table = kmap_atomic(PFN(chunk.addr))) == NULL) {
+			vmm_clone_put(&chunk, zeroed);
+			ret = -1;
+			break;
+		}
+		vmm_clone_table(src, table, i * PAGE_SIZE * PAGE_TABLE_LENGTH);
+		kunmap_atomic(table);
+		pgdir[i] = VMM_PAGE_DIRECTORY[i];
+		pgdir[i].address = (uintptr_t)chunk.addr >> 12;
+	}
+	kunmap_atomic(pgdir);
+
+	// Pages of @src have been write protected
+	tlb_flush_all();
+
+	if (ret < 0)
+		vmm_destroy(dst);
+	return ret;
+}
+
+/*
+ * Destroys the address space @space, which must not be the current one.
+ * Its regions are released, pages mapped outside of any region are
+ * considered anonymous memory and freed as well.
+ */
+void vmm_destroy(struct vmm_space *space) {
+	struct vmm_space *prev = vmm_current;
+	struct page_directory_entry *pgdir;
+	struct tlb_gather tlb;
+	kpm_chunk_t chunk;
+
+	if (space == prev || space == &kernel_space)
+		return;
+	lru_drain(space);
+	vmm_switch(space);
+	while (space->regions != NULL)
+		vmm_release(space, (void *)space->regions->start);
+	tlb_gather_init(&tlb);
+	vmm_zap(&tlb, (void *)VMM_USER_BASE, VMM_USER_END - VMM_USER_BASE);
+	tlb_finish(&tlb);
+	vmm_switch(prev);
+
+	// Lower half page tables are all gone, only the shared entries are
+	// left before the directory can be recycled
+	// Without a slot to clear it, the directory can't go to the quicklist
+	if ((pgdir = kmap_atomic(PFN(space->pgdir))) == NULL) {
+		chunk.addr = (void *)space->pgdir;
+		chunk.size = PAGE_SIZE;
+		kpm_free(&chunk);
+		space->pgdir = 0;
+		return;
+	}
+	page_clear((struct page_entry *)pgdir);
+	memset(pgdir + PDE_INDEX(KERNEL_VIRT_OFFSET), 0,
+		(PAGE_DIRECTORY_LENGTH - PDE_INDEX(KERNEL_VIRT_OFFSET)) * sizeof(*pgdir));
+	kunmap_atomic(pgdir);
+	pgtable_free((void *)space->pgdir);
+	space->pgdir = 0;
+}
+
+/*
+ * Resolves a write fault on a copy-on-write page.
+ * If the page is still shared, it is duplicated into a new frame,
+ * otherwise the last owner simply gets write access back.
+ *
+ * Returns 0 if the fault was resolved, -1 otherwise
+ */
+int vmm_fault_cow(void *addr) {
+	void *page = (void *)ALIGN(addr, PAGE_SIZE);
+	struct page_table_entry *pte = vmm_get_pte(page);
+	kpm_chunk_t chunk;
+	void *phys;
+	void *copy;
+
+	if (pte == NULL || !pte->present || !pte->cow)
+		return -1;
+	phys = (void *)((uint32_t)pte->address << 12);
+
+	if (vmm_page_shares(phys) > 0) {
+		if (kpm_alloc(&chunk, PAGE_SIZE) < 0)
+			return -1;
+		if ((copy = kmap_atomic(PFN(chunk.addr))) == NULL) {
+			kpm_free(&chunk);
+			return -1;
+		}
+		copy_page(copy, page);
+		kunmap_atomic(copy);
+		vmm_page_unshare(phys);
+		pte->address = (uintptr_t)chunk.addr >> 12;
+		lru_add(vmm_current, (uintptr_t)page, chunk.addr);
+		vmm_fault_stats.cow_copied++;
+	} else {
+		vmm_fault_stats.cow_reused++;
+	}
+	pte->cow = 0;
+	pte->ksm = 0;
+	pte->writable = 1;
+	tlb_invlpg(page);
+	return 0;
+}
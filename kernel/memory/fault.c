@@ -0,0 +1,154 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* kernel/memory/fault.c
+ *
+ * Page fault resolution: demand paging of reserved regions and swap in
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/vmm.h>
+#include <kernel/kpm.h>
+#include <kernel/cpu.h>
+#include <kernel/kmap.h>
+#include <kernel/zram.h>
+#include <kernel/lru.h>
+#include <kernel/pgtable.h>
+#include <kernel/slab.h>
+#include <kernel/string.h>
+
+struct vmm_fault_stats vmm_fault_stats;
+
+/*
+ * Accounts a fault that took @cycles to be handled.
+ */
+static void vmm_fault_account(uint64_t cycles) {
+	int bucket = 0;
+
+	if (cycles >> 32)
+		bucket = VMM_FAULT_NBUCKETS - 1;
+	else if (cycles >> VMM_FAULT_MINSHIFT)
+		bucket = 31 - __builtin_clz((uint32_t)cycles) - VMM_FAULT_MINSHIFT + 1;
+	if (bucket >= VMM_FAULT_NBUCKETS)
+		bucket = VMM_FAULT_NBUCKETS - 1;
+	vmm_fault_stats.latency[bucket]++;
+}
+
+/*
+ * Allocates a page frame for the fault being handled. When kpm is out of
+ * memory, the page table quicklist and the empty slabs are released first,
+ * then anonymous pages are swapped out until a frame is available.
+ *
+ * Returns 0 on success, -1 on error
+ */
+static int vmm_fault_frame(kpm_chunk_t *chunk) {
+	while (kpm_alloc(chunk, PAGE_SIZE) < 0) {
+		if (pgtable_shrink() == 0 && slab_shrink() == 0 && vmm_swap_out() < 0)
+			return -1;
+	}
+	return 0;
+}
+
+/*
+ * Brings back the swapped out page at @page, whose swap entry is @pte.
+ *
+ * Returns 0 on success, -1 on error
+ */
+static int vmm_fault_swap(struct page_table_entry *pte, uintptr_t page, int flags) {
+	uint32_t handle = pte->address;
+	kpm_chunk_t chunk;
+	void *dst;
+	int ret;
+
+	if (vmm_fault_frame(&chunk) < 0)
+		return -1;
+	if ((dst = kmap_atomic(PFN(chunk.addr))) == NULL) {
+		kpm_free(&chunk);
+		return -1;
+	}
+	ret = zram_load(handle, dst);
+	kunmap_atomic(dst);
+	if (ret < 0 || vmm_map((void *)page, chunk.addr, flags) < 0) {
+		kpm_free(&chunk);
+		return -1;
+	}
+	zram_free(handle);
+	lru_add(vmm_current, page, chunk.addr);
+	vmm_fault_stats.swapped_in++;
+	return 0;
+}
+
+/*
+ * Backs the page at @page, inside @region, with a zero-filled frame
+ * or with the physical page the region describes.
+ *
+ * Returns 0 on success, -1 on error
+ */
+static int vmm_fault_map(struct vmm_region *region, uintptr_t page) {
+	struct page_table_entry *pte;
+	kpm_chunk_t chunk;
+	int flags = region->flags & (VMM_WRITE | VMM_USER);
+
+	if (region->flags & VMM_PHYS) {
+		if (vmm_map((void *)page, (void *)(region->phys + (page - region->start)), flags) < 0)
+			return -1;
+		vmm_fault_stats.mapped++;
+		return 0;
+	}
+
+	pte = vmm_get_pte((void *)page);
+	if (pte != NULL && pte->swap)
+		return vmm_fault_swap(pte, page, flags);
+
+	if (vmm_fault_frame(&chunk) < 0)
+		return -1;
+	// Mapped writable until it is cleared, then downgraded if needed
+	if (vmm_map((void *)page, chunk.addr, flags | VMM_WRITE) < 0) {
+		kpm_free(&chunk);
+		return -1;
+	}
+	memset((void *)page, 0, PAGE_SIZE);
+	if (!(flags & VMM_WRITE))
+		vmm_map((void *)page, chunk.addr, flags);
+	if (vmm_region_anon(region))
+		lru_add(vmm_current, page, chunk.addr);
+	vmm_fault_stats.zerofill++;
+	return 0;
+}
+
+/*
+ * Resolves a page fault at @addr:
+ * - write faults on copy-on-write pages get their own copy,
+ * - faults on kernel page tables missing from the current address space
+ *   are synchronized with the kernel page directory,
+ * - not-present faults inside a region are backed, with respect to the
+ *   region write permission, either from zram or with a zero-filled page.
+ *   Kernel half regions belong to kernel_space.
+ *
+ * Returns 0 if the fault was resolved, -1 otherwise
+ */
+int vmm_fault(void *addr, uint32_t error_code) {
+	uint64_t start = rdtsc();
+	struct vmm_space *space;
+	struct vmm_region *region;
+	int ret = -1;
+
+	vmm_fault_stats.faults++;
+	if (error_code & PF_PRESENT) {
+		if (error_code & PF_WRITE)
+			ret = vmm_fault_cow(addr);
+	} else if (vmm_fault_sync(addr) == 0) {
+		ret = 0;
+	} else {
+		space = (uintptr_t)addr >= KERNEL_VIRT_OFFSET ? &kernel_space : vmm_current;
+		region = vmm_find_region(space, addr);
+		if (region != NULL && (!(error_code & PF_WRITE) || (region->flags & VMM_WRITE)))
+			ret = vmm_fault_map(region, ALIGN(addr, PAGE_SIZE));
+	}
+	if (ret < 0)
+		vmm_fault_stats.failed++;
+	vmm_fault_account(rdtsc() - start);
+	return ret;
+}
@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* kernel/memory/kmap.c
+ *
+ * Temporary mappings of arbitrary page frames through fixmap slots
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/kmap.h>
+#include <kernel/vmm.h>
+#include <kernel/tlb.h>
+#include <kernel/cpu.h>
+
+/* Number of slots in use, per cpu */
+static int kmap_depth[KMAP_NCPUS];
+
+/*
+ * Creates the fixmap page table, must be called after vmm_init.
+ * Mapping then unmapping a slot is enough to get the page table allocated
+ * in the kernel page directory.
+ */
+void kmap_init() {
+	struct tlb_gather tlb;
+
+	vmm_map((void *)FIXMAP_BASE, 0, 0);
+	tlb_gather_init(&tlb);
+	vmm_unmap(&tlb, (void *)FIXMAP_BASE, PAGE_SIZE);
+	tlb_finish(&tlb);
+}
+
+/*
+ * Maps the page frame @pfn in the next free slot of the current cpu.
+ * The slot page table entry is rewritten and the stale translation
+ * invalidated, nothing else.
+ *
+ * Returns the virtual address of the mapping, or NULL if every slot is
+ * in use
+ */
+void *kmap_atomic(uint32_t pfn) {
+	int cpu = cpu_id();
+	int slot;
+	void *virt;
+
+	if (kmap_depth[cpu] == KMAP_SLOTS)
+		return NULL;
+	slot = cpu * KMAP_SLOTS + kmap_depth[cpu]++;
+	virt = (void *)(FIXMAP_BASE + slot * PAGE_SIZE);
+	*(uint32_t *)(VMM_PAGE_TABLE(FIXMAP_BASE) + slot) = (pfn << 12) | PAGE_PRESENT | PAGE_WRITABLE;
+	tlb_invlpg(virt);
+	return virt;
+}
+
+/*
+ * Releases the last slot of the current cpu.
+ * The entry is left as is: the next kmap_atomic of this slot overwrites it
+ * and invalidates the translation anyway.
+ */
+void kunmap_atomic(void *addr) {
+	int cpu = cpu_id();
+
+	(void)addr;
+	if (kmap_depth[cpu] > 0)
+		kmap_depth[cpu]--;
+}
@@ -6,36 +6,38 @@
  * Kernel Physical Memory management
  *
  * created: 2022/11/23 - lfalkau <lfalkau@student.42.fr>
- * updated: 2022/12/17 - xlmod <glafond-@student.42.fr>
+ * updated: 2026/10/19 - agent <agent@local>
  */
 
 #include <kernel/kpm.h>
 #include <kernel/print.h>
 #include <kernel/string.h>
 #include <kernel/kernel.h>
+#include <kernel/resource.h>
 
-buddy_t *buddy;
+struct kpm_node kpm_nodes[NUMA_MAX_NODES];
+enum kpm_policy kpm_policy = KPM_PREFERRED;
+size_t kpm_nframes;
+
+static struct resource kpm_resource = {
+	.name = "Buddy allocator",
+	.flags = RESOURCE_RAM | RESOURCE_BUSY,
+};
 
 extern uint32_t sk;
 extern uint32_t ek;
 
 /*
- * kpm_init must be called before any call to other kpm functions.
- * It initializes the buddy structure in memory and set the available
- * RAM regions as free blocks.
- *
- * @entries: Address of the multiboot structure array containing information on
- * memory maps from the BIOS
- * @count: Number of memory map entries
- * @memkb: Total amount of physical memory, in KiB
+ * Lays out at @at a buddy allocator for the @nframes page frames starting
+ * at the frame @base, all of them disabled.
  */
-void kpm_init(struct multiboot_mmap_entry *entries, size_t count, size_t memkb) {
-	size_t buddy_size;
+static buddy_t *buddy_init(void *at, size_t base, size_t nframes) {
+	buddy_t *buddy = at;
 	size_t enabled_frames_size;
 	size_t total_orders_size;
 
-	buddy = (buddy_t *)ALIGNNEXT((uint32_t)&ek, PAGE_SIZE);
-	buddy->nframes = ALIGN(memkb * 1024 / PAGE_SIZE, 1024);
+	buddy->base = base;
+	buddy->nframes = nframes;
 	enabled_frames_size = KPM_NBYTES_FROM_NBITS(buddy->nframes);
 	total_orders_size = 0;
 	for (size_t i = 0, nblocks = buddy->nframes; i < KPM_NORDERS; i++, nblocks /= 2) {
@@ -52,14 +54,79 @@ void kpm_init(struct multiboot_mmap_entry *entries, size_t count, size_t memkb)
 
 	memset(buddy->enabled_frames, 0, enabled_frames_size);
 	memset(buddy->orders[0].bitmap, 0xff, total_orders_size);
+	return buddy;
+}
 
-	for (struct multiboot_mmap_entry *entry = entries; entry->size != 0; entry++) {
-		if (entry->type == MULTIBOOT_MEMORY_AVAILABLE)
-			kpm_enable((void *)(uintptr_t)entry->addr, (uint32_t)(entry->len));
+/*
+ * Sorts the other nodes by distance from @node, for the fallback.
+ */
+static void kpm_node_fallback(int node) {
+	uint8_t *fallback = kpm_nodes[node].fallback;
+	uint8_t *distance = numa_distance[node];
+	int n = 0;
+
+	fallback[n++] = node;
+	for (int other = 0; other < numa_nnodes; other++) {
+		if (other == node)
+			continue;
+		int i = n++;
+		for (; i > 1 && distance[fallback[i - 1]] > distance[other]; i--)
+			fallback[i] = fallback[i - 1];
+		fallback[i] = other;
+	}
+}
+
+/*
+ * kpm_init must be called before any call to other kpm functions.
+ * It reads the memory nodes, initializes one buddy structure per node in
+ * memory and set the RAM regions of the resource tree as free blocks.
+ *
+ * @memkb: Total amount of physical memory, in KiB
+ */
+void kpm_init(size_t memkb) {
+	void *first = (void *)ALIGNNEXT((uint32_t)&ek, PAGE_SIZE);
+	void *at = first;
+	size_t start, end;
+	buddy_t *buddy;
+	struct resource *res;
+
+	numa_init(ALIGN(memkb / (PAGE_SIZE / 1024), 1024));
+	kpm_nframes = 0;
+	for (int node = 0; node < numa_nnodes; node++) {
+		start = (size_t)-1;
+		end = 0;
+		for (int i = 0; i < numa_nranges; i++) {
+			if (numa_ranges[i].node != node)
+				continue;
+			if (numa_ranges[i].start < start)
+				start = numa_ranges[i].start;
+			if (numa_ranges[i].end > end)
+				end = numa_ranges[i].end;
+		}
+		// Keep blocks aligned on their size in physical memory
+		start = ALIGN(start, 1 << (KPM_NORDERS - 1));
+		buddy = buddy_init(at, start, ALIGNNEXT(end - start, 1 << (KPM_NORDERS - 1)));
+		at = (void *)ALIGNNEXT((uintptr_t)at + buddy->size, sizeof(uint32_t));
+		if (buddy->base + buddy->nframes > kpm_nframes)
+			kpm_nframes = buddy->base + buddy->nframes;
+		kpm_nodes[node].buddy = buddy;
+		kpm_nodes[node].free = 0;
+		kpm_node_fallback(node);
+	}
+
+	// Holes, reserved and device memory are siblings of RAM ranges
+	for (res = iomem_resource.child; res; res = res->sibling) {
+		start = ALIGNNEXT(res->start, PAGE_SIZE);
+		end = ALIGN((uint64_t)res->end + 1, PAGE_SIZE);
+		if ((res->flags & RESOURCE_RAM) && start < end)
+			kpm_enable((void *)start, end - start);
 	}
 	kpm_disable((void *)0, PAGE_SIZE); // Also disables IDT + GDT by design
 	kpm_disable(&sk, ((uintptr_t)&ek - KERNEL_VIRT_OFFSET) - (uintptr_t)&sk);
-	kpm_disable((void *)((uintptr_t)buddy - KERNEL_VIRT_OFFSET), buddy->size);
+	kpm_disable((void *)((uintptr_t)first - KERNEL_VIRT_OFFSET), at - first);
+	kpm_resource.start = (uintptr_t)first - KERNEL_VIRT_OFFSET;
+	kpm_resource.end = kpm_resource.start + (at - first) - 1;
+	resource_insert(&kpm_resource);
 }
 
 /*
@@ -67,27 +134,87 @@ void kpm_init(struct multiboot_mmap_entry *entries, size_t count, size_t memkb)
  *
  * After each operation on the physical memory (alloc/enable...), we need to
  * update every parent nodes in the tree.
- * kpm_update_order does it for a specific order at index @n.
+ * kpm_update_order does it for a specific order at index @n, on the @count
+ * frames starting at the index @first.
  */
-inline static void kpm_update_order(size_t n, void *base, size_t limit) {
-	size_t order_block_size = PAGE_SIZE * (1 << n);
+inline static void kpm_update_order(buddy_t *buddy, size_t n, size_t first, size_t count) {
+	size_t end = first + count;
 	size_t index, lchild_index, rchild_index;
-	void *end = base + limit;
 
-	while (base < end) {
-		index = ((uintptr_t)base >> n) / PAGE_SIZE; // (base / 2^n) / PAGE_SIZE
+	while (first < end) {
+		index = first >> n;
 		lchild_index = index * 2;
 		rchild_index = lchild_index + 1;
 
-		if (KPM_IS_ALLOCATED(n - 1, lchild_index) || KPM_IS_ALLOCATED(n - 1, rchild_index))
-			KPM_ALLOC(n, index);
+		if (KPM_IS_ALLOCATED(buddy, n - 1, lchild_index) || KPM_IS_ALLOCATED(buddy, n - 1, rchild_index))
+			KPM_ALLOC(buddy, n, index);
 		else
-			KPM_FREE(n, index);
+			KPM_FREE(buddy, n, index);
+
+		first = (index + 1) << n;
+	}
+}
 
-		base = (void *)ALIGNNEXTFORCE(base, order_block_size);
+static void kpm_update(buddy_t *buddy, size_t first, size_t count) {
+	for (size_t n = 1; n < KPM_NORDERS; n++)
+		kpm_update_order(buddy, n, first, count);
+}
+
+/*
+ * Calls @fn on each part of the @n page frames starting at @pfn that
+ * belongs to a node, with the node and the part relative to its buddy.
+ */
+static void kpm_for_nodes(size_t pfn, size_t n, void (*fn)(struct kpm_node *, size_t, size_t)) {
+	struct numa_range *range;
+	size_t start, end;
+
+	for (int i = 0; i < numa_nranges; i++) {
+		range = numa_ranges + i;
+		start = pfn > range->start ? pfn : range->start;
+		end = pfn + n < range->end ? pfn + n : range->end;
+		if (start < end) {
+			struct kpm_node *node = kpm_nodes + range->node;
+			fn(node, start - node->buddy->base, end - start);
+		}
 	}
 }
 
+static void kpm_node_enable(struct kpm_node *node, size_t first, size_t count) {
+	buddy_t *buddy = node->buddy;
+
+	for (size_t i = first; i < first + count; i++) {
+		if (!KPM_IS_ENABLED(buddy, i) || KPM_IS_ALLOCATED(buddy, 0, i))
+			node->free++;
+		KPM_ENABLE(buddy, i);
+		KPM_FREE(buddy, 0, i);
+	}
+	kpm_update(buddy, first, count);
+}
+
+static void kpm_node_disable(struct kpm_node *node, size_t first, size_t count) {
+	buddy_t *buddy = node->buddy;
+
+	for (size_t i = first; i < first + count; i++) {
+		if (KPM_IS_ENABLED(buddy, i) && !KPM_IS_ALLOCATED(buddy, 0, i))
+			node->free--;
+		KPM_DISABLE(buddy, i);
+		KPM_ALLOC(buddy, 0, i);
+	}
+	kpm_update(buddy, first, count);
+}
+
+static void kpm_node_free(struct kpm_node *node, size_t first, size_t count) {
+	buddy_t *buddy = node->buddy;
+
+	for (size_t i = first; i < first + count; i++) {
+		if (KPM_IS_ENABLED(buddy, i) && KPM_IS_ALLOCATED(buddy, 0, i)) {
+			KPM_FREE(buddy, 0, i);
+			node->free++;
+		}
+	}
+	kpm_update(buddy, first, count);
+}
+
 /*
  * Set pageframes as available
  *
@@ -99,18 +226,7 @@ void kpm_enable(void *base, size_t limit) {
 	if (!ISALIGNED(base, PAGE_SIZE))
 		return;
 	limit = ALIGN(limit, PAGE_SIZE);
-
-	size_t base_index = (uintptr_t)base / PAGE_SIZE;
-	if ((uintptr_t)(base + limit) / PAGE_SIZE > buddy->nframes)
-		limit = (buddy->nframes * PAGE_SIZE) - (uintptr_t)base;
-
-	for (int i = 0; i < limit / PAGE_SIZE; i++) {
-		KPM_ENABLE(base_index + i);
-		KPM_FREE(0, base_index + i);
-	}
-
-	for (size_t n = 1; n < KPM_NORDERS; n++)
-		kpm_update_order(n, base, limit);
+	kpm_for_nodes((uintptr_t)base / PAGE_SIZE, limit / PAGE_SIZE, kpm_node_enable);
 }
 
 /*
@@ -125,18 +241,7 @@ void kpm_disable(void *base, size_t limit) {
 		return;
 	if (!ISALIGNED(limit, PAGE_SIZE))
 		limit = ALIGNNEXT(limit, PAGE_SIZE);
-
-	size_t base_index = (uintptr_t)base / PAGE_SIZE;
-	if ((uintptr_t)(base + limit) / PAGE_SIZE > buddy->nframes)
-		limit = (buddy->nframes * PAGE_SIZE) - (uintptr_t)base;
-
-	for (int i = 0; i < limit / PAGE_SIZE; i++) {
-		KPM_DISABLE(base_index + i);
-		KPM_ALLOC(0, base_index + i);
-	}
-
-	for (size_t n = 1; n < KPM_NORDERS; n++)
-		kpm_update_order(n, base, limit);
+	kpm_for_nodes((uintptr_t)base / PAGE_SIZE, limit / PAGE_SIZE, kpm_node_disable);
 }
 
 /*
@@ -148,7 +253,12 @@ void kpm_disable(void *base, size_t limit) {
  *
  */
 int kpm_isenabled(void *addr) {
-	return KPM_IS_ENABLED((uintptr_t)addr / PAGE_SIZE);
+	size_t pfn = (uintptr_t)addr / PAGE_SIZE;
+	int node = numa_node_of(pfn);
+
+	if (node < 0)
+		return 0;
+	return KPM_IS_ENABLED(kpm_nodes[node].buddy, pfn - kpm_nodes[node].buddy->base);
 }
 
 /*
@@ -161,7 +271,13 @@ int kpm_isenabled(void *addr) {
  *
  */
 int kpm_isalloc(void *addr) {
-	return KPM_IS_ALLOCATED(0, (uintptr_t)addr / PAGE_SIZE);
+	size_t pfn = (uintptr_t)addr / PAGE_SIZE;
+	int node = numa_node_of(pfn);
+
+	// Like disabled frames, frames out of any node are never free
+	if (node < 0)
+		return 1;
+	return KPM_IS_ALLOCATED(kpm_nodes[node].buddy, 0, pfn - kpm_nodes[node].buddy->base);
 }
 
 static int find_best_fit_order(size_t size) {
@@ -177,26 +293,42 @@ static int find_best_fit_order(size_t size) {
 }
 
 /*
- * Search for a bit set to 0 in a bitmap composed
- * of several words.
+ * Searches the biggest contiguous region, up to @size bytes, in the
+ * buddy allocator of @node.
  *
- * Returns the index of a bit set to 0 if found, 0 otherwise
+ * Returns 0 on success, -1 if the node has no free page frame
  */
-static int bitmap_ffu(bitmap_t *bitmap, size_t size) {
-	int ffu;
-
-	for (size_t i = 0; i < size; i++) {
-		bitmap_t cur = ~bitmap[i];
-		ffu = __builtin_ffs(cur);
-		if (ffu)
-			return ffu + (i * 8) - 1;
+static int kpm_node_alloc(struct kpm_node *node, kpm_chunk_t *chunk, size_t size) {
+	buddy_t *buddy = node->buddy;
+	size_t best_fit_order;
+	size_t base_index;
+	size_t frames_per_block;
+
+	if (node->free == 0)
+		return -1;
+	best_fit_order = find_best_fit_order(size);
+	for (int o = best_fit_order; o >= 0; o--) {
+		int i = bitmap_find_first_zero(buddy->orders[o].bitmap, buddy->nframes >> o);
+		if (i >= 0) {
+			frames_per_block = 1 << o;
+			base_index = i * frames_per_block;
+			bitmap_set(buddy->orders[0].bitmap, base_index, frames_per_block);
+			chunk->addr = (void *)((buddy->base + base_index) * PAGE_SIZE);
+			chunk->size = PAGE_SIZE * frames_per_block;
+			node->free -= frames_per_block;
+			kpm_update(buddy, base_index, frames_per_block);
+			return 0;
+		}
 	}
 	return -1;
 }
 
 /*
- * kpm_alloc searches for the biggest contiguous region, up to
+ * kpm_alloc_node searches for the biggest contiguous region, up to
  * @size bytes, and fills the struct @chunk with this candidate.
+ * The node @node is tried first, then the others from the nearest if
+ * kpm_policy allows it: a smaller region on @node is preferred to a
+ * bigger one elsewhere.
  *
  * Returns 0 on success, -1 on error
  *
@@ -204,43 +336,34 @@ static int bitmap_ffu(bitmap_t *bitmap, size_t size) {
  * is no contiguous block big enough. In this case, subsequent calls will
  * be needed to get the remaining chunks.
  */
-int kpm_alloc(kpm_chunk_t *chunk, size_t size) {
-	size_t best_fit_order;
-	size_t base_index;
-	size_t frames_per_block;
+int kpm_alloc_node(kpm_chunk_t *chunk, size_t size, int node) {
+	struct kpm_node *wanted = kpm_nodes + node;
+	struct kpm_node *other;
 
-	best_fit_order = find_best_fit_order(size);
-	for (int o = best_fit_order; o >= 0; o--) {
-		int i = bitmap_ffu(buddy->orders[o].bitmap, buddy->orders[o].size);
-		if (i >= 0) {
-			frames_per_block = 1 << o;
-			base_index = i * frames_per_block;
-			for (size_t j = 0; j < frames_per_block; j++)
-				KPM_ALLOC(0, base_index + j);
-			chunk->addr = (void *)(i * PAGE_SIZE * frames_per_block);
-			chunk->size = PAGE_SIZE * frames_per_block;
-			for (size_t n = 1; n < KPM_NORDERS; n++)
-				kpm_update_order(n, chunk->addr, chunk->size);
+	if (kpm_node_alloc(wanted, chunk, size) == 0) {
+		wanted->hits++;
+		return 0;
+	}
+	if (kpm_policy == KPM_BIND)
+		return -1;
+	for (int i = 1; i < numa_nnodes; i++) {
+		other = kpm_nodes + wanted->fallback[i];
+		if (kpm_node_alloc(other, chunk, size) == 0) {
+			wanted->foreign++;
+			other->misses++;
 			return 0;
 		}
 	}
 	return -1;
 }
 
-void kpm_free(kpm_chunk_t *chunk) {
-	size_t nframes;
-	size_t first_frame_index;
+int kpm_alloc(kpm_chunk_t *chunk, size_t size) {
+	return kpm_alloc_node(chunk, size, numa_node_id());
+}
 
+void kpm_free(kpm_chunk_t *chunk) {
 	if (!ISALIGNED(chunk->addr, PAGE_SIZE)) 
 		return;
-
-	first_frame_index = (uintptr_t)chunk->addr / PAGE_SIZE;
-	nframes = ALIGNNEXT(chunk->size, PAGE_SIZE) / PAGE_SIZE;
-	
-	for (size_t i = first_frame_index; i < first_frame_index + nframes; i++) {
-		if (KPM_IS_ENABLED(i))
-			KPM_FREE(0, i);
-	}
-	for (size_t n = 1; n < KPM_NORDERS; n++)
-		kpm_update_order(n, chunk->addr, chunk->size);
+	kpm_for_nodes((uintptr_t)chunk->addr / PAGE_SIZE, ALIGNNEXT(chunk->size, PAGE_SIZE) / PAGE_SIZE,
+		kpm_node_free);
 }
@@ -0,0 +1,223 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* kernel/memory/ksm.c
+ *
+ * Same page merging: identical anonymous pages share one read-only frame
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/ksm.h>
+#include <kernel/vmm.h>
+#include <kernel/tlb.h>
+#include <kernel/kpm.h>
+#include <kernel/kmap.h>
+#include <kernel/timer.h>
+#include <kernel/cpu.h>
+#include <kernel/string.h>
+
+/*
+ * A page seen by the scanner. Once another page has been merged into
+ * it, it is @stable and keeps its bucket.
+ */
+struct ksm_entry {
+	struct vmm_space *space;
+	uintptr_t va;
+	uintptr_t phys;
+	uint32_t hash;
+	int stable;
+};
+
+struct ksm_stats ksm_stats;
+uint32_t ksm_pages_to_scan = KSM_PAGES_PER_TICK;
+
+static struct ksm_entry ksm_table[KSM_NBUCKETS];
+static uintptr_t ksm_cursor;
+static uint32_t ksm_pass_sharing;
+
+static void ksm_tick() {
+	ksm_scan(ksm_pages_to_scan);
+}
+
+void ksm_init() {
+	timer_register(ksm_tick, 1);
+}
+
+/*
+ * FNV-1a over the words of a page
+ */
+static uint32_t ksm_hash(const uint32_t *page) {
+	uint32_t h = 2166136261U;
+
+	for (size_t i = 0; i < PAGE_SIZE / sizeof(uint32_t); i++) {
+		h ^= page[i];
+		h *= 16777619U;
+	}
+	return h;
+}
+
+/*
+ * Returns the page table entry of @entry if it still maps the frame it
+ * was recorded with, NULL otherwise.
+ */
+static struct page_table_entry *ksm_lookup(struct ksm_entry *entry) {
+	struct page_table_entry *pte;
+
+	if (entry->space != vmm_current)
+		return NULL;
+	pte = vmm_get_pte((void *)entry->va);
+	if (pte == NULL || !pte->present || ((uint32_t)pte->address << 12) != entry->phys)
+		return NULL;
+	return pte;
+}
+
+/*
+ * Compares two page frames through kmap slots, which unlike their own
+ * mappings leave the accessed bits alone.
+ */
+static int ksm_same(uintptr_t a, uintptr_t b) {
+	void *pa = kmap_atomic(PFN(a));
+	void *pb;
+	int ret;
+
+	// Without a free slot the pages are not merged
+	if (pa == NULL)
+		return 0;
+	if ((pb = kmap_atomic(PFN(b))) == NULL) {
+		kunmap_atomic(pa);
+		return 0;
+	}
+	ret = !memcmp(pa, pb, PAGE_SIZE);
+	kunmap_atomic(pb);
+	kunmap_atomic(pa);
+	return ret;
+}
+
+/*
+ * Write protects @pte, copy-on-write if it was writable, and marks it
+ * as a mapping of a merged frame.
+ */
+static void ksm_protect(struct page_table_entry *pte, uintptr_t va) {
+	if (pte->writable) {
+		pte->writable = 0;
+		pte->cow = 1;
+	}
+	pte->ksm = 1;
+	tlb_invlpg((void *)va);
+}
+
+/*
+ * Makes the page at @va, mapped by @pte, share the frame of @entry and
+ * frees its own frame.
+ */
+static void ksm_merge(struct page_table_entry *pte, uintptr_t va, struct ksm_entry *entry) {
+	uintptr_t phys = (uint32_t)pte->address << 12;
+	struct page_table_entry *epte;
+	kpm_chunk_t chunk;
+
+	// The reference count may be demand paged, and the fault may swap
+	// any of both pages out
+	vmm_page_share((void *)entry->phys);
+	if ((epte = ksm_lookup(entry)) == NULL || !pte->present || ((uint32_t)pte->address << 12) != phys) {
+		vmm_page_unshare((void *)entry->phys);
+		return;
+	}
+
+	ksm_protect(epte, entry->va);
+	pte->address = entry->phys >> 12;
+	ksm_protect(pte, va);
+	if (!vmm_page_unshare((void *)phys)) {
+		chunk.addr = (void *)phys;
+		chunk.size = PAGE_SIZE;
+		kpm_free(&chunk);
+	}
+	entry->stable = 1;
+	ksm_stats.merged++;
+}
+
+/*
+ * Looks for a page with the same content as the page at @va, merging
+ * them if there is one, otherwise remembers the page.
+ * Pages written since the previous pass are skipped: merging them would
+ * most likely be undone by the next write.
+ */
+static void ksm_scan_page(struct page_table_entry *pte, uintptr_t va) {
+	uintptr_t phys = (uint32_t)pte->address << 12;
+	struct ksm_entry *entry;
+	uint32_t *page;
+	uint32_t hash;
+
+	if (pte->dirty) {
+		pte->dirty = 0;
+		tlb_invlpg((void *)va);
+		return;
+	}
+	if ((page = kmap_atomic(pte->address)) == NULL)
+		return;
+	hash = ksm_hash(page);
+	kunmap_atomic(page);
+
+	entry = ksm_table + (hash & (KSM_NBUCKETS - 1));
+	if (entry->hash == hash && entry->phys != phys && ksm_lookup(entry) && ksm_same(entry->phys, phys)) {
+		ksm_merge(pte, va, entry);
+		return;
+	}
+	if (entry->stable && ksm_lookup(entry))
+		return;
+	entry->space = vmm_current;
+	entry->va = va;
+	entry->phys = phys;
+	entry->hash = hash;
+	entry->stable = 0;
+}
+
+/*
+ * Publishes the sharing statistics of the pass that just ended.
+ */
+static void ksm_end_pass() {
+	uint32_t shared = 0;
+
+	for (size_t i = 0; i < KSM_NBUCKETS; i++) {
+		if (!ksm_table[i].stable)
+			continue;
+		if (ksm_lookup(ksm_table + i))
+			shared++;
+		else
+			ksm_table[i].stable = 0;
+	}
+	ksm_stats.shared = shared;
+	ksm_stats.sharing = ksm_pass_sharing;
+	ksm_stats.full_scans++;
+	ksm_pass_sharing = 0;
+}
+
+void ksm_scan(size_t n) {
+	uint64_t start = rdtsc();
+	struct page_table_entry *pte;
+	uintptr_t va = ksm_cursor;
+	uintptr_t next;
+
+	while (n > 0) {
+		if ((next = vmm_next_anon(vmm_current, va)) == 0)
+			break;
+		if (next < va)
+			ksm_end_pass();
+		va = next;
+		n--;
+		if (!VMM_PAGE_DIRECTORY[PDE_INDEX(va)].present) {
+			va = ALIGNNEXTFORCE(va, PAGE_SIZE * PAGE_TABLE_LENGTH);
+			continue;
+		}
+		ksm_stats.scanned++;
+		pte = VMM_PAGE_TABLE(va) + PTE_INDEX(va);
+		if (pte->present && pte->ksm)
+			ksm_pass_sharing++;
+		else if (pte->present)
+			ksm_scan_page(pte, va);
+		va += PAGE_SIZE;
+	}
+	ksm_cursor = va;
+	ksm_stats.cycles += rdtsc() - start;
+}
@@ -0,0 +1,241 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* kernel/memory/lru.c
+ *
+ * Page aging with active/inactive lists, driven by the accessed bits
+ *
+ * Lists are only ever walked for the current address space, where page
+ * table entries are reachable. Descriptors are not removed when a page is
+ * unmapped: the walk drops those that no longer match their page table
+ * entry, and lru_add moves a frame that was on a list.
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/lru.h>
+#include <kernel/vmm.h>
+#include <kernel/kpm.h>
+#include <kernel/tlb.h>
+#include <kernel/timer.h>
+
+#define LRU_REF(pfn)		((uint32_t)(pfn) + 1)
+#define LRU_PAGE(ref)		(LRU_PAGES + (ref) - 1)
+#define LRU_VA(page)		ALIGN((page)->va, PAGE_SIZE)
+#define LRU_WHICH(page)		((page)->va & LRU_ACTIVE)
+
+/* Set while adopting pages, whose descriptors may fault and reclaim */
+static int lru_refilling;
+
+static void lru_tick() {
+	lru_refill(LRU_SCAN);
+	lru_scan(LRU_SCAN);
+}
+
+void lru_init() {
+	vmm_reserve(&kernel_space, LRU_PAGES, kpm_nframes * sizeof(struct lru_page), NULL, VMM_WRITE);
+	timer_register(lru_tick, LRU_PERIOD);
+}
+
+/*
+ * Returns the descriptor of the frame @ref, populating it first. This may
+ * fault, and the fault may reclaim, so it must be done before any list is
+ * touched.
+ */
+static struct lru_page *lru_get(uint32_t ref) {
+	struct lru_page *page = LRU_PAGE(ref);
+
+	(void)*(volatile uintptr_t *)&page->va;
+	return page;
+}
+
+static void lru_unlink(struct lru_page *page) {
+	struct lru_list *list = page->space->lru.lists + LRU_WHICH(page);
+
+	if (page->prev)
+		LRU_PAGE(page->prev)->next = page->next;
+	else
+		list->head = page->next;
+	if (page->next)
+		LRU_PAGE(page->next)->prev = page->prev;
+	else
+		list->tail = page->prev;
+	list->count--;
+	page->space = NULL;
+	page->prev = 0;
+	page->next = 0;
+}
+
+static void lru_link(struct vmm_space *space, struct lru_page *page, uint32_t ref, uintptr_t va, int which) {
+	struct lru_list *list = space->lru.lists + which;
+
+	page->space = space;
+	page->va = va | which;
+	page->prev = 0;
+	page->next = list->head;
+	if (list->head)
+		LRU_PAGE(list->head)->prev = ref;
+	else
+		list->tail = ref;
+	list->head = ref;
+	list->count++;
+}
+
+void lru_add(struct vmm_space *space, uintptr_t va, void *phys) {
+	uint32_t pfn = (uintptr_t)phys >> 12;
+	struct lru_page *page;
+
+	if (pfn >= kpm_nframes)
+		return;
+	page = lru_get(LRU_REF(pfn));
+	if (page->space)
+		lru_unlink(page);
+	lru_link(space, page, LRU_REF(pfn), va, LRU_ACTIVE);
+}
+
+void lru_drain(struct vmm_space *space) {
+	struct lru_page *page;
+	uint32_t ref;
+
+	for (int which = LRU_INACTIVE; which <= LRU_ACTIVE; which++) {
+		for (ref = space->lru.lists[which].head; ref;) {
+			page = LRU_PAGE(ref);
+			ref = page->next;
+			page->space = NULL;
+			page->prev = 0;
+			page->next = 0;
+		}
+		space->lru.lists[which].head = 0;
+		space->lru.lists[which].tail = 0;
+		space->lru.lists[which].count = 0;
+	}
+	space->lru.wss = 0;
+}
+
+/*
+ * Returns the page table entry mapping the frame @ref where its descriptor
+ * says it is, or NULL after dropping the stale descriptor.
+ */
+static struct page_table_entry *lru_check(struct lru_page *page, uint32_t ref) {
+	struct page_table_entry *pte = vmm_get_pte((void *)LRU_VA(page));
+
+	if (pte != NULL && pte->present && LRU_REF(pte->address) == ref)
+		return pte;
+	lru_unlink(page);
+	return NULL;
+}
+
+/*
+ * Moves the frame @ref to the head of the list its accessed bit calls for,
+ * clearing the bit.
+ * Returns 1 if the page was referenced
+ */
+static int lru_age(struct lru_page *page, struct page_table_entry *pte, uint32_t ref) {
+	struct vmm_lru *lru = &vmm_current->lru;
+	uintptr_t va = LRU_VA(page);
+	int accessed = pte->accessed;
+
+	lru_unlink(page);
+	if (accessed) {
+		pte->accessed = 0;
+		tlb_invlpg((void *)va);
+		lru->sweep_accessed++;
+	}
+	lru->sweep_seen++;
+	lru_link(vmm_current, page, ref, va, accessed ? LRU_ACTIVE : LRU_INACTIVE);
+	return accessed;
+}
+
+void lru_scan(size_t n) {
+	struct vmm_lru *lru = &vmm_current->lru;
+	struct page_table_entry *pte;
+	struct lru_page *page;
+	uint32_t ref;
+
+	for (int which = LRU_ACTIVE; which >= LRU_INACTIVE; which--) {
+		for (size_t i = 0; i < n && lru->lists[which].tail; i++) {
+			ref = lru->lists[which].tail;
+			page = LRU_PAGE(ref);
+			if ((pte = lru_check(page, ref)) != NULL)
+				lru_age(page, pte, ref);
+		}
+	}
+	// Every page has been looked at once since the last estimate
+	if (lru->sweep_seen >= lru->lists[LRU_ACTIVE].count + lru->lists[LRU_INACTIVE].count) {
+		lru->wss = lru->sweep_accessed;
+		lru->sweep_seen = 0;
+		lru->sweep_accessed = 0;
+	}
+}
+
+void lru_refill(size_t n) {
+	struct vmm_lru *lru = &vmm_current->lru;
+	struct page_table_entry *pte;
+	struct lru_page *page;
+	uintptr_t va = lru->hand;
+	uintptr_t next;
+	uint32_t ref;
+
+	lru_refilling = 1;
+	while (n > 0) {
+		if ((next = vmm_next_anon(vmm_current, va)) == 0)
+			break;
+		va = next;
+		n--;
+		if (!VMM_PAGE_DIRECTORY[PDE_INDEX(va)].present) {
+			va = ALIGNNEXTFORCE(va, PAGE_SIZE * PAGE_TABLE_LENGTH);
+			continue;
+		}
+		pte = VMM_PAGE_TABLE(va) + PTE_INDEX(va);
+		if (pte->present && pte->address < kpm_nframes) {
+			ref = LRU_REF(pte->address);
+			page = lru_get(ref);
+			// The page may have been evicted while populating
+			if (page->space == NULL && pte->present && LRU_REF(pte->address) == ref)
+				lru_link(vmm_current, page, ref, va, LRU_INACTIVE);
+		}
+		va += PAGE_SIZE;
+	}
+	lru->hand = va;
+	lru_refilling = 0;
+}
+
+struct page_table_entry *lru_victim(uintptr_t *va) {
+	struct vmm_lru *lru = &vmm_current->lru;
+	struct lru_list *inactive = lru->lists + LRU_INACTIVE;
+	struct page_table_entry *pte;
+	struct lru_page *page;
+	size_t budget;
+	int refilled = lru_refilling;
+	uint32_t ref;
+
+	budget = 2 * (inactive->count + lru->lists[LRU_ACTIVE].count + LRU_SCAN);
+	while (budget-- > 0) {
+		if (inactive->tail == 0) {
+			lru_scan(LRU_SCAN);
+			if (inactive->tail == 0 && !refilled) {
+				lru_refill(LRU_SCAN * LRU_SCAN);
+				refilled = 1;
+				budget += 2 * inactive->count;
+				continue;
+			}
+			if (inactive->tail == 0)
+				return NULL;
+		}
+		ref = inactive->tail;
+		page = LRU_PAGE(ref);
+		if ((pte = lru_check(page, ref)) == NULL || lru_age(page, pte, ref))
+			continue;
+		// Shared pages would not give any memory back, the refill walk
+		// adopts them again later
+		if (pte->cow || vmm_page_shares((void *)((uint32_t)pte->address << 12))) {
+			lru_unlink(page);
+			continue;
+		}
+		*va = LRU_VA(page);
+		lru_unlink(page);
+		return pte;
+	}
+	return NULL;
+}
@@ -0,0 +1,193 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* kernel/memory/numa.c
+ *
+ * Memory topology from the ACPI static resource affinity table (SRAT) and
+ * system locality information table (SLIT)
+ *
+ * Proximity domains are renumbered into nodes in the order their first
+ * memory range appears. Memory above 4GB and hot pluggable ranges are
+ * ignored.
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/numa.h>
+#include <kernel/acpi.h>
+#include <kernel/kpm.h>
+#include <kernel/cpu.h>
+
+#define SRAT_CPU			0
+#define SRAT_MEMORY			1
+
+#define SRAT_ENABLED		(1 << 0)
+#define SRAT_HOTPLUG		(1 << 1)
+
+#define NUMA_MAX_PFN		(1 << 20)
+
+struct srat {
+	struct acpi_header header;
+	uint32_t reserved1;
+	uint64_t reserved2;
+} __attribute__((packed));
+
+struct srat_entry {
+	uint8_t type;
+	uint8_t length;
+} __attribute__((packed));
+
+struct srat_cpu {
+	struct srat_entry entry;
+	uint8_t domain_low;
+	uint8_t apic_id;
+	uint32_t flags;
+	uint8_t sapic_eid;
+	uint8_t domain_high[3];
+	uint32_t clock_domain;
+} __attribute__((packed));
+
+struct srat_memory {
+	struct srat_entry entry;
+	uint32_t domain;
+	uint16_t reserved1;
+	uint64_t base;
+	uint64_t length;
+	uint32_t reserved2;
+	uint32_t flags;
+	uint64_t reserved3;
+} __attribute__((packed));
+
+struct slit {
+	struct acpi_header header;
+	uint64_t nlocalities;
+	uint8_t distance[];
+} __attribute__((packed));
+
+struct numa_range numa_ranges[NUMA_MAX_RANGES];
+int numa_nranges;
+int numa_nnodes;
+uint8_t numa_distance[NUMA_MAX_NODES][NUMA_MAX_NODES];
+int numa_cpu_node;
+
+/* Proximity domain of each node */
+static uint32_t numa_domains[NUMA_MAX_NODES];
+
+/*
+ * Returns the node of the proximity domain @domain, creating it if
+ * @create is set.
+ * Returns -1 if there is no such node
+ */
+static int numa_domain_node(uint32_t domain, int create) {
+	for (int node = 0; node < numa_nnodes; node++) {
+		if (numa_domains[node] == domain)
+			return node;
+	}
+	if (!create || numa_nnodes == NUMA_MAX_NODES)
+		return -1;
+	numa_domains[numa_nnodes] = domain;
+	return numa_nnodes++;
+}
+
+static void numa_add_memory(struct srat_memory *mem) {
+	uint64_t start = (mem->base + PAGE_SIZE - 1) >> 12;
+	uint64_t end = (mem->base + mem->length) >> 12;
+	struct numa_range *range;
+	int node;
+
+	if (!(mem->flags & SRAT_ENABLED) || (mem->flags & SRAT_HOTPLUG))
+		return;
+	if (end > NUMA_MAX_PFN)
+		end = NUMA_MAX_PFN;
+	if (start >= end || numa_nranges == NUMA_MAX_RANGES)
+		return;
+	if ((node = numa_domain_node(mem->domain, 1)) < 0)
+		return;
+	range = numa_ranges + numa_nranges++;
+	range->start = start;
+	range->end = end;
+	range->node = node;
+}
+
+/*
+ * Records the memory ranges and finds the domain of the current cpu.
+ * Returns the domain of the current cpu, or -1 if it is not listed
+ */
+static int64_t numa_parse_srat(struct srat *srat) {
+	uint8_t apic_id = cpu_apic_id();
+	int64_t cpu_domain = -1;
+	struct srat_entry *entry;
+	struct srat_cpu *cpu;
+	void *end = (void *)srat + srat->header.length;
+
+	for (void *ptr = srat + 1; ptr + sizeof(*entry) <= end; ptr += entry->length) {
+		entry = ptr;
+		if (entry->length < sizeof(*entry) || ptr + entry->length > end)
+			break;
+		if (entry->type == SRAT_MEMORY && entry->length >= sizeof(struct srat_memory)) {
+			numa_add_memory(ptr);
+		} else if (entry->type == SRAT_CPU && entry->length >= sizeof(struct srat_cpu)) {
+			cpu = ptr;
+			if ((cpu->flags & SRAT_ENABLED) && cpu->apic_id == apic_id)
+				cpu_domain = cpu->domain_low | cpu->domain_high[0] << 8
+					| cpu->domain_high[1] << 16 | cpu->domain_high[2] << 24;
+		}
+	}
+	return cpu_domain;
+}
+
+/*
+ * Fills the distances between nodes from the SLIT, whose localities are
+ * the proximity domains.
+ */
+static void numa_parse_slit(struct slit *slit) {
+	uint64_t n = slit->nlocalities;
+
+	if (sizeof(*slit) + n * n > slit->header.length)
+		return;
+	for (int i = 0; i < numa_nnodes; i++) {
+		for (int j = 0; j < numa_nnodes; j++) {
+			if (numa_domains[i] < n && numa_domains[j] < n)
+				numa_distance[i][j] = slit->distance[numa_domains[i] * n + numa_domains[j]];
+		}
+	}
+}
+
+void numa_init(size_t nframes) {
+	struct acpi_header *table;
+	int64_t cpu_domain = -1;
+	int node;
+
+	numa_nranges = 0;
+	numa_nnodes = 0;
+	numa_cpu_node = 0;
+	if ((table = acpi_find("SRAT")) != NULL)
+		cpu_domain = numa_parse_srat((struct srat *)table);
+
+	if (numa_nranges == 0) {
+		numa_nnodes = 1;
+		numa_nranges = 1;
+		numa_ranges[0].start = 0;
+		numa_ranges[0].end = nframes;
+		numa_ranges[0].node = 0;
+	} else if (cpu_domain >= 0 && (node = numa_domain_node(cpu_domain, 0)) >= 0) {
+		numa_cpu_node = node;
+	}
+
+	for (int i = 0; i < numa_nnodes; i++) {
+		for (int j = 0; j < numa_nnodes; j++)
+			numa_distance[i][j] = i == j ? NUMA_LOCAL_DISTANCE : NUMA_REMOTE_DISTANCE;
+	}
+	if (numa_nnodes > 1 && (table = acpi_find("SLIT")) != NULL)
+		numa_parse_slit((struct slit *)table);
+	acpi_done();
+}
+
+int numa_node_of(uint32_t pfn) {
+	for (int i = 0; i < numa_nranges; i++) {
+		if (pfn >= numa_ranges[i].start && pfn < numa_ranges[i].end)
+			return numa_ranges[i].node;
+	}
+	return -1;
+}
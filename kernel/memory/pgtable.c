@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* kernel/memory/pgtable.c
+ *
+ * Quicklist of zeroed page frames for paging structures
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/pgtable.h>
+#include <kernel/paging.h>
+#include <kernel/kmap.h>
+#include <kernel/timer.h>
+#include <kernel/fpu.h>
+
+struct pgtable_stats pgtable_stats;
+
+static void *pgtable_quicklist[PGTABLE_MAX];
+static int pgtable_count;
+
+/*
+ * Zeroes frames ahead of time, so that page table allocations do not
+ * have to. They are not used right away: they are zeroed without going
+ * through the cache.
+ */
+static void pgtable_refill() {
+	kpm_chunk_t chunk;
+	void *table;
+
+	while (pgtable_count < PGTABLE_LOW && kpm_alloc(&chunk, PAGE_SIZE) == 0) {
+		if ((table = kmap_atomic(PFN(chunk.addr))) == NULL) {
+			kpm_free(&chunk);
+			return;
+		}
+		clear_page(table);
+		kunmap_atomic(table);
+		pgtable_quicklist[pgtable_count++] = chunk.addr;
+		pgtable_stats.refilled++;
+	}
+}
+
+void pgtable_init() {
+	timer_register(pgtable_refill, PGTABLE_PERIOD);
+}
+
+int pgtable_alloc(kpm_chunk_t *chunk) {
+	if (pgtable_count > 0) {
+		chunk->addr = pgtable_quicklist[--pgtable_count];
+		chunk->size = PAGE_SIZE;
+		pgtable_stats.hits++;
+		return 1;
+	}
+	pgtable_stats.misses++;
+	return kpm_alloc(chunk, PAGE_SIZE) < 0 ? -1 : 0;
+}
+
+void pgtable_free(void *phys) {
+	kpm_chunk_t chunk;
+
+	if (pgtable_count < PGTABLE_MAX) {
+		pgtable_quicklist[pgtable_count++] = phys;
+		pgtable_stats.recycled++;
+		return;
+	}
+	chunk.addr = phys;
+	chunk.size = PAGE_SIZE;
+	kpm_free(&chunk);
+	pgtable_stats.released++;
+}
+
+int pgtable_shrink() {
+	kpm_chunk_t chunk;
+	int n = pgtable_count;
+
+	chunk.size = PAGE_SIZE;
+	while (pgtable_count > 0) {
+		chunk.addr = pgtable_quicklist[--pgtable_count];
+		kpm_free(&chunk);
+	}
+	pgtable_stats.released += n;
+	return n;
+}
+
+int pgtable_cached() {
+	return pgtable_count;
+}
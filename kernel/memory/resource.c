@@ -0,0 +1,205 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* kernel/memory/resource.c
+ *
+ * Physical address space resource tree
+ *
+ * Lookups do not walk the tree: it is flattened, after each insertion,
+ * into a sorted array of spans giving the innermost resource from their
+ * start to the start of the next one, which is binary searched.
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/resource.h>
+#include <kernel/kernel.h>
+#include <kernel/kpm.h>
+
+#define RESOURCE_VGA_START	0xA0000
+#define RESOURCE_VGA_END	0xBFFFF
+
+struct resource_span {
+	uint32_t start;
+	struct resource *res;
+};
+
+struct resource iomem_resource = {
+	.start = 0,
+	.end = 0xFFFFFFFF,
+	.name = "PCI mem",
+};
+
+static struct resource resource_pool[RESOURCE_MAX];
+static size_t resource_npool;
+static size_t resource_count;
+
+static struct resource_span resource_spans[RESOURCE_MAX_SPANS];
+static size_t resource_nspans;
+
+extern uint32_t sk;
+extern uint32_t ek;
+
+static void resource_emit(uint32_t start, struct resource *res) {
+	if (resource_nspans > 0 && resource_spans[resource_nspans - 1].start == start) {
+		resource_spans[resource_nspans - 1].res = res;
+		return;
+	}
+	resource_spans[resource_nspans].start = start;
+	resource_spans[resource_nspans].res = res;
+	resource_nspans++;
+}
+
+/*
+ * Emits the spans of @res and of its children, in address order.
+ */
+static void resource_flatten(struct resource *res) {
+	resource_emit(res->start, res);
+	for (struct resource *child = res->child; child; child = child->sibling) {
+		resource_flatten(child);
+		if (child->end < res->end)
+			resource_emit(child->end + 1, res);
+	}
+}
+
+int resource_insert(struct resource *res) {
+	struct resource *parent = &iomem_resource;
+	struct resource **link;
+	struct resource *first, *last, *child;
+
+	// Every resource adds at most two spans
+	if (res->start > res->end || 2 * (resource_count + 1) + 1 > RESOURCE_MAX_SPANS)
+		return -1;
+	// Go down to the innermost resource containing @res
+	for (child = parent->child; child;) {
+		if (child->start <= res->start && child->end >= res->end) {
+			parent = child;
+			child = child->child;
+		} else {
+			child = child->sibling;
+		}
+	}
+	link = &parent->child;
+	while (*link && (*link)->end < res->start)
+		link = &(*link)->sibling;
+	// Siblings overlapping @res must fit in it, they are moved under it
+	first = *link;
+	last = NULL;
+	for (child = first; child && child->start <= res->end; child = child->sibling) {
+		if (child->start < res->start || child->end > res->end)
+			return -1;
+		last = child;
+	}
+	res->child = NULL;
+	if (last) {
+		res->child = first;
+		*link = last->sibling;
+		last->sibling = NULL;
+		for (child = first; child; child = child->sibling)
+			child->parent = res;
+	}
+	res->parent = parent;
+	res->sibling = *link;
+	*link = res;
+	resource_count++;
+
+	resource_nspans = 0;
+	resource_flatten(&iomem_resource);
+	return 0;
+}
+
+/*
+ * Inserts a resource from the pool.
+ */
+static void resource_add(uint32_t start, uint32_t end, const char *name, uint32_t flags) {
+	struct resource *res;
+
+	if (resource_npool == RESOURCE_MAX)
+		return;
+	res = resource_pool + resource_npool;
+	res->start = start;
+	res->end = end;
+	res->name = name;
+	res->flags = flags;
+	if (resource_insert(res) == 0)
+		resource_npool++;
+}
+
+void resource_init(struct multiboot_mmap_entry *entries, size_t n) {
+	struct multiboot_mmap_entry *entry;
+	uint64_t end;
+
+	resource_nspans = 0;
+	resource_flatten(&iomem_resource);
+	for (size_t i = 0; i < n; i++) {
+		entry = entries + i;
+		if (entry->len == 0 || entry->addr > 0xFFFFFFFF)
+			continue;
+		end = entry->addr + entry->len - 1;
+		if (end > 0xFFFFFFFF)
+			end = 0xFFFFFFFF;
+		switch (entry->type) {
+		case MULTIBOOT_MEMORY_AVAILABLE:
+			resource_add(entry->addr, end, "System RAM", RESOURCE_RAM);
+			break;
+		case MULTIBOOT_MEMORY_ACPI_RECLAIMABLE:
+			resource_add(entry->addr, end, "ACPI Tables", RESOURCE_RESERVED);
+			break;
+		case MULTIBOOT_MEMORY_NVS:
+			resource_add(entry->addr, end, "ACPI Non-volatile Storage", RESOURCE_RESERVED);
+			break;
+		case MULTIBOOT_MEMORY_BADRAM:
+			resource_add(entry->addr, end, "Bad RAM", RESOURCE_RESERVED | RESOURCE_BUSY);
+			break;
+		default:
+			resource_add(entry->addr, end, "Reserved", RESOURCE_RESERVED);
+			break;
+		}
+	}
+	resource_add(RESOURCE_VGA_START, RESOURCE_VGA_END, "Video RAM area", RESOURCE_DEVICE);
+	resource_add((uintptr_t)&sk, (uintptr_t)&ek - KERNEL_VIRT_OFFSET - 1, "Kernel image",
+		RESOURCE_RAM | RESOURCE_BUSY);
+}
+
+/*
+ * Returns the index of the span containing @addr
+ */
+static size_t resource_span_of(uint32_t addr) {
+	size_t low = 0;
+	size_t high = resource_nspans;
+	size_t mid;
+
+	// The first span starts at 0: the last span starting at or before
+	// @addr always exists
+	while (high - low > 1) {
+		mid = low + (high - low) / 2;
+		if (resource_spans[mid].start <= addr)
+			low = mid;
+		else
+			high = mid;
+	}
+	return low;
+}
+
+struct resource *resource_find(uint32_t addr) {
+	struct resource *res = resource_spans[resource_span_of(addr)].res;
+
+	return res == &iomem_resource ? NULL : res;
+}
+
+int resource_check(uint32_t start, size_t size, uint32_t flags) {
+	uint32_t last = start + size - 1;
+
+	if (size == 0)
+		return 1;
+	if (last < start)
+		return 0;
+	for (size_t i = resource_span_of(start); i < resource_nspans; i++) {
+		if (resource_spans[i].start > last)
+			break;
+		if (!(resource_spans[i].res->flags & flags))
+			return 0;
+	}
+	return 1;
+}
@@ -0,0 +1,47 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* kernel/memory/rtheap.c
+ *
+ * Real-time kernel heap, a TLSF allocator over a pool mapped at boot
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/tlsf.h>
+#include <kernel/vmalloc.h>
+#include <kernel/kpm.h>
+#include <kernel/cpu.h>
+
+struct tlsf rtheap;
+
+void rtheap_init() {
+	kpm_chunk_t chunk;
+	void *pool;
+
+	// Without a pool every allocation fails, as the heap has no free block.
+	// kpm may give less than asked for, the pool is what it gave
+	if (kpm_alloc(&chunk, RTHEAP_SIZE) < 0)
+		return;
+	if ((pool = vmap(&chunk, 1)) == NULL) {
+		kpm_free(&chunk);
+		return;
+	}
+	tlsf_create(&rtheap, pool, chunk.size);
+}
+
+void *rt_malloc(size_t size) {
+	uint32_t flags = cpu_irq_save();
+	void *ptr = tlsf_malloc(&rtheap, size);
+
+	cpu_irq_restore(flags);
+	return ptr;
+}
+
+void rt_free(void *ptr) {
+	uint32_t flags = cpu_irq_save();
+
+	tlsf_free(&rtheap, ptr);
+	cpu_irq_restore(flags);
+}
@@ -0,0 +1,339 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* kernel/memory/slab.c
+ *
+ * Slab allocator of typed object caches, and kmalloc on top of it
+ *
+ * Free objects of a slab are chained through an array of indexes stored
+ * after the slab descriptor, objects themselves are never written by the
+ * allocator so that they keep the state their constructor gave them.
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/slab.h>
+#include <kernel/vmm.h>
+#include <kernel/vmalloc.h>
+#include <kernel/tlb.h>
+#include <kernel/kpm.h>
+#include <kernel/cpu.h>
+
+#define SLAB_NPAGES			(SLAB_AREA_SIZE / PAGE_SIZE)
+#define SLAB_NEXT(slab)		((uint16_t *)((slab) + 1))
+
+/* Offset of the first object in a slab of @n objects aligned on @align */
+#define SLAB_OBJECTS(n, align)	ALIGNNEXT(sizeof(struct slab) + (n) * sizeof(uint16_t), align)
+
+#define SLAB_PAGE_USED(pg)	(slab_pages[(pg) / 32] & (1U << ((pg) % 32)))
+
+struct kmem_cache slab_caches[SLAB_MAX_CACHES];
+int slab_ncaches;
+
+static struct kmem_cache *kmalloc_caches[KMALLOC_MAX_SHIFT + 1];
+static const char *kmalloc_names[KMALLOC_MAX_SHIFT + 1] = {
+	[3] = "kmalloc-8",
+	[4] = "kmalloc-16",
+	[5] = "kmalloc-32",
+	[6] = "kmalloc-64",
+	[7] = "kmalloc-128",
+	[8] = "kmalloc-256",
+	[9] = "kmalloc-512",
+	[10] = "kmalloc-1024",
+	[11] = "kmalloc-2048",
+};
+
+/* One bit per page of the area, set when it belongs to a slab */
+static uint32_t slab_pages[SLAB_NPAGES / 32];
+
+/* Offset of each page from the first page of its slab */
+static uint8_t slab_page_offset[SLAB_NPAGES];
+
+void slab_init() {
+	struct tlb_gather tlb;
+
+	// Like the zram pool, the page tables of the area are created once so
+	// that growing a cache only needs page frames
+	tlb_gather_init(&tlb);
+	for (uintptr_t va = SLAB_AREA; va < SLAB_AREA + SLAB_AREA_SIZE; va += PAGE_SIZE * PAGE_TABLE_LENGTH) {
+		vmm_map((void *)va, 0, 0);
+		vmm_unmap(&tlb, (void *)va, PAGE_SIZE);
+	}
+	tlb_finish(&tlb);
+
+	for (int shift = KMALLOC_MIN_SHIFT; shift <= KMALLOC_MAX_SHIFT; shift++)
+		kmalloc_caches[shift] = kmem_cache_create(kmalloc_names[shift], 1 << shift, 0, SLAB_HWCACHE_ALIGN, NULL);
+}
+
+/*
+ * Returns the number of objects of @size bytes aligned on @align that fit
+ * in a slab of order @order
+ */
+static uint32_t slab_nobjs(size_t size, size_t align, uint32_t order) {
+	size_t slab_size = PAGE_SIZE << order;
+	uint32_t n = (slab_size - sizeof(struct slab)) / (size + sizeof(uint16_t));
+
+	if (n >= SLAB_NONE)
+		n = SLAB_NONE - 1;
+	while (n > 0 && SLAB_OBJECTS(n, align) + n * size > slab_size)
+		n--;
+	return n;
+}
+
+struct kmem_cache *kmem_cache_create(const char *name, size_t size, size_t align, int flags,
+	void (*ctor)(void *)) {
+	struct kmem_cache *cache;
+	uint32_t line, order, nobjs;
+	size_t slab_size;
+
+	if (slab_ncaches == SLAB_MAX_CACHES || size == 0)
+		return NULL;
+	if (align < sizeof(void *))
+		align = sizeof(void *);
+	if (flags & SLAB_HWCACHE_ALIGN) {
+		// Small objects share lines, but never straddle two of them
+		for (line = cpu_cache_line(); line / 2 >= size; line /= 2)
+			;
+		if (line > align)
+			align = line;
+	}
+	size = ALIGNNEXT(size, align);
+
+	// Smallest slab leaving at most an eighth of itself unused
+	for (order = 0;; order++) {
+		nobjs = slab_nobjs(size, align, order);
+		slab_size = PAGE_SIZE << order;
+		if (order == SLAB_MAX_ORDER
+			|| (nobjs && (slab_size - SLAB_OBJECTS(nobjs, align) - nobjs * size) * 8 <= slab_size))
+			break;
+	}
+	if (nobjs == 0)
+		return NULL;
+
+	cache = slab_caches + slab_ncaches++;
+	cache->name = name;
+	cache->size = size;
+	cache->align = align;
+	cache->ctor = ctor;
+	cache->order = order;
+	cache->objs_per_slab = nobjs;
+	cache->partial = NULL;
+	cache->full = NULL;
+	cache->empty = NULL;
+	cache->nslabs = 0;
+	cache->nempty = 0;
+	cache->active = 0;
+	cache->allocs = 0;
+	cache->hits = 0;
+	cache->frees = 0;
+	return cache;
+}
+
+/*
+ * Returns the list @slab belongs on, given its objects in use
+ */
+static struct slab **slab_list(struct kmem_cache *cache, struct slab *slab) {
+	if (slab->inuse == 0)
+		return &cache->empty;
+	if (slab->inuse == cache->objs_per_slab)
+		return &cache->full;
+	return &cache->partial;
+}
+
+static void slab_link(struct slab **list, struct slab *slab) {
+	slab->prev = NULL;
+	slab->next = *list;
+	if (*list)
+		(*list)->prev = slab;
+	*list = slab;
+}
+
+static void slab_unlink(struct slab **list, struct slab *slab) {
+	if (slab->prev)
+		slab->prev->next = slab->next;
+	else
+		*list = slab->next;
+	if (slab->next)
+		slab->next->prev = slab->prev;
+}
+
+/*
+ * Finds 2^@order free pages of the area, aligned on their size.
+ * Returns the first page, or -1 if the area is full
+ */
+static int slab_get_pages(uint32_t order) {
+	uint32_t n = 1 << order;
+	uint32_t i;
+
+	for (uint32_t pg = 0; pg < SLAB_NPAGES; pg += n) {
+		for (i = 0; i < n && !SLAB_PAGE_USED(pg + i); i++)
+			;
+		if (i < n)
+			continue;
+		for (i = 0; i < n; i++) {
+			slab_pages[(pg + i) / 32] |= 1U << ((pg + i) % 32);
+			slab_page_offset[pg + i] = i;
+		}
+		return pg;
+	}
+	return -1;
+}
+
+/*
+ * Unmaps the @n pages starting at @pg and gives their frames back to kpm.
+ */
+static void slab_put_pages(uint32_t pg, uint32_t n) {
+	struct tlb_gather tlb;
+
+	tlb_gather_init(&tlb);
+	vmm_zap(&tlb, (void *)(SLAB_AREA + pg * PAGE_SIZE), n * PAGE_SIZE);
+	tlb_finish(&tlb);
+	for (uint32_t i = 0; i < n; i++)
+		slab_pages[(pg + i) / 32] &= ~(1U << ((pg + i) % 32));
+}
+
+/*
+ * Creates an empty slab for @cache, with constructed objects.
+ * Returns the slab, or NULL when out of memory
+ */
+static struct slab *slab_grow(struct kmem_cache *cache) {
+	uint32_t n = 1 << cache->order;
+	kpm_chunk_t chunk;
+	struct slab *slab;
+	uintptr_t va;
+	int pg;
+
+	if ((pg = slab_get_pages(cache->order)) < 0)
+		return NULL;
+	va = SLAB_AREA + pg * PAGE_SIZE;
+	for (uint32_t i = 0; i < n; i++) {
+		if (kpm_alloc(&chunk, PAGE_SIZE) < 0) {
+			slab_put_pages(pg, n);
+			return NULL;
+		}
+		if (vmm_map((void *)(va + i * PAGE_SIZE), chunk.addr, VMM_WRITE) < 0) {
+			kpm_free(&chunk);
+			slab_put_pages(pg, n);
+			return NULL;
+		}
+	}
+
+	slab = (struct slab *)va;
+	slab->cache = cache;
+	slab->objects = (void *)(va + SLAB_OBJECTS(cache->objs_per_slab, cache->align));
+	slab->free = 0;
+	slab->inuse = 0;
+	for (uint32_t i = 0; i < cache->objs_per_slab; i++) {
+		SLAB_NEXT(slab)[i] = i + 1 < cache->objs_per_slab ? i + 1 : SLAB_NONE;
+		if (cache->ctor)
+			cache->ctor(slab->objects + i * cache->size);
+	}
+	slab_link(&cache->empty, slab);
+	cache->nempty++;
+	cache->nslabs++;
+	return slab;
+}
+
+/*
+ * Gives the empty slab @slab of @cache back to kpm.
+ */
+static void slab_destroy(struct kmem_cache *cache, struct slab *slab) {
+	slab_unlink(&cache->empty, slab);
+	cache->nempty--;
+	cache->nslabs--;
+	slab_put_pages(((uintptr_t)slab - SLAB_AREA) / PAGE_SIZE, 1 << cache->order);
+}
+
+/*
+ * Returns the slab containing @obj, or NULL if it is not in a slab
+ */
+static struct slab *slab_of(void *obj) {
+	uintptr_t addr = (uintptr_t)obj;
+	uint32_t pg;
+
+	if (addr < SLAB_AREA || addr >= SLAB_AREA + SLAB_AREA_SIZE)
+		return NULL;
+	pg = (addr - SLAB_AREA) / PAGE_SIZE;
+	if (!SLAB_PAGE_USED(pg))
+		return NULL;
+	return (struct slab *)(SLAB_AREA + (pg - slab_page_offset[pg]) * PAGE_SIZE);
+}
+
+void *kmem_cache_alloc(struct kmem_cache *cache) {
+	struct slab *slab = cache->partial ? cache->partial : cache->empty;
+	void *obj;
+
+	cache->allocs++;
+	if (slab != NULL)
+		cache->hits++;
+	else if ((slab = slab_grow(cache)) == NULL)
+		return NULL;
+
+	if (slab->inuse == 0)
+		cache->nempty--;
+	slab_unlink(slab_list(cache, slab), slab);
+	obj = slab->objects + slab->free * cache->size;
+	slab->free = SLAB_NEXT(slab)[slab->free];
+	slab->inuse++;
+	slab_link(slab_list(cache, slab), slab);
+	cache->active++;
+	return obj;
+}
+
+void kmem_cache_free(struct kmem_cache *cache, void *obj) {
+	struct slab *slab = slab_of(obj);
+	uint32_t index;
+
+	if (slab == NULL || slab->cache != cache || slab->inuse == 0)
+		return;
+	index = (obj - slab->objects) / cache->size;
+	slab_unlink(slab_list(cache, slab), slab);
+	SLAB_NEXT(slab)[index] = slab->free;
+	slab->free = index;
+	slab->inuse--;
+	slab_link(slab_list(cache, slab), slab);
+	cache->active--;
+	cache->frees++;
+	if (slab->inuse == 0 && ++cache->nempty > SLAB_KEEP_EMPTY)
+		slab_destroy(cache, slab);
+}
+
+size_t slab_shrink() {
+	struct kmem_cache *cache;
+	size_t released = 0;
+
+	for (int i = 0; i < slab_ncaches; i++) {
+		cache = slab_caches + i;
+		while (cache->empty) {
+			released += 1 << cache->order;
+			slab_destroy(cache, cache->empty);
+		}
+	}
+	return released;
+}
+
+void *kmalloc(size_t size) {
+	int shift = KMALLOC_MIN_SHIFT;
+
+	if (size == 0)
+		return NULL;
+	if (size > KMALLOC_MAX_SIZE)
+		return vmalloc(size);
+	if (size > (1 << KMALLOC_MIN_SHIFT))
+		shift = 32 - __builtin_clz(size - 1);
+	return kmem_cache_alloc(kmalloc_caches[shift]);
+}
+
+void kfree(void *ptr) {
+	struct slab *slab;
+
+	if (ptr == NULL)
+		return;
+	if ((uintptr_t)ptr >= VMALLOC_START && (uintptr_t)ptr < VMALLOC_END) {
+		vfree(ptr);
+		return;
+	}
+	if ((slab = slab_of(ptr)) != NULL)
+		kmem_cache_free(slab->cache, ptr);
+}
@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* kernel/memory/swap.c
+ *
+ * Eviction of anonymous pages to the compressed store
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/vmm.h>
+#include <kernel/tlb.h>
+#include <kernel/kpm.h>
+#include <kernel/zram.h>
+#include <kernel/lru.h>
+
+/*
+ * Evicts the coldest anonymous page of the current address space to zram,
+ * its page table entry becoming a swap entry that holds the zram handle.
+ * Pages that do not compress well are left in place and the next
+ * candidate is tried.
+ *
+ * Returns 0 if a page was evicted, -1 otherwise
+ */
+int vmm_swap_out() {
+	struct page_table_entry *pte;
+	kpm_chunk_t chunk;
+	uintptr_t page;
+	int handle;
+
+	for (int tries = 0; tries < VMM_SWAP_TRIES; tries++) {
+		if ((pte = lru_victim(&page)) == NULL)
+			return -1;
+		chunk.addr = (void *)((uint32_t)pte->address << 12);
+		chunk.size = PAGE_SIZE;
+		// zram may reuse the frame for its pool: nothing touches @page
+		// until the entry is replaced below
+		if ((handle = zram_store((void *)page, &chunk)) < 0) {
+			lru_add(vmm_current, page, chunk.addr);
+			continue;
+		}
+		page_clear((struct page_entry *)pte);
+		pte->swap = 1;
+		pte->address = handle;
+		tlb_invlpg((void *)page);
+		if (chunk.size)
+			kpm_free(&chunk);
+		vmm_fault_stats.swapped_out++;
+		return 0;
+	}
+	return -1;
+}
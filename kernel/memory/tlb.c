@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* kernel/memory/tlb.c
+ *
+ * Batched TLB invalidation (mmu_gather)
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/tlb.h>
+#include <kernel/kpm.h>
+#include <kernel/pgtable.h>
+
+/*
+ * Number of pages above which tlb_flush reloads cr3 instead of
+ * invalidating every page. Tunable at runtime.
+ */
+size_t tlb_flush_ceiling = TLB_DFL_FLUSH_CEILING;
+
+struct tlb_stats tlb_stats;
+
+/*
+ * Initializes an empty gather, must be called before any unmap.
+ */
+void tlb_gather_init(struct tlb_gather *tlb) {
+	tlb->nranges = 0;
+	tlb->npages = 0;
+	tlb->flush_all = 0;
+	tlb->ntables = 0;
+	tlb->npages_freed = 0;
+}
+
+/*
+ * Records that [@virt, @virt + @size) has been unmapped.
+ * The range is merged with the last one if they are contiguous, and if
+ * there is no room left, the gather falls back to a full flush.
+ */
+void tlb_gather_range(struct tlb_gather *tlb, void *virt, size_t size) {
+	uintptr_t start = ALIGN(virt, PAGE_SIZE);
+	uintptr_t end = ALIGNNEXT((uintptr_t)virt + size, PAGE_SIZE);
+	struct tlb_range *last;
+
+	if (start >= end)
+		return;
+	tlb->npages += (end - start) / PAGE_SIZE;
+	if (tlb->flush_all)
+		return;
+
+	if (tlb->nranges > 0) {
+		last = &tlb->ranges[tlb->nranges - 1];
+		if (last->end == start) {
+			last->end = end;
+			return;
+		}
+	}
+	if (tlb->nranges == TLB_NRANGES) {
+		tlb->flush_all = 1;
+		return;
+	}
+	tlb->ranges[tlb->nranges].start = start;
+	tlb->ranges[tlb->nranges].end = end;
+	tlb->nranges++;
+}
+
+/*
+ * Queues the page table frame @phys to be released once the TLB has been
+ * flushed. If the batch is full, it is flushed right away.
+ */
+void tlb_gather_table(struct tlb_gather *tlb, void *phys) {
+	if (tlb->ntables == TLB_NTABLES)
+		tlb_flush(tlb);
+	tlb->tables[tlb->ntables++] = phys;
+}
+
+/*
+ * Queues the page frame @phys to be released once the TLB has been
+ * flushed, so that it cannot be reused while a stale translation exists.
+ */
+void tlb_gather_page(struct tlb_gather *tlb, void *phys) {
+	if (tlb->npages_freed == TLB_NPAGES)
+		tlb_flush(tlb);
+	tlb->pages[tlb->npages_freed++] = phys;
+}
+
+/*
+ * Invalidates every gathered range, either page by page or with a single
+ * cr3 reload depending on tlb_flush_ceiling, then frees the queued page
+ * tables, which are empty and go back to the quicklist, and page frames.
+ * The gather is empty afterwards and can be reused.
+ */
+void tlb_flush(struct tlb_gather *tlb) {
+	kpm_chunk_t chunk;
+
+	if (tlb->npages == 0 && tlb->ntables == 0 && tlb->npages_freed == 0)
+		return;
+
+	if (tlb->flush_all || tlb->npages > tlb_flush_ceiling) {
+		tlb_flush_all();
+		tlb_stats.full++;
+	} else {
+		for (size_t i = 0; i < tlb->nranges; i++) {
+			for (uintptr_t va = tlb->ranges[i].start; va < tlb->ranges[i].end; va += PAGE_SIZE)
+				tlb_invlpg((void *)va);
+		}
+		tlb_stats.invlpg += tlb->npages;
+	}
+
+	for (size_t i = 0; i < tlb->ntables; i++)
+		pgtable_free(tlb->tables[i]);
+	tlb_stats.tables += tlb->ntables;
+	chunk.size = PAGE_SIZE;
+	for (size_t i = 0; i < tlb->npages_freed; i++) {
+		chunk.addr = tlb->pages[i];
+		kpm_free(&chunk);
+	}
+	tlb_stats.pages += tlb->npages_freed;
+
+	tlb_gather_init(tlb);
+}
+
+/*
+ * Ends an unmap operation.
+ */
+void tlb_finish(struct tlb_gather *tlb) {
+	tlb_flush(tlb);
+}
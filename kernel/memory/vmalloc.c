@@ -0,0 +1,193 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* kernel/memory/vmalloc.c
+ *
+ * Virtually contiguous kernel allocations backed by scattered page frames
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/vmalloc.h>
+#include <kernel/vmm.h>
+#include <kernel/tlb.h>
+
+/* Area descriptors, linked through @next when unused */
+static struct vmalloc_area vmalloc_pool[VMALLOC_NAREAS];
+static struct vmalloc_area *vmalloc_free_areas;
+static struct vmalloc_area *vmalloc_used_areas;
+
+void vmalloc_init() {
+	vmalloc_free_areas = NULL;
+	vmalloc_used_areas = NULL;
+	for (int i = VMALLOC_NAREAS - 1; i >= 0; i--) {
+		vmalloc_pool[i].next = vmalloc_free_areas;
+		vmalloc_free_areas = vmalloc_pool + i;
+	}
+}
+
+struct vmalloc_area *vmalloc_areas() {
+	return vmalloc_used_areas;
+}
+
+/*
+ * Finds the first hole of the vmalloc area big enough for @size bytes plus
+ * a guard page, and registers it.
+ *
+ * Returns the new area, or NULL if the vmalloc area is exhausted
+ */
+static struct vmalloc_area *vmalloc_get_area(size_t size) {
+	struct vmalloc_area **link = &vmalloc_used_areas;
+	struct vmalloc_area *area;
+	uintptr_t addr = VMALLOC_START;
+
+	size = ALIGNNEXT(size, PAGE_SIZE);
+	if (size == 0 || size > VMALLOC_END - VMALLOC_START || vmalloc_free_areas == NULL)
+		return NULL;
+	while (*link != NULL && (*link)->addr - addr < size + PAGE_SIZE) {
+		addr = (*link)->addr + (*link)->size + PAGE_SIZE;
+		link = &(*link)->next;
+	}
+	if (VMALLOC_END - addr < size + PAGE_SIZE)
+		return NULL;
+
+	area = vmalloc_free_areas;
+	vmalloc_free_areas = area->next;
+	area->addr = addr;
+	area->size = size;
+	area->owned = 0;
+	area->next = *link;
+	*link = area;
+	return area;
+}
+
+/*
+ * Unmaps the area @area, and frees its page frames if @release is set.
+ * The area is unregistered.
+ */
+static void vmalloc_put_area(struct vmalloc_area *area, int release) {
+	struct vmalloc_area **link = &vmalloc_used_areas;
+	struct tlb_gather tlb;
+
+	while (*link != area)
+		link = &(*link)->next;
+	*link = area->next;
+
+	tlb_gather_init(&tlb);
+	if (release)
+		vmm_zap(&tlb, (void *)area->addr, area->size);
+	else
+		vmm_unmap(&tlb, (void *)area->addr, area->size);
+	tlb_finish(&tlb);
+
+	area->next = vmalloc_free_areas;
+	vmalloc_free_areas = area;
+}
+
+/*
+ * Returns the area starting at @addr, or NULL.
+ */
+static struct vmalloc_area *vmalloc_find_area(void *addr) {
+	for (struct vmalloc_area *area = vmalloc_used_areas; area != NULL; area = area->next) {
+		if (area->addr == (uintptr_t)addr)
+			return area;
+	}
+	return NULL;
+}
+
+/*
+ * Maps the @n page frame chunks of @chunks back to back.
+ *
+ * Returns the virtual address of the first chunk, or NULL on error
+ */
+void *vmap(kpm_chunk_t *chunks, size_t n) {
+	struct vmalloc_area *area;
+	uintptr_t va;
+	size_t size = 0;
+
+	for (size_t i = 0; i < n; i++)
+		size += ALIGNNEXT(chunks[i].size, PAGE_SIZE);
+	if ((area = vmalloc_get_area(size)) == NULL)
+		return NULL;
+
+	va = area->addr;
+	for (size_t i = 0; i < n; i++) {
+		for (size_t off = 0; off < chunks[i].size; off += PAGE_SIZE, va += PAGE_SIZE) {
+			if (vmm_map((void *)va, chunks[i].addr + off, VMM_WRITE) < 0) {
+				vmalloc_put_area(area, 0);
+				return NULL;
+			}
+		}
+	}
+	return (void *)area->addr;
+}
+
+/*
+ * Removes a mapping created by vmap, the page frames are left untouched.
+ */
+void vunmap(void *addr) {
+	struct vmalloc_area *area = vmalloc_find_area(addr);
+
+	if (area != NULL && !area->owned)
+		vmalloc_put_area(area, 0);
+}
+
+/*
+ * Allocates @size bytes of virtually contiguous memory.
+ * Page frames are taken from kpm in the biggest chunks available, so a
+ * fragmented physical memory only means more, smaller chunks.
+ *
+ * Returns the allocated memory, or NULL on error
+ */
+void *vmalloc(size_t size) {
+	struct vmalloc_area *area;
+	kpm_chunk_t chunk;
+	kpm_chunk_t unused;
+	uintptr_t va;
+	size_t remaining;
+	size_t off;
+
+	if ((area = vmalloc_get_area(size)) == NULL)
+		return NULL;
+	area->owned = 1;
+
+	va = area->addr;
+	remaining = area->size;
+	while (remaining > 0) {
+		if (kpm_alloc(&chunk, remaining) < 0)
+			goto err;
+		// kpm rounds up to a power of two, give back what is not needed
+		if (chunk.size > remaining) {
+			unused.addr = chunk.addr + remaining;
+			unused.size = chunk.size - remaining;
+			kpm_free(&unused);
+			chunk.size = remaining;
+		}
+		for (off = 0; off < chunk.size; off += PAGE_SIZE) {
+			if (vmm_map((void *)(va + off), chunk.addr + off, VMM_WRITE) < 0) {
+				unused.addr = chunk.addr + off;
+				unused.size = chunk.size - off;
+				kpm_free(&unused);
+				goto err;
+			}
+		}
+		va += chunk.size;
+		remaining -= chunk.size;
+	}
+	return (void *)area->addr;
+
+err:
+	vmalloc_put_area(area, 1);
+	return NULL;
+}
+
+/*
+ * Releases a vmalloc allocation: its mapping and its page frames.
+ */
+void vfree(void *addr) {
+	struct vmalloc_area *area = vmalloc_find_area(addr);
+
+	if (area != NULL && area->owned)
+		vmalloc_put_area(area, 1);
+}
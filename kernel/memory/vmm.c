@@ -0,0 +1,375 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* kernel/memory/vmm.c
+ *
+ * Virtual memory manager, operates on the current address space through
+ * the recursive page directory entry
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/vmm.h>
+#include <kernel/tlb.h>
+#include <kernel/kpm.h>
+#include <kernel/string.h>
+#include <kernel/cpu.h>
+#include <kernel/zram.h>
+#include <kernel/pgtable.h>
+
+/* Paging structures built by boot_init */
+#define BOOT_PAGE_DIRECTORY	((void *)0x1000)
+#define BOOT_PAGE_TABLE		((void *)0x2000)
+
+struct vmm_space kernel_space;
+struct vmm_space *vmm_current;
+
+/* Region descriptors, linked through @next when unused */
+static struct vmm_region vmm_regions[VMM_NREGIONS];
+static struct vmm_region *vmm_free_regions;
+
+/*
+ * kpm knows nothing about the boot paging structures, they must be
+ * reserved before the first page table allocation.
+ * Write protection is also enforced in ring 0, otherwise the kernel
+ * would never fault on copy-on-write pages.
+ */
+void vmm_init() {
+	kpm_disable(BOOT_PAGE_DIRECTORY, PAGE_SIZE);
+	kpm_disable(BOOT_PAGE_TABLE, PAGE_SIZE);
+
+	vmm_free_regions = NULL;
+	for (int i = VMM_NREGIONS - 1; i >= 0; i--) {
+		vmm_regions[i].next = vmm_free_regions;
+		vmm_free_regions = vmm_regions + i;
+	}
+	kernel_space.pgdir = (uintptr_t)BOOT_PAGE_DIRECTORY;
+	kernel_space.regions = NULL;
+	vmm_current = &kernel_space;
+
+	vmm_reserve(&kernel_space, VMM_PAGE_REFS, kpm_nframes * sizeof(uint16_t), NULL, VMM_WRITE);
+	write_cr0(read_cr0() | CR0_WP);
+}
+
+/*
+ * Makes the current page directory entry covering the kernel address @virt
+ * match the kernel page directory. Kernel page tables are created in the
+ * kernel page directory and only propagated lazily to other address spaces.
+ *
+ * Returns 1 if a page table covers @virt, 0 otherwise.
+ */
+static int vmm_sync_pde(void *virt) {
+	size_t index = PDE_INDEX(virt);
+
+	if (VMM_PAGE_DIRECTORY[index].present)
+		return 1;
+	if ((uintptr_t)virt < KERNEL_VIRT_OFFSET || index == LAST_PAGE_ENTRY)
+		return 0;
+	if (!VMM_KERNEL_PGDIR[index].present)
+		return 0;
+	VMM_PAGE_DIRECTORY[index] = VMM_KERNEL_PGDIR[index];
+	tlb_invlpg(VMM_PAGE_TABLE(virt));
+	return 1;
+}
+
+/*
+ * Resolves a fault on a kernel page table that exists in the kernel page
+ * directory but not yet in the current one.
+ *
+ * Returns 0 if the fault was resolved, -1 otherwise
+ */
+int vmm_fault_sync(void *addr) {
+	if ((uintptr_t)addr < KERNEL_VIRT_OFFSET || VMM_PAGE_DIRECTORY[PDE_INDEX(addr)].present)
+		return -1;
+	return vmm_sync_pde(addr) ? 0 : -1;
+}
+
+/*
+ * Switches to the address space @space.
+ */
+void vmm_switch(struct vmm_space *space) {
+	vmm_current = space;
+	__asm__ volatile ("movl %0, %%cr3" :: "r" (space->pgdir) : "memory");
+}
+
+/*
+ * Returns the page table entry mapping @virt, or NULL if there is no
+ * page table for it.
+ */
+struct page_table_entry *vmm_get_pte(void *virt) {
+	if (!vmm_sync_pde(virt))
+		return NULL;
+	return VMM_PAGE_TABLE(virt) + PTE_INDEX(virt);
+}
+
+/*
+ * Returns the physical address mapped at @virt, or NULL if unmapped.
+ */
+void *vmm_virt_to_phys(void *virt) {
+	struct page_table_entry *pte = vmm_get_pte(virt);
+
+	if (pte == NULL || !pte->present)
+		return NULL;
+	return (void *)(((uint32_t)pte->address << 12) | ((uintptr_t)virt & (PAGE_SIZE - 1)));
+}
+
+/*
+ * Allocates and installs the page table covering @virt.
+ * The new table usually comes zeroed from the quicklist, otherwise it is
+ * zeroed through the recursive mapping, so it does not need to be
+ * reachable from anywhere else.
+ * Kernel page tables are also registered in the kernel page directory.
+ */
+static int vmm_alloc_table(void *virt, int flags) {
+	struct page_directory_entry *pde = VMM_PAGE_DIRECTORY + PDE_INDEX(virt);
+	struct page_table_entry *table = VMM_PAGE_TABLE(virt);
+	kpm_chunk_t chunk;
+	int zeroed;
+
+	if ((zeroed = pgtable_alloc(&chunk)) < 0)
+		return -1;
+	page_init((struct page_entry *)pde, chunk.addr, 1, (flags & VMM_USER) != 0);
+	tlb_invlpg(table);
+	if (!zeroed)
+		memset(table, 0, PAGE_SIZE);
+	if ((uintptr_t)virt >= KERNEL_VIRT_OFFSET)
+		VMM_KERNEL_PGDIR[PDE_INDEX(virt)] = *pde;
+	return 0;
+}
+
+/*
+ * Maps the page frame @phys at @virt in the current address space,
+ * allocating the page table if needed.
+ *
+ * Returns 0 on success, -1 on error
+ */
+int vmm_map(void *virt, void *phys, int flags) {
+	struct page_table_entry *pte;
+
+	if (!ISALIGNED(virt, PAGE_SIZE) || !ISALIGNED(phys, PAGE_SIZE))
+		return -1;
+	if (!vmm_sync_pde(virt) && vmm_alloc_table(virt, flags) < 0)
+		return -1;
+
+	pte = VMM_PAGE_TABLE(virt) + PTE_INDEX(virt);
+	page_init((struct page_entry *)pte, phys, (flags & VMM_WRITE) != 0, (flags & VMM_USER) != 0);
+	tlb_invlpg(virt);
+	return 0;
+}
+
+/*
+ * Returns 1 if no entry of the page table @table is in use.
+ */
+static int vmm_table_empty(struct page_table_entry *table) {
+	uint32_t *entries = (uint32_t *)table;
+
+	for (size_t i = 0; i < PAGE_TABLE_LENGTH; i++) {
+		if (entries[i])
+			return 0;
+	}
+	return 1;
+}
+
+/*
+ * Unmaps [@virt, @virt + @size) from the current address space, and
+ * queues the mapped frames in @tlb if @release is set. Swapped out pages
+ * are dropped from zram as well.
+ *
+ * Page tables of the lower half that become empty are unhooked from the
+ * page directory and queued in @tlb. Kernel page tables are never released
+ * since they are meant to be shared.
+ * Nothing is invalidated here: the caller must end with tlb_finish.
+ */
+static void vmm_unmap_range(struct tlb_gather *tlb, void *virt, size_t size, int release) {
+	uintptr_t va = ALIGN(virt, PAGE_SIZE);
+	uintptr_t end = ALIGNNEXT((uintptr_t)virt + size, PAGE_SIZE);
+	uintptr_t table_end;
+	struct page_directory_entry *pde;
+	struct page_table_entry *table;
+	struct page_table_entry *pte;
+
+	if (end < va)
+		end = 0xFFFFF000;
+	while (va < end) {
+		table_end = ALIGNNEXTFORCE(va, PAGE_SIZE * PAGE_TABLE_LENGTH);
+		if (table_end > end || table_end == 0)
+			table_end = end;
+		pde = VMM_PAGE_DIRECTORY + PDE_INDEX(va);
+		table = VMM_PAGE_TABLE(va);
+
+		if (PDE_INDEX(va) != LAST_PAGE_ENTRY && pde->present) {
+			for (uintptr_t p = va; p < table_end; p += PAGE_SIZE) {
+				pte = table + PTE_INDEX(p);
+				if (release && pte->present && !vmm_page_unshare((void *)((uint32_t)pte->address << 12)))
+					tlb_gather_page(tlb, (void *)((uint32_t)pte->address << 12));
+				else if (release && !pte->present && pte->swap)
+					zram_free(pte->address);
+				page_clear((struct page_entry *)pte);
+			}
+			tlb_gather_range(tlb, (void *)va, table_end - va);
+
+			if (va >= VMM_USER_BASE && va < VMM_USER_END && vmm_table_empty(table)) {
+				void *phys = (void *)((uint32_t)pde->address << 12);
+
+				page_clear((struct page_entry *)pde);
+				tlb_gather_range(tlb, table, PAGE_SIZE);
+				tlb_gather_table(tlb, phys);
+			}
+		}
+		va = table_end;
+	}
+}
+
+/*
+ * Unmaps [@virt, @virt + @size) from the current address space.
+ * The caller must end with tlb_finish.
+ */
+void vmm_unmap(struct tlb_gather *tlb, void *virt, size_t size) {
+	vmm_unmap_range(tlb, virt, size, 0);
+}
+
+/*
+ * Unmaps [@virt, @virt + @size) from the current address space and frees
+ * the page frames that were mapped there once the TLB is flushed.
+ * The caller must end with tlb_finish.
+ */
+void vmm_zap(struct tlb_gather *tlb, void *virt, size_t size) {
+	vmm_unmap_range(tlb, virt, size, 1);
+}
+
+/*
+ * Returns the reference count cell of the page frame @phys. Unless
+ * @populate is set, NULL is returned when the cell was never touched, in
+ * which case the frame is not shared. This allows reading counts from the
+ * page fault handler without faulting again.
+ */
+static uint16_t *vmm_page_ref(void *phys, int populate) {
+	uint16_t *ref = (uint16_t *)VMM_PAGE_REFS + ((uintptr_t)phys >> 12);
+	struct page_table_entry *pte;
+
+	if (!populate) {
+		pte = vmm_get_pte(ref);
+		if (pte == NULL || !pte->present)
+			return NULL;
+	}
+	return ref;
+}
+
+/*
+ * Returns the number of additional mappings of the page frame @phys.
+ */
+uint16_t vmm_page_shares(void *phys) {
+	uint16_t *ref = vmm_page_ref(phys, 0);
+
+	return ref ? *ref : 0;
+}
+
+/*
+ * Accounts an additional mapping of the page frame @phys.
+ */
+void vmm_page_share(void *phys) {
+	(*vmm_page_ref(phys, 1))++;
+}
+
+/*
+ * Drops one mapping of the page frame @phys.
+ * Returns 1 if the frame is still mapped elsewhere, 0 if the caller held the
+ * last mapping and now owns the frame.
+ */
+int vmm_page_unshare(void *phys) {
+	uint16_t *ref = vmm_page_ref(phys, 0);
+
+	if (ref == NULL || *ref == 0)
+		return 0;
+	(*ref)--;
+	return 1;
+}
+
+/*
+ * Returns the region of @space containing @virt, or NULL.
+ */
+struct vmm_region *vmm_find_region(struct vmm_space *space, void *virt) {
+	uintptr_t va = (uintptr_t)virt;
+
+	for (struct vmm_region *r = space->regions; r != NULL && r->start <= va; r = r->next) {
+		if (va < r->end)
+			return r;
+	}
+	return NULL;
+}
+
+/*
+ * Returns the first page at or after @va that belongs to an anonymous
+ * lower half region of @space, wrapping around once, or 0 if there is none.
+ */
+uintptr_t vmm_next_anon(struct vmm_space *space, uintptr_t va) {
+	for (int wrapped = 0; wrapped < 2; wrapped++, va = 0) {
+		for (struct vmm_region *r = space->regions; r != NULL; r = r->next) {
+			if (!vmm_region_anon(r) || va >= r->end)
+				continue;
+			return va > r->start ? va : r->start;
+		}
+	}
+	return 0;
+}
+
+/*
+ * Reserves [@virt, @virt + @size) in @space, keeping the region list
+ * sorted by address. Nothing is mapped until the region is touched.
+ *
+ * Returns 0 on success, -1 on error
+ */
+int vmm_reserve(struct vmm_space *space, void *virt, size_t size, void *phys, int flags) {
+	uintptr_t start = ALIGN(virt, PAGE_SIZE);
+	uintptr_t end = ALIGNNEXT((uintptr_t)virt + size, PAGE_SIZE);
+	struct vmm_region **link = &space->regions;
+	struct vmm_region *region;
+
+	if (end <= start || vmm_free_regions == NULL)
+		return -1;
+	if ((flags & VMM_PHYS) && !ISALIGNED(phys, PAGE_SIZE))
+		return -1;
+	while (*link != NULL && (*link)->end <= start)
+		link = &(*link)->next;
+	if (*link != NULL && (*link)->start < end)
+		return -1;
+
+	region = vmm_free_regions;
+	vmm_free_regions = region->next;
+	region->start = start;
+	region->end = end;
+	region->phys = (uintptr_t)phys;
+	region->flags = flags;
+	region->next = *link;
+	*link = region;
+	return 0;
+}
+
+/*
+ * Releases the region starting at @virt. Zero-filled frames are given back
+ * to kpm, physical mappings are only unmapped.
+ *
+ * Returns 0 on success, -1 if there is no such region
+ */
+int vmm_release(struct vmm_space *space, void *virt) {
+	struct vmm_region **link = &space->regions;
+	struct vmm_region *region;
+	struct tlb_gather tlb;
+
+	while (*link != NULL && (*link)->start != (uintptr_t)virt)
+		link = &(*link)->next;
+	if (*link == NULL)
+		return -1;
+	region = *link;
+	*link = region->next;
+
+	tlb_gather_init(&tlb);
+	vmm_unmap_range(&tlb, (void *)region->start, region->end - region->start,
+		!(region->flags & VMM_PHYS));
+	tlb_finish(&tlb);
+
+	region->next = vmm_free_regions;
+	vmm_free_regions = region;
+	return 0;
+}
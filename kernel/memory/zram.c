@@ -0,0 +1,223 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* kernel/memory/zram.c
+ *
+ * Compressed in-memory page store, the backend of anonymous page swapping
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/zram.h>
+#include <kernel/lz4.h>
+#include <kernel/vmm.h>
+#include <kernel/tlb.h>
+#include <kernel/cpu.h>
+#include <kernel/string.h>
+
+#define ZRAM_NPAGES			(ZRAM_POOL_SIZE / PAGE_SIZE)
+
+struct zram_stats zram_stats;
+
+static struct zram_entry zram_entries[ZRAM_NENTRIES];
+static int zram_free_entries;
+
+/* One bit per block, set when in use */
+static uint32_t zram_blocks[ZRAM_NBLOCKS / 32];
+static uint32_t zram_first_free;
+
+/* Blocks in use per pool page, a page is backed while it is not zero */
+static uint8_t zram_page_used[ZRAM_NPAGES];
+
+static struct lz4_state zram_lz4;
+static uint8_t zram_buffer[ZRAM_MAX_SIZE];
+
+#define ZRAM_BLOCK_USED(b)	(zram_blocks[(b) / 32] & (1 << ((b) % 32)))
+
+void zram_init() {
+	struct tlb_gather tlb;
+
+	zram_free_entries = -1;
+	for (int i = ZRAM_NENTRIES - 1; i >= 0; i--) {
+		zram_entries[i].block = zram_free_entries;
+		zram_free_entries = i;
+	}
+	// Pool page tables must exist before the pool is needed, that is
+	// when memory is running out
+	tlb_gather_init(&tlb);
+	for (uintptr_t va = ZRAM_POOL; va < ZRAM_POOL + ZRAM_POOL_SIZE; va += PAGE_SIZE * PAGE_TABLE_LENGTH) {
+		vmm_map((void *)va, 0, 0);
+		vmm_unmap(&tlb, (void *)va, PAGE_SIZE);
+	}
+	tlb_finish(&tlb);
+}
+
+/*
+ * Marks the @n blocks starting at @block as used (@used = 1) or free.
+ */
+static void zram_mark_blocks(uint32_t block, uint32_t n, int used) {
+	for (uint32_t b = block; b < block + n; b++) {
+		if (used)
+			zram_blocks[b / 32] |= 1 << (b % 32);
+		else
+			zram_blocks[b / 32] &= ~(1 << (b % 32));
+	}
+}
+
+/*
+ * Finds @n free contiguous blocks, lowest first so that the pool stays
+ * packed in as few pages as possible.
+ *
+ * Returns the first block, or -1 if the pool is full
+ */
+static int zram_find_blocks(uint32_t n) {
+	uint32_t run = 0;
+
+	for (uint32_t b = zram_first_free; b < ZRAM_NBLOCKS; b++) {
+		if (ZRAM_BLOCK_USED(b)) {
+			run = 0;
+			continue;
+		}
+		if (++run == n)
+			return b + 1 - n;
+	}
+	return -1;
+}
+
+/*
+ * Backs the pool pages covered by the @n blocks starting at @block that
+ * are not backed yet, with @spare first, then with frames from kpm.
+ *
+ * Returns 0 on success, -1 on error
+ */
+static int zram_back_blocks(uint32_t block, uint32_t n, kpm_chunk_t *spare) {
+	uint32_t first = block / ZRAM_BLOCKS_PER_PAGE;
+	uint32_t last = (block + n - 1) / ZRAM_BLOCKS_PER_PAGE;
+	kpm_chunk_t frames[2];
+	int nframes = 0;
+	int from_spare = 0;
+
+	// Blocks never span more than two pages
+	for (uint32_t pg = first; pg <= last; pg++) {
+		if (zram_page_used[pg])
+			continue;
+		if (spare->size && !from_spare) {
+			frames[nframes++] = *spare;
+			from_spare = 1;
+		} else if (kpm_alloc(frames + nframes, PAGE_SIZE) == 0) {
+			nframes++;
+		} else {
+			for (int i = from_spare; i < nframes; i++)
+				kpm_free(frames + i);
+			return -1;
+		}
+	}
+	if (from_spare)
+		spare->size = 0;
+
+	nframes = 0;
+	for (uint32_t pg = first; pg <= last; pg++) {
+		if (zram_page_used[pg])
+			continue;
+		vmm_map((void *)(ZRAM_POOL + pg * PAGE_SIZE), frames[nframes++].addr, VMM_WRITE);
+		zram_stats.pool_pages++;
+	}
+	for (uint32_t b = block; b < block + n; b++)
+		zram_page_used[b / ZRAM_BLOCKS_PER_PAGE]++;
+	return 0;
+}
+
+/*
+ * Frees the @n blocks starting at @block, and the pool pages left empty.
+ */
+static void zram_release_blocks(uint32_t block, uint32_t n) {
+	struct tlb_gather tlb;
+	uint32_t pg;
+
+	zram_mark_blocks(block, n, 0);
+	if (block < zram_first_free)
+		zram_first_free = block;
+
+	tlb_gather_init(&tlb);
+	for (uint32_t b = block; b < block + n; b++) {
+		pg = b / ZRAM_BLOCKS_PER_PAGE;
+		if (--zram_page_used[pg] == 0) {
+			vmm_zap(&tlb, (void *)(ZRAM_POOL + pg * PAGE_SIZE), PAGE_SIZE);
+			zram_stats.pool_pages--;
+		}
+	}
+	tlb_finish(&tlb);
+}
+
+int zram_store(void *page, kpm_chunk_t *spare) {
+	uint64_t start = rdtsc();
+	struct zram_entry *entry;
+	size_t len;
+	uint32_t n;
+	int block;
+	int handle;
+
+	len = lz4_compress(&zram_lz4, page, PAGE_SIZE, zram_buffer, ZRAM_MAX_SIZE);
+	zram_stats.compr_cycles += rdtsc() - start;
+	zram_stats.compressed++;
+	if (len == 0) {
+		zram_stats.rejected++;
+		return -1;
+	}
+	if (zram_free_entries < 0)
+		return -1;
+
+	n = ALIGNNEXT(len, ZRAM_BLOCK_SIZE) / ZRAM_BLOCK_SIZE;
+	if ((block = zram_find_blocks(n)) < 0)
+		return -1;
+	if (zram_back_blocks(block, n, spare) < 0)
+		return -1;
+	zram_mark_blocks(block, n, 1);
+	if ((uint32_t)block == zram_first_free)
+		zram_first_free = block + n;
+	memcpy((void *)(ZRAM_POOL + block * ZRAM_BLOCK_SIZE), zram_buffer, len);
+
+	handle = zram_free_entries;
+	entry = zram_entries + handle;
+	zram_free_entries = entry->block;
+	entry->block = block;
+	entry->len = len;
+	entry->refs = 1;
+
+	zram_stats.stored++;
+	zram_stats.compr_size += len;
+	return handle;
+}
+
+int zram_load(uint32_t handle, void *page) {
+	struct zram_entry *entry = zram_entries + handle;
+	uint64_t start = rdtsc();
+	int ret;
+
+	if (handle >= ZRAM_NENTRIES || entry->len == 0)
+		return -1;
+	ret = lz4_decompress((void *)(ZRAM_POOL + entry->block * ZRAM_BLOCK_SIZE), entry->len,
+		page, PAGE_SIZE);
+	zram_stats.decompr_cycles += rdtsc() - start;
+	zram_stats.decompressed++;
+	return ret == PAGE_SIZE ? 0 : -1;
+}
+
+void zram_dup(uint32_t handle) {
+	if (handle < ZRAM_NENTRIES && zram_entries[handle].len)
+		zram_entries[handle].refs++;
+}
+
+void zram_free(uint32_t handle) {
+	struct zram_entry *entry = zram_entries + handle;
+
+	if (handle >= ZRAM_NENTRIES || entry->len == 0 || --entry->refs > 0)
+		return;
+	zram_release_blocks(entry->block, ALIGNNEXT(entry->len, ZRAM_BLOCK_SIZE) / ZRAM_BLOCK_SIZE);
+	zram_stats.stored--;
+	zram_stats.compr_size -= entry->len;
+	entry->len = 0;
+	entry->block = zram_free_entries;
+	zram_free_entries = handle;
+}
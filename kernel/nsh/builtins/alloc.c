@@ -6,7 +6,7 @@
  * Allocate builtin file
  *
  * created: 2022/12/13 - glafond- <glafond-@student.42.fr>
- * updated: 2022/12/19 - mrxx0 <chcoutur@student.42.fr>
+ * updated: 2026/10/19 - agent <agent@local>
  */
 
 #include <kernel/kpm.h>
@@ -16,7 +16,6 @@
 
 #define BLTNAME "alloc"
 
-extern struct screenbuf sb[];
 extern struct screenbuf *sb_current;
 
 static inline void usage() {
@@ -0,0 +1,632 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* kernel/nsh/builtins/bench.c
+ *
+ * Bench builtin file
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <stdint.h>
+#include <kernel/print.h>
+#include <kernel/string.h>
+#include <kernel/stdlib.h>
+#include <kernel/kpm.h>
+#include <kernel/vmm.h>
+#include <kernel/tlb.h>
+#include <kernel/kmap.h>
+#include <kernel/cpu.h>
+#include <kernel/slab.h>
+#include <kernel/tlsf.h>
+#include <kernel/vmalloc.h>
+#include <kernel/fpu.h>
+#include <kernel/screenbuf.h>
+#include <kernel/timer.h>
+
+#define BLTNAME "bench"
+
+#define BENCH_COW_BASE		((void *)0x10000000)
+#define BENCH_COW_DFL_MB	64
+
+#define BENCH_KMAP_VIRT		((void *)0x10000000)
+#define BENCH_KMAP_LOOPS	10000
+
+#define BENCH_NUMA_BASE		((void *)0x10000000)
+#define BENCH_NUMA_PAGES	1024
+#define BENCH_NUMA_LINE		64
+#define BENCH_NUMA_NLINES	(BENCH_NUMA_PAGES * PAGE_SIZE / BENCH_NUMA_LINE)
+/* Odd, so that the walk goes through every line, and far from a page */
+#define BENCH_NUMA_STEP		4099
+
+#define BENCH_MEM_MAX		65536
+#define BENCH_MEM_TOTAL		(4 * 1024 * 1024)
+
+#define BENCH_PAGE_NPAGES	64
+#define BENCH_PAGE_ROUNDS	16
+
+#define BENCH_SCROLL_LINES	2000
+
+#define BENCH_TLSF_SLOTS	256
+#define BENCH_TLSF_MAX_OPS	(BENCH_TLSF_SLOTS * 8)
+#define BENCH_TLSF_TOGGLES	(BENCH_TLSF_SLOTS * 4)
+
+// Keeps the values read by the benchmarks alive
+static volatile uint32_t bench_sink;
+
+static inline void usage() {
+	kprintf("Usage: " BLTNAME " cow [MB]\n");
+	kprintf("       " BLTNAME " kmap\n");
+	kprintf("       " BLTNAME " numa\n");
+	kprintf("       " BLTNAME " tlsf\n");
+	kprintf("       " BLTNAME " mem\n");
+	kprintf("       " BLTNAME " page\n");
+	kprintf("       " BLTNAME " scroll\n");
+}
+
+/*
+ * Prints @cycles, or a warning if it does not fit on 32 bits
+ */
+static void bench_print_cycles(const char *what, uint64_t cycles) {
+	if (cycles >> 32)
+		kprintf("%s: more than 2^32 cycles\n", what);
+	else
+		kprintf("%s: %u cycles\n", what, (uint32_t)cycles);
+}
+
+/*
+ * Prints the average number of cycles of @n operations that took @cycles
+ */
+static void bench_print_per_op(const char *what, uint64_t cycles, uint32_t n) {
+	if (cycles >> 32)
+		kprintf("%s: more than 2^32 cycles\n", what);
+	else
+		kprintf("%s: %u cycles/op\n", what, (uint32_t)cycles / n);
+}
+
+/*
+ * Populates @mb MB of anonymous memory, then measures the time needed to
+ * clone the address space and to break the sharing of one page.
+ */
+static int bench_cow(size_t mb) {
+	struct vmm_space clone;
+	size_t size = mb * 1024 * 1024;
+	kpm_chunk_t chunk;
+	uint64_t t;
+	int ret = -1;
+
+	if (vmm_reserve(vmm_current, BENCH_COW_BASE, size, NULL, VMM_WRITE) < 0) {
+		kprintf(BLTNAME ": cannot reserve %u MB\n", mb);
+		return -1;
+	}
+	for (size_t off = 0; off < size; off += PAGE_SIZE) {
+		if (kpm_alloc(&chunk, PAGE_SIZE) < 0) {
+			kprintf(BLTNAME ": out of memory after %u KB\n", off / 1024);
+			goto out;
+		}
+		vmm_map(BENCH_COW_BASE + off, chunk.addr, VMM_WRITE);
+		*(uint32_t *)(BENCH_COW_BASE + off) = off;
+	}
+
+	t = rdtsc();
+	if (vmm_clone(&clone, vmm_current) < 0) {
+		kprintf(BLTNAME ": clone failed\n");
+		goto out;
+	}
+	t = rdtsc() - t;
+	kprintf("clone of %u MB populated memory\n", mb);
+	bench_print_cycles("    clone", t);
+
+	t = rdtsc();
+	*(uint32_t *)BENCH_COW_BASE = 0;
+	t = rdtsc() - t;
+	bench_print_cycles("    first write (copy)", t);
+
+	vmm_destroy(&clone);
+	t = rdtsc();
+	*(uint32_t *)(BENCH_COW_BASE + PAGE_SIZE) = 0;
+	t = rdtsc() - t;
+	bench_print_cycles("    first write (reuse)", t);
+	ret = 0;
+out:
+	vmm_release(vmm_current, BENCH_COW_BASE);
+	return ret;
+}
+
+/*
+ * Compares a temporary mapping of a page frame through a kmap slot
+ * with a regular vmm_map/vmm_unmap of the same frame.
+ */
+static int bench_kmap() {
+	volatile uint32_t *ptr;
+	struct tlb_gather tlb;
+	kpm_chunk_t chunk;
+	uint32_t sum = 0;
+	uint64_t t;
+
+	if (kpm_alloc(&chunk, PAGE_SIZE) < 0) {
+		kprintf(BLTNAME ": out of memory\n");
+		return -1;
+	}
+
+	t = rdtsc();
+	for (int i = 0; i < BENCH_KMAP_LOOPS; i++) {
+		ptr = kmap_atomic(PFN(chunk.addr));
+		sum += *ptr;
+		kunmap_atomic((void *)ptr);
+	}
+	t = rdtsc() - t;
+	bench_print_per_op("kmap_atomic", t, BENCH_KMAP_LOOPS);
+
+	t = rdtsc();
+	for (int i = 0; i < BENCH_KMAP_LOOPS; i++) {
+		vmm_map(BENCH_KMAP_VIRT, chunk.addr, VMM_WRITE);
+		sum += *(volatile uint32_t *)BENCH_KMAP_VIRT;
+		tlb_gather_init(&tlb);
+		vmm_unmap(&tlb, BENCH_KMAP_VIRT, PAGE_SIZE);
+		tlb_finish(&tlb);
+	}
+	t = rdtsc() - t;
+	bench_print_per_op("vmm_map", t, BENCH_KMAP_LOOPS);
+
+	kpm_free(&chunk);
+	bench_sink = sum;
+	return 0;
+}
+
+/*
+ * Allocates BENCH_NUMA_PAGES page frames on @node only, then measures the
+ * latency of dependent loads going through all of their cache lines in an
+ * order the prefetcher cannot guess.
+ */
+static int bench_numa_node(int node) {
+	size_t size = BENCH_NUMA_PAGES * PAGE_SIZE;
+	enum kpm_policy policy = kpm_policy;
+	uint32_t line, next;
+	kpm_chunk_t chunk;
+	uint64_t alloc = 0;
+	uint64_t t;
+	int ret = -1;
+
+	if (vmm_reserve(vmm_current, BENCH_NUMA_BASE, size, NULL, VMM_WRITE) < 0) {
+		kprintf(BLTNAME ": cannot reserve %u KB\n", size / 1024);
+		return -1;
+	}
+	kpm_policy = KPM_BIND;
+	for (size_t off = 0; off < size; off += PAGE_SIZE) {
+		t = rdtsc();
+		if (kpm_alloc_node(&chunk, PAGE_SIZE, node) < 0) {
+			kprintf(BLTNAME ": node %u out of memory after %u KB\n", node, off / 1024);
+			goto out;
+		}
+		alloc += rdtsc() - t;
+		vmm_map(BENCH_NUMA_BASE + off, chunk.addr, VMM_WRITE);
+	}
+
+	for (line = 0; line < BENCH_NUMA_NLINES; line = next) {
+		next = (line + BENCH_NUMA_STEP) & (BENCH_NUMA_NLINES - 1);
+		*(uint32_t *)(BENCH_NUMA_BASE + line * BENCH_NUMA_LINE) = next;
+		if (next == 0)
+			break;
+	}
+	t = rdtsc();
+	line = 0;
+	for (int i = 0; i < BENCH_NUMA_NLINES; i++)
+		line = *(volatile uint32_t *)(BENCH_NUMA_BASE + line * BENCH_NUMA_LINE);
+	t = rdtsc() - t;
+
+	kprintf("node %u (%s)\n", node, node == numa_node_id() ? "local" : "remote");
+	bench_print_per_op("    page allocation", alloc, BENCH_NUMA_PAGES);
+	bench_print_per_op("    dependent load", t, BENCH_NUMA_NLINES);
+	ret = 0;
+out:
+	kpm_policy = policy;
+	vmm_release(vmm_current, BENCH_NUMA_BASE);
+	return ret;
+}
+
+/*
+ * Compares allocations and accesses on the node of the cpu with those on
+ * the other nodes.
+ */
+static int bench_numa() {
+	int node = numa_node_id();
+
+	if (bench_numa_node(node) < 0)
+		return -1;
+	for (int i = 1; i < numa_nnodes; i++) {
+		if (bench_numa_node(kpm_nodes[node].fallback[i]) < 0)
+			return -1;
+	}
+	return 0;
+}
+
+/*
+ * An allocation of @size bytes into @slot, or the release of @slot if
+ * @size is 0
+ */
+struct bench_op {
+	uint16_t slot;
+	uint16_t size;
+};
+
+struct bench_latency {
+	uint32_t min;
+	uint32_t max;
+	uint32_t n;
+	uint64_t total;
+};
+
+static struct bench_op bench_ops[BENCH_TLSF_MAX_OPS];
+static void *bench_slots[BENCH_TLSF_SLOTS];
+static uint32_t bench_seed;
+
+static uint32_t bench_rand() {
+	bench_seed = bench_seed * 1103515245 + 12345;
+	return bench_seed >> 16;
+}
+
+static void bench_latency_add(struct bench_latency *lat, uint64_t cycles) {
+	uint32_t c = cycles >> 32 ? 0xFFFFFFFF : cycles;
+
+	if (lat->n == 0 || c < lat->min)
+		lat->min = c;
+	if (c > lat->max)
+		lat->max = c;
+	lat->n++;
+	lat->total += cycles;
+}
+
+static void bench_latency_print(const char *what, struct bench_latency *lat) {
+	if (lat->n == 0)
+		return;
+	if (lat->total >> 32)
+		kprintf("%s: min %u, max %u cycles\n", what, lat->min, lat->max);
+	else
+		kprintf("%s: min %u, avg %u, max %u cycles\n", what, lat->min,
+			(uint32_t)lat->total / lat->n, lat->max);
+}
+
+/*
+ * Allocations of growing sizes, released in the reverse order.
+ * Returns the number of operations
+ */
+static uint32_t bench_tlsf_reverse() {
+	uint32_t n = 0;
+
+	for (int i = 0; i < BENCH_TLSF_SLOTS; i++)
+		bench_ops[n++] = (struct bench_op){i, 8 * (i + 1)};
+	for (int i = BENCH_TLSF_SLOTS - 1; i >= 0; i--)
+		bench_ops[n++] = (struct bench_op){i, 0};
+	return n;
+}
+
+/*
+ * Small allocations, one of two released, then allocations slightly too
+ * big for the holes left.
+ * Returns the number of operations
+ */
+static uint32_t bench_tlsf_holes() {
+	uint32_t n = 0;
+
+	for (int i = 0; i < BENCH_TLSF_SLOTS; i++)
+		bench_ops[n++] = (struct bench_op){i, 32};
+	for (int i = 0; i < BENCH_TLSF_SLOTS; i += 2)
+		bench_ops[n++] = (struct bench_op){i, 0};
+	for (int i = 0; i < BENCH_TLSF_SLOTS; i += 2)
+		bench_ops[n++] = (struct bench_op){i, 48};
+	for (int i = 0; i < BENCH_TLSF_SLOTS; i++)
+		bench_ops[n++] = (struct bench_op){i, 0};
+	return n;
+}
+
+/*
+ * Mostly small allocations of random sizes, released and allocated again
+ * in a random order.
+ * Returns the number of operations
+ */
+static uint32_t bench_tlsf_random() {
+	uint8_t used[BENCH_TLSF_SLOTS];
+	uint32_t n = 0;
+	uint16_t size;
+	uint32_t slot;
+
+	bench_seed = 42;
+	for (uint32_t i = 0; i < BENCH_TLSF_SLOTS + BENCH_TLSF_TOGGLES; i++) {
+		slot = i < BENCH_TLSF_SLOTS ? i : bench_rand() % BENCH_TLSF_SLOTS;
+		if (i >= BENCH_TLSF_SLOTS && used[slot]) {
+			bench_ops[n++] = (struct bench_op){slot, 0};
+			used[slot] = 0;
+			continue;
+		}
+		size = bench_rand() % 4 ? bench_rand() % 128 + 1 : bench_rand() % KMALLOC_MAX_SIZE + 1;
+		bench_ops[n++] = (struct bench_op){slot, size};
+		used[slot] = 1;
+	}
+	for (int i = 0; i < BENCH_TLSF_SLOTS; i++) {
+		if (used[i])
+			bench_ops[n++] = (struct bench_op){i, 0};
+	}
+	return n;
+}
+
+/*
+ * Runs the @n first operations of bench_ops with @alloc and @release,
+ * interrupts disabled, and prints their latencies.
+ */
+static void bench_tlsf_run(const char *name, uint32_t n, void *(*alloc)(size_t),
+	void (*release)(void *)) {
+	struct bench_latency allocs = {0};
+	struct bench_latency frees = {0};
+	uint32_t failed = 0;
+	uint32_t flags;
+	void **slot;
+	uint64_t t;
+
+	for (int i = 0; i < BENCH_TLSF_SLOTS; i++)
+		bench_slots[i] = NULL;
+	flags = cpu_irq_save();
+	for (uint32_t i = 0; i < n; i++) {
+		slot = bench_slots + bench_ops[i].slot;
+		if (bench_ops[i].size == 0) {
+			if (*slot == NULL)
+				continue;
+			t = rdtsc();
+			release(*slot);
+			bench_latency_add(&frees, rdtsc() - t);
+			*slot = NULL;
+		} else {
+			t = rdtsc();
+			*slot = alloc(bench_ops[i].size);
+			t = rdtsc() - t;
+			if (*slot == NULL)
+				failed++;
+			else
+				bench_latency_add(&allocs, t);
+		}
+	}
+	cpu_irq_restore(flags);
+
+	kprintf("  %s\n", name);
+	bench_latency_print("    allocation", &allocs);
+	bench_latency_print("    release", &frees);
+	if (failed)
+		kprintf("    %u allocations failed\n", failed);
+}
+
+/*
+ * Measures the worst case latency of the real-time heap under allocation
+ * patterns that fragment it, compared to kmalloc.
+ */
+static int bench_tlsf() {
+	static const struct {
+		const char *name;
+		uint32_t (*build)();
+	} patterns[] = {
+		{"reverse order release", bench_tlsf_reverse},
+		{"holes too small", bench_tlsf_holes},
+		{"random sizes and order", bench_tlsf_random},
+	};
+	uint32_t n;
+
+	for (size_t i = 0; i < sizeof(patterns) / sizeof(*patterns); i++) {
+		n = patterns[i].build();
+		kprintf("%s (%u operations)\n", patterns[i].name, n);
+		bench_tlsf_run("rt_malloc", n, rt_malloc, rt_free);
+		bench_tlsf_run("kmalloc", n, kmalloc, kfree);
+	}
+	return 0;
+}
+
+static const size_t bench_mem_sizes[] = {16, 64, 256, 4000, BENCH_MEM_MAX};
+
+static void bench_memcpy(uint8_t *src, uint8_t *dst, size_t n) {
+	memcpy(dst, src, n);
+}
+
+/* Overlapping, so that the copy goes backward */
+static void bench_memmove(uint8_t *src, uint8_t *dst, size_t n) {
+	(void)dst;
+	memmove(src + 8, src, n);
+}
+
+static void bench_memset(uint8_t *src, uint8_t *dst, size_t n) {
+	(void)src;
+	memset(dst, 0, n);
+}
+
+/*
+ * Prints the cycles per byte of @fn on the sizes of bench_mem_sizes.
+ */
+static void bench_mem_run(const char *what, void (*fn)(uint8_t *, uint8_t *, size_t),
+	uint8_t *src, uint8_t *dst) {
+	uint32_t loops, hundredths;
+	uint64_t t;
+	size_t n;
+
+	kprintf("  %s\n", what);
+	for (size_t i = 0; i < sizeof(bench_mem_sizes) / sizeof(*bench_mem_sizes); i++) {
+		n = bench_mem_sizes[i];
+		loops = BENCH_MEM_TOTAL / n;
+		t = rdtsc();
+		for (uint32_t j = 0; j < loops; j++)
+			fn(src, dst, n);
+		t = rdtsc() - t;
+		if (t >> 32) {
+			kprintf("    %u bytes: more than 2^32 cycles\n", n);
+			continue;
+		}
+		hundredths = (uint32_t)t / (BENCH_MEM_TOTAL / 100);
+		kprintf("    %u bytes: %u.%2u cycles/byte\n", n, hundredths / 100, hundredths % 100);
+	}
+}
+
+/*
+ * Measures memcpy, memmove and memset, with rep movsd/stosd and with rep
+ * movsb/stosb when the cpu has fast short string operations.
+ */
+static int bench_mem() {
+	uint8_t *src = vmalloc(BENCH_MEM_MAX + 64);
+	uint8_t *dst = vmalloc(BENCH_MEM_MAX + 64);
+	int erms;
+
+	if (src == NULL || dst == NULL) {
+		kprintf(BLTNAME ": cannot allocate the buffers\n");
+		vfree(src);
+		vfree(dst);
+		return -1;
+	}
+	memset(src, 1, BENCH_MEM_MAX + 64);
+	memset(dst, 0, BENCH_MEM_MAX + 64);
+	erms = mem_erms;
+	mem_erms = 0;
+	kprintf("rep movsd/stosd\n");
+	bench_mem_run("memcpy", bench_memcpy, src, dst + 1);
+	bench_mem_run("memmove", bench_memmove, src, dst);
+	bench_mem_run("memset", bench_memset, src, dst + 1);
+	if (erms) {
+		mem_erms = 1;
+		kprintf("rep movsb/stosb (ERMS)\n");
+		bench_mem_run("memcpy", bench_memcpy, src, dst + 1);
+		bench_mem_run("memset", bench_memset, src, dst + 1);
+	}
+	mem_erms = erms;
+	vfree(src);
+	vfree(dst);
+	return 0;
+}
+
+/*
+ * Prints the bytes per kilocycle of @n pages processed in @cycles
+ */
+static void bench_print_throughput(const char *what, uint64_t cycles, uint32_t n) {
+	uint32_t avg;
+
+	if (cycles >> 32) {
+		kprintf("%s: more than 2^32 cycles\n", what);
+		return;
+	}
+	avg = (uint32_t)cycles / n;
+	kprintf("%s: %u cycles/page, %u bytes/kcycle\n", what, avg, avg ? PAGE_SIZE * 1000 / avg : 0);
+}
+
+/*
+ * Copies, zeroes and checksums BENCH_PAGE_NPAGES pages, more than the
+ * cache holds, with the scalar code then with SSE2.
+ */
+static int bench_page() {
+	size_t size = BENCH_PAGE_NPAGES * PAGE_SIZE;
+	uint8_t *src = vmalloc(size);
+	uint8_t *dst = vmalloc(size);
+	int sse2 = fpu_sse2;
+	uint64_t t;
+
+	if (src == NULL || dst == NULL) {
+		kprintf(BLTNAME ": cannot allocate the buffers\n");
+		vfree(src);
+		vfree(dst);
+		return -1;
+	}
+	memset(src, 0x5a, size);
+	memset(dst, 0, size);
+	for (int mode = 0; mode <= sse2; mode++) {
+		fpu_sse2 = mode;
+		kprintf("%s\n", mode ? "SSE2" : "scalar");
+		t = rdtsc();
+		for (int r = 0; r < BENCH_PAGE_ROUNDS; r++) {
+			for (size_t off = 0; off < size; off += PAGE_SIZE)
+				copy_page(dst + off, src + off);
+		}
+		bench_print_throughput("    copy_page", rdtsc() - t, BENCH_PAGE_NPAGES * BENCH_PAGE_ROUNDS);
+		t = rdtsc();
+		for (int r = 0; r < BENCH_PAGE_ROUNDS; r++) {
+			for (size_t off = 0; off < size; off += PAGE_SIZE)
+				clear_page(dst + off);
+		}
+		bench_print_throughput("    clear_page", rdtsc() - t, BENCH_PAGE_NPAGES * BENCH_PAGE_ROUNDS);
+		t = rdtsc();
+		for (int r = 0; r < BENCH_PAGE_ROUNDS; r++) {
+			for (size_t off = 0; off < size; off += PAGE_SIZE)
+				csum(src + off, PAGE_SIZE);
+		}
+		bench_print_throughput("    csum", rdtsc() - t, BENCH_PAGE_NPAGES * BENCH_PAGE_ROUNDS);
+	}
+	fpu_sse2 = sse2;
+	if (!sse2)
+		kprintf("no SSE2\n");
+	vfree(src);
+	vfree(dst);
+	return 0;
+}
+
+/*
+ * Prints BENCH_SCROLL_LINES lines with kprintf, each scrolling the screen,
+ * copying the visible lines, moving the CRTC start address, then with the
+ * writes deferred to the timer. The lines per second come from the timer,
+ * at 1/TIMER_HZ second precision.
+ */
+static int bench_scroll() {
+	static const char *modes[] = {"copy", "CRTC start address", "deferred"};
+	int hwscroll = sb_hwscroll;
+	int deferred = sb_deferred;
+	uint64_t cycles[3];
+	uint32_t ticks[3];
+	uint32_t start;
+	uint64_t t;
+
+	for (int mode = 0; mode < 3; mode++) {
+		sb_hwscroll = mode != 0;
+		sb_set_deferred(mode == 2);
+		start = timer_ticks;
+		t = rdtsc();
+		for (int i = 0; i < BENCH_SCROLL_LINES; i++)
+			kprintf("%u: the quick brown fox jumps over the lazy dog\n", i);
+		cycles[mode] = rdtsc() - t;
+		ticks[mode] = timer_ticks - start;
+	}
+	sb_hwscroll = hwscroll;
+	sb_set_deferred(deferred);
+	for (int mode = 0; mode < 3; mode++) {
+		kprintf("%s\n", modes[mode]);
+		kprintf("    %u lines/s\n", BENCH_SCROLL_LINES * TIMER_HZ / (ticks[mode] ? ticks[mode] : 1));
+		bench_print_per_op("    kprintf line", cycles[mode], BENCH_SCROLL_LINES);
+	}
+	return 0;
+}
+
+/*
+ * Runs micro benchmarks of kernel subsystems.
+ */
+int bench(int argc, char **argv) {
+	if (argc < 2) {
+		usage();
+		return -1;
+	}
+	if (!strcmp(argv[1], "cow")) {
+		size_t mb = BENCH_COW_DFL_MB;
+		if (argc > 2) {
+			char *ptr;
+			mb = strtoul(argv[2], &ptr, 0);
+			if (*ptr || mb == 0) {
+				kprintf(BLTNAME ": size not well formatted\n");
+				return -1;
+			}
+		}
+		return bench_cow(mb);
+	} else if (!strcmp(argv[1], "kmap")) {
+		return bench_kmap();
+	} else if (!strcmp(argv[1], "numa")) {
+		return bench_numa();
+	} else if (!strcmp(argv[1], "tlsf")) {
+		return bench_tlsf();
+	} else if (!strcmp(argv[1], "mem")) {
+		return bench_mem();
+	} else if (!strcmp(argv[1], "page")) {
+		return bench_page();
+	} else if (!strcmp(argv[1], "scroll")) {
+		return bench_scroll();
+	}
+	kprintf(BLTNAME ": '%s' doesn't exist.\n", argv[1]);
+	return -1;
+}
@@ -6,14 +6,13 @@
  * Color builtin file
  *
  * created: 2022/12/08 - xlmod <glafond-@student.42.fr>
- * updated: 2022/12/15 - mrxx0 <chcoutur@student.42.fr>
+ * updated: 2026/10/19 - agent <agent@local>
  */
 
 #include <kernel/screenbuf.h>
 #include <kernel/print.h>
 #include <kernel/string.h>
 
-extern struct screenbuf sb[];
 extern struct screenbuf *sb_current;
 
 #define BLTNAME "color"
@@ -6,7 +6,7 @@
  * Hexdump builtin file
  *
  * created: 2022/12/09 - xlmod <glafond-@student.42.fr>
- * updated: 2022/12/19 - glafond- <glafond-@student.42.fr>
+ * updated: 2026/10/19 - agent <agent@local>
  */
 
 #include <stdint.h>
@@ -14,6 +14,9 @@
 #include <kernel/stdlib.h>
 #include <kernel/screenbuf.h>
 #include <kernel/print.h>
+#include <kernel/kpm.h>
+#include <kernel/vmm.h>
+#include <kernel/resource.h>
 
 #define BLTNAME "hexdump"
 
@@ -22,7 +25,6 @@
 #define C_INACTIVE	SB_DFL_FG_COLOR
 #define C_NONPRINT	SB_DFL_FG_COLOR
 
-extern struct screenbuf sb[];
 extern struct screenbuf *sb_current;
 
 static inline void usage() {
@@ -80,6 +82,37 @@ void hx_print(void *base, size_t size) {
 	sb_set_color(sb_current, color);
 }
 
+/*
+ * Returns 0 if the @size bytes at @addr can be read, that is if they are
+ * mapped on memory and not on a device, -1 otherwise
+ */
+static int hx_check(uint32_t addr, size_t size) {
+	struct page_table_entry *pte;
+	uint32_t phys;
+
+	if (size == 0)
+		return 0;
+	if (addr + size - 1 < addr) {
+		kprintf(BLTNAME ": Range wraps around the address space.\n");
+		return -1;
+	}
+	for (uint32_t page = ALIGN(addr, PAGE_SIZE); page <= addr + size - 1; page += PAGE_SIZE) {
+		pte = vmm_get_pte((void *)page);
+		if (pte == NULL || !pte->present) {
+			kprintf(BLTNAME ": %8p is not mapped.\n", page);
+			return -1;
+		}
+		phys = (uint32_t)pte->address << 12;
+		if (!resource_check(phys, PAGE_SIZE, RESOURCE_RAM | RESOURCE_RESERVED)) {
+			kprintf(BLTNAME ": %8p maps device memory at %8p.\n", page, phys);
+			return -1;
+		}
+		if (page + PAGE_SIZE < page)
+			break;
+	}
+	return 0;
+}
+
 int hexdump(int argc, char **argv) {
 	if (argc < 3) {
 		usage();
@@ -98,6 +131,8 @@ int hexdump(int argc, char **argv) {
 		return -1;
 	}
 
+	if (hx_check(addr, size) < 0)
+		return -1;
 	hx_print((void *)addr, size);
 
 	return 0;
@@ -6,13 +6,23 @@
  * Info builtin file
  *
  * created: 2022/12/09 - mrxx0 <chcoutur@student.42.fr>
- * updated: 2022/12/17 - xlmod <glafond-@student.42.fr>
+ * updated: 2026/10/19 - agent <agent@local>
  */ 
 
 #include <stdint.h>
 #include <kernel/print.h>
 #include <kernel/string.h>
 #include <kernel/kpm.h>
+#include <kernel/numa.h>
+#include <kernel/resource.h>
+#include <kernel/tlb.h>
+#include <kernel/vmm.h>
+#include <kernel/vmalloc.h>
+#include <kernel/zram.h>
+#include <kernel/ksm.h>
+#include <kernel/pgtable.h>
+#include <kernel/slab.h>
+#include <kernel/tlsf.h>
 #include <kernel/screenbuf.h>
 #include <kernel/stdlib.h>
 
@@ -24,7 +34,6 @@ extern t_gdt_entry *gdt;
 extern t_gdt_ptr gdtp;
 extern void *stack_bottom;
 extern void *stack_top;
-extern buddy_t *buddy;
 extern t_idt_entry idt[256];
 extern t_idt_ptr idtp;
 
@@ -36,7 +45,7 @@ extern struct screenbuf *sb_current;
 #define BLTNAME "info"
 
 static inline void usage() {
-	kprintf("Usage: " BLTNAME " [gdt/idt/stack/buddy/registers]\n");
+	kprintf("Usage: " BLTNAME " [gdt/idt/stack/buddy/numa/iomem/registers/tlb/fault/vmalloc/zram/ksm/lru/slab/tlsf]\n");
 }
 
 static void info_registers() {
@@ -66,14 +75,14 @@ static void info_idt() {
 	kprintf("Size = %u bytes\n", sizeof(idt));	
 }
 
-static void info_buddy_print_order(int order) {
+static void info_buddy_print_order(buddy_t *buddy, int order) {
 	uint8_t oldcolor = sb_get_color(sb_current);
 	kprintf("order %u(size of %u)\n", order, buddy->orders[order].size);
 	for (size_t i = 0; i < buddy->orders[order].size; i++) {
 		if (i % 32 == 0) {
 			kprintf("\n%4x  ", i);
 		}
-		bitmap_t val = buddy->orders[order].bitmap[i];
+		uint8_t val = ((uint8_t *)buddy->orders[order].bitmap)[i];
 		if (val == 0) {
 			sb_set_bg(sb_current, SB_COLOR_WHITE);
 			kprintf("  ");
@@ -91,14 +100,194 @@ static void info_buddy_print_order(int order) {
 }
 
 static void info_buddy(int order) {
+	buddy_t *buddy;
+
 	kprintf("INFO BUDDY\n");
-	kprintf("buddy address:        %p\n", buddy);
-	kprintf("buddy size:           %u KB\n", buddy->size / 1024);
-	kprintf("orders address:       %p\n", buddy->orders[0].bitmap);
-	kprintf("frame number:         %x\n", buddy->nframes);
-	kprintf("memory size:          %u KB\n", buddy->nframes << 2);
-	if (order >= 0)
-		info_buddy_print_order(order);
+	for (int node = 0; node < numa_nnodes; node++) {
+		buddy = kpm_nodes[node].buddy;
+		if (numa_nnodes > 1)
+			kprintf("node %u\n", node);
+		kprintf("buddy address:        %p\n", buddy);
+		kprintf("buddy size:           %u KB\n", buddy->size / 1024);
+		kprintf("orders address:       %p\n", buddy->orders[0].bitmap);
+		kprintf("first frame:          %x\n", buddy->base);
+		kprintf("frame number:         %x\n", buddy->nframes);
+		kprintf("memory size:          %u KB\n", buddy->nframes << 2);
+		if (order >= 0)
+			info_buddy_print_order(buddy, order);
+	}
+}
+
+static void info_numa() {
+	struct kpm_node *node;
+
+	kprintf("INFO NUMA\n");
+	kprintf("nodes:                %u\n", numa_nnodes);
+	kprintf("cpu node:             %u\n", numa_node_id());
+	kprintf("policy:               %s\n", kpm_policy == KPM_BIND ? "bind" : "preferred");
+	for (int i = 0; i < numa_nranges; i++) {
+		// The padding of %8p would apply to the node as well
+		kprintf("range:                %8p-%8p", numa_ranges[i].start << 12,
+			(numa_ranges[i].end << 12) - 1);
+		kprintf(" node %u\n", numa_ranges[i].node);
+	}
+	for (int i = 0; i < numa_nnodes; i++) {
+		node = kpm_nodes + i;
+		kprintf("node %u\n", i);
+		kprintf("    free:             %u KB\n", node->free * (PAGE_SIZE / 1024));
+		kprintf("    hits:             %u\n", node->hits);
+		kprintf("    misses:           %u\n", node->misses);
+		kprintf("    foreign:          %u\n", node->foreign);
+		kprintf("    distances:       ");
+		for (int j = 0; j < numa_nnodes; j++)
+			kprintf(" %u", numa_distance[i][j]);
+		kprintf("\n");
+	}
+}
+
+static void info_iomem_print(struct resource *res, int depth) {
+	for (; res; res = res->sibling) {
+		for (int i = 0; i < depth; i++)
+			kprintf("  ");
+		kprintf("%8p-%8p : %s\n", res->start, res->end, res->name);
+		info_iomem_print(res->child, depth + 1);
+	}
+}
+
+static void info_iomem() {
+	kprintf("INFO IOMEM\n");
+	info_iomem_print(iomem_resource.child, 0);
+}
+
+static void info_tlb() {
+	kprintf("INFO TLB\n");
+	kprintf("flush ceiling:        %u pages\n", tlb_flush_ceiling);
+	kprintf("invlpg:               %u\n", tlb_stats.invlpg);
+	kprintf("full flushes:         %u\n", tlb_stats.full);
+	kprintf("freed page tables:    %u\n", tlb_stats.tables);
+	kprintf("freed pages:          %u\n", tlb_stats.pages);
+	kprintf("quicklist:            %u/%u tables\n", pgtable_cached(), PGTABLE_MAX);
+	kprintf("quicklist hits:       %u\n", pgtable_stats.hits);
+	kprintf("quicklist misses:     %u\n", pgtable_stats.misses);
+	kprintf("recycled tables:      %u\n", pgtable_stats.recycled);
+	kprintf("prezeroed tables:     %u\n", pgtable_stats.refilled);
+}
+
+static void info_fault() {
+	kprintf("INFO FAULT\n");
+	kprintf("faults:               %u\n", vmm_fault_stats.faults);
+	kprintf("zero-filled pages:    %u\n", vmm_fault_stats.zerofill);
+	kprintf("mapped pages:         %u\n", vmm_fault_stats.mapped);
+	kprintf("cow copied pages:     %u\n", vmm_fault_stats.cow_copied);
+	kprintf("cow reused pages:     %u\n", vmm_fault_stats.cow_reused);
+	kprintf("swapped out pages:    %u\n", vmm_fault_stats.swapped_out);
+	kprintf("swapped in pages:     %u\n", vmm_fault_stats.swapped_in);
+	kprintf("failed:               %u\n", vmm_fault_stats.failed);
+	kprintf("latency (cycles):\n");
+	for (int i = 0; i < VMM_FAULT_NBUCKETS; i++) {
+		if (vmm_fault_stats.latency[i] == 0)
+			continue;
+		if (i == 0)
+			kprintf("    < %u: %u\n", 1 << VMM_FAULT_MINSHIFT, vmm_fault_stats.latency[i]);
+		else if (i == VMM_FAULT_NBUCKETS - 1)
+			kprintf("    >= %u: %u\n", 1 << (VMM_FAULT_MINSHIFT + i - 1), vmm_fault_stats.latency[i]);
+		else
+			kprintf("    %u - %u: %u\n", 1 << (VMM_FAULT_MINSHIFT + i - 1),
+				(1 << (VMM_FAULT_MINSHIFT + i)) - 1, vmm_fault_stats.latency[i]);
+	}
+}
+
+static void info_vmalloc() {
+	size_t total = 0;
+
+	kprintf("INFO VMALLOC\n");
+	for (struct vmalloc_area *area = vmalloc_areas(); area != NULL; area = area->next) {
+		kprintf("%8p - %8p", area->addr, area->addr + area->size);
+		kprintf("  %u KB%s\n", area->size / 1024, area->owned ? "" : " (vmap)");
+		total += area->size;
+	}
+	kprintf("total:                %u KB\n", total / 1024);
+}
+
+/*
+ * Prints the average cycles per page of @n operations that took @cycles,
+ * and the matching throughput in bytes per thousand cycles.
+ */
+static void info_zram_speed(const char *what, uint64_t cycles, uint32_t n) {
+	uint32_t avg;
+
+	if (n == 0 || cycles >> 32) {
+		kprintf("%s-\n", what);
+		return;
+	}
+	avg = (uint32_t)cycles / n;
+	kprintf("%s%u cycles/page, %u bytes/kcycle\n", what, avg, avg ? PAGE_SIZE * 1000 / avg : 0);
+}
+
+static void info_zram() {
+	uint32_t ratio = 0;
+
+	if (zram_stats.compr_size)
+		ratio = zram_stats.stored * (PAGE_SIZE / 4) * 100 / (zram_stats.compr_size / 4);
+	kprintf("INFO ZRAM\n");
+	kprintf("stored pages:         %u\n", zram_stats.stored);
+	kprintf("compressed size:      %u KB\n", zram_stats.compr_size / 1024);
+	kprintf("compression ratio:    %u.%2u\n", ratio / 100, ratio % 100);
+	kprintf("pool pages:           %u\n", zram_stats.pool_pages);
+	kprintf("rejected pages:       %u\n", zram_stats.rejected);
+	info_zram_speed("compression:          ", zram_stats.compr_cycles, zram_stats.compressed);
+	info_zram_speed("decompression:        ", zram_stats.decompr_cycles, zram_stats.decompressed);
+}
+
+static void info_ksm() {
+	kprintf("INFO KSM\n");
+	kprintf("pages per tick:       %u\n", ksm_pages_to_scan);
+	kprintf("scanned pages:        %u\n", ksm_stats.scanned);
+	kprintf("full scans:           %u\n", ksm_stats.full_scans);
+	kprintf("merged pages:         %u\n", ksm_stats.merged);
+	kprintf("pages shared:         %u\n", ksm_stats.shared);
+	kprintf("pages sharing:        %u\n", ksm_stats.sharing);
+	kprintf("pages saved:          %u\n", ksm_stats.sharing - ksm_stats.shared);
+	kprintf("scan time:            %u Mcycles\n", (uint32_t)(ksm_stats.cycles >> 20));
+	if (ksm_stats.scanned && !(ksm_stats.cycles >> 32))
+		kprintf("scan cost:            %u cycles/page\n", (uint32_t)ksm_stats.cycles / ksm_stats.scanned);
+}
+
+static void info_lru() {
+	struct vmm_lru *lru = &vmm_current->lru;
+
+	kprintf("INFO LRU\n");
+	kprintf("active pages:         %u\n", lru->lists[LRU_ACTIVE].count);
+	kprintf("inactive pages:       %u\n", lru->lists[LRU_INACTIVE].count);
+	kprintf("working set:          %u pages (%u KB)\n", lru->wss, lru->wss * (PAGE_SIZE / 1024));
+}
+
+static void info_slab() {
+	struct kmem_cache *cache;
+	uint32_t rate;
+
+	kprintf("INFO SLAB\n");
+	for (int i = 0; i < slab_ncaches; i++) {
+		cache = slab_caches + i;
+		if (cache->allocs == 0)
+			rate = 0;
+		else if (cache->allocs < 0x1000000)
+			rate = cache->hits * 100 / cache->allocs;
+		else
+			rate = cache->hits / (cache->allocs / 100);
+		kprintf("%s: %u/%u objects of %u bytes, %u slabs of %u KB (%u empty), %u%% hits\n",
+			cache->name, cache->active, cache->nslabs * cache->objs_per_slab, cache->size,
+			cache->nslabs, (PAGE_SIZE << cache->order) / 1024, cache->nempty, rate);
+	}
+}
+
+static void info_tlsf() {
+	kprintf("INFO TLSF\n");
+	kprintf("pool:                 %u KB\n", rtheap.size / 1024);
+	kprintf("used:                 %u bytes (%u max)\n", rtheap.used, rtheap.max_used);
+	kprintf("largest free block:   %u bytes\n", tlsf_largest(&rtheap));
+	kprintf("allocations:          %u (%u failed)\n", rtheap.allocs, rtheap.failures);
+	kprintf("releases:             %u\n", rtheap.frees);
 }
 
 static void info_stack() {
@@ -144,10 +333,30 @@ int info(int argc, char **argv) {
 		} else {
 			info_buddy(-1);
 		}
+	} else if (!strcmp(argv[1], "numa")) {
+		info_numa();
+	} else if (!strcmp(argv[1], "iomem")) {
+		info_iomem();
 	} else if (!strcmp(argv[1], "idt")) {
 		info_idt();
 	} else if (!strcmp(argv[1], "registers")) {
 		info_registers();
+	} else if (!strcmp(argv[1], "tlb")) {
+		info_tlb();
+	} else if (!strcmp(argv[1], "fault")) {
+		info_fault();
+	} else if (!strcmp(argv[1], "vmalloc")) {
+		info_vmalloc();
+	} else if (!strcmp(argv[1], "zram")) {
+		info_zram();
+	} else if (!strcmp(argv[1], "ksm")) {
+		info_ksm();
+	} else if (!strcmp(argv[1], "lru")) {
+		info_lru();
+	} else if (!strcmp(argv[1], "slab")) {
+		info_slab();
+	} else if (!strcmp(argv[1], "tlsf")) {
+		info_tlsf();
 	} else {
 		kprintf(BLTNAME ": '%s' doesn't exist.\n", argv[1]);
 		return -1;
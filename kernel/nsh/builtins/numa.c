@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* kernel/nsh/builtins/numa.c
+ *
+ * Numa builtin file
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/kpm.h>
+#include <kernel/print.h>
+#include <kernel/string.h>
+
+#define BLTNAME "numa"
+
+static inline void usage() {
+	kprintf("Usage: " BLTNAME " POLICY\n");
+	kprintf("       " BLTNAME " list\n");
+}
+
+/*
+ * Selects what page frame allocations do when the node of the cpu is out
+ * of memory.
+ */
+int numa(int argc, char **argv) {
+	struct {
+		char *name;
+		enum kpm_policy policy;
+		char *desc;
+	} policies[] = {
+		{"preferred", KPM_PREFERRED, "fall back to the nearest node"},
+		{"bind", KPM_BIND, "fail"},
+		{NULL, 0, NULL},
+	};
+	if (argc < 2) {
+		usage();
+		return -1;
+	}
+	if (!strcmp(argv[1], "list")) {
+		kprintf("Policy:\n");
+		for (int i = 0; policies[i].name != NULL; i++) {
+			kprintf("%c %s: %s\n", kpm_policy == policies[i].policy ? '*' : '-',
+				policies[i].name, policies[i].desc);
+		}
+		return 0;
+	}
+	for (int i = 0; policies[i].name != NULL; i++) {
+		if (!strcmp(argv[1], policies[i].name)) {
+			kpm_policy = policies[i].policy;
+			return 0;
+		}
+	}
+	kprintf(BLTNAME ": Policy '%s' not found.\n", argv[1]);
+	return -1;
+}
@@ -6,18 +6,15 @@
  * Utilitary builtins (clear/next/prev/help) file
  *
  * created: 2022/12/08 - xlmod <glafond-@student.42.fr>
- * updated: 2022/12/15 - mrxx0 <chcoutur@student.42.fr>
+ * updated: 2026/10/19 - agent <agent@local>
  */
 
 #include <kernel/print.h>
 #include <kernel/screenbuf.h>
+#include <kernel/vt.h>
 #include <kernel/nsh.h>
 #include <kernel/stdlib.h>
 
-extern struct screenbuf sb[];
-extern struct screenbuf *sb_current;
-extern int sb_nbscreen;
-
 extern struct builtin builtin[];
 
 /*
@@ -32,22 +29,14 @@ int clear(__attribute__ ((unused)) int argc, __attribute__ ((unused)) char **arg
  * Next screen.
  */
 int next(__attribute__ ((unused)) int argc, __attribute__ ((unused)) char **argv) {
-	sb_unload(sb_current++);
-	if ((sb_current - sb) == sb_nbscreen)
-		sb_current = sb;
-	sb_load(sb_current);
-	return 0;
+	return vt_switch(vt_next(vt_current(), 1));
 }
 
 /*
  * Prev screen.
  */
 int prev(__attribute__ ((unused)) int argc, __attribute__ ((unused)) char **argv) {
-	sb_unload(sb_current--);
-	if (sb_current < sb)
-		sb_current = sb + (sb_nbscreen - 1);
-	sb_load(sb_current);
-	return 0;
+	return vt_switch(vt_next(vt_current(), -1));
 }
 
 /*
@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* kernel/nsh/builtins/vt.c
+ *
+ * Virtual terminals builtin file
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/vt.h>
+#include <kernel/print.h>
+#include <kernel/string.h>
+#include <kernel/stdlib.h>
+
+#define BLTNAME "vt"
+
+static inline void usage() {
+	kprintf("Usage: " BLTNAME " list\n");
+	kprintf("       " BLTNAME " new [LINES]\n");
+	kprintf("       " BLTNAME " close N\n");
+	kprintf("       " BLTNAME " defer [on|off]\n");
+	kprintf("       " BLTNAME " N\n");
+}
+
+/*
+ * Returns the number in @s, or 0 if it is not well formatted
+ */
+static size_t vt_parse(char *s) {
+	char *ptr;
+	size_t n = strtoul(s, &ptr, 0);
+
+	return *ptr ? 0 : n;
+}
+
+/*
+ * Prints the open terminals, numbered from 1 as Alt+F1 shows the first
+ */
+static int vt_list() {
+	struct screenbuf *sb;
+
+	for (int n = 0; n < VT_MAX; n++) {
+		if ((sb = vt_get(n)) == NULL)
+			continue;
+		kprintf("%c %u: %u lines, %u KB\n", n == vt_current() ? '*' : '-',
+			n + 1, sb->nlines, sb->mapped / 1024);
+	}
+	return 0;
+}
+
+/*
+ * Turns the deferred console writes on or off: when on, the terminal shown
+ * is copied to VGA memory by the timer, SB_FLUSH_HZ times per second.
+ */
+static int vt_defer(int argc, char **argv) {
+	if (argc < 3) {
+		kprintf(BLTNAME ": deferred writes %s\n", sb_deferred ? "on" : "off");
+		return 0;
+	}
+	if (!strcmp(argv[2], "on"))
+		sb_set_deferred(1);
+	else if (!strcmp(argv[2], "off"))
+		sb_set_deferred(0);
+	else {
+		usage();
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * Opens, closes and shows virtual terminals, and sets how the console
+ * writes reach the screen.
+ */
+int vt(int argc, char **argv) {
+	size_t n;
+	int term;
+
+	if (argc < 2) {
+		usage();
+		return -1;
+	}
+	if (!strcmp(argv[1], "list"))
+		return vt_list();
+	if (!strcmp(argv[1], "defer"))
+		return vt_defer(argc, argv);
+	if (!strcmp(argv[1], "new")) {
+		n = VT_DFL_LINES;
+		if (argc > 2 && ((n = vt_parse(argv[2])) < VT_MIN_LINES || n > VT_MAX_LINES)) {
+			kprintf(BLTNAME ": between %u and %u lines\n", VT_MIN_LINES, VT_MAX_LINES);
+			return -1;
+		}
+		if ((term = vt_open(-1, n)) < 0) {
+			kprintf(BLTNAME ": cannot open a terminal\n");
+			return -1;
+		}
+		return vt_switch(term);
+	}
+	if (!strcmp(argv[1], "close")) {
+		if (argc < 3 || (n = vt_parse(argv[2])) == 0 || vt_close(n - 1) < 0) {
+			kprintf(BLTNAME ": cannot close this terminal\n");
+			return -1;
+		}
+		return 0;
+	}
+	if ((n = vt_parse(argv[1])) == 0 || vt_switch(n - 1) < 0) {
+		kprintf(BLTNAME ": '%s' is not an open terminal\n", argv[1]);
+		return -1;
+	}
+	return 0;
+}
@@ -6,19 +6,18 @@
  * Nulix shell
  *
  * created: 2022/12/07 - xlmod <glafond-@student.42.fr>
- * updated: 2022/12/16 - glafond- <glafond-@student.42.fr>
+ * updated: 2026/10/19 - agent <agent@local>
  */
 
 #include <kernel/string.h>
+#include <kernel/stdlib.h>
 #include <kernel/print.h>
 #include <kernel/screenbuf.h>
+#include <kernel/vt.h>
 #include <kernel/nsh.h>
 #include <kernel/keyboard.h>
 #include <kernel/builtins.h>
 
-extern struct screenbuf sb[];
-extern struct screenbuf *sb_current;
-
 // Buffer where the user input is stored
 char nsh_buf[NSH_BUFSIZE];
 // Buffer where the splitted cmd is stored
@@ -27,8 +26,11 @@ char *nsh_cmd[NSH_BUFSIZE / 2 + 1];
 int nsh_cmdnarg;
 int nsh_bufindex;
 
+struct arena nsh_arena = ARENA_INIT;
+
 /*
- * Array of struct builtin with a function pointer to each builtin
+ * Array of struct builtin with a function pointer to each builtin, sorted
+ * by name when nsh starts
  */
 struct builtin builtin[] = {
 	{"reboot", reboot, "Reboot the machine"},
@@ -45,6 +47,9 @@ struct builtin builtin[] = {
 	{"prev", prev, "Switch to prev screen buffer"},
 	{"help", help, "Print help"},
 	{"interrupt", interrupt, "Raise an interrupt"},
+	{"bench", bench, "Run kernel micro benchmarks"},
+	{"numa", numa, "Set the memory node fallback policy"},
+	{"vt", vt, "Open, close and switch virtual terminals, defer their writes"},
 	{NULL, NULL, NULL},
 };
 
@@ -95,27 +100,72 @@ static void nsh_createcmd() {
 	nsh_cmdnarg = icmd;
 }
 
+// Number of builtins, without the NULL terminator
+#define NSH_NBUILTINS	(sizeof(builtin) / sizeof(struct builtin) - 1)
+
+static int nsh_cmpbuiltin(const void *a, const void *b) {
+	return strcmp(((const struct builtin *)a)->name, ((const struct builtin *)b)->name);
+}
+
+static int nsh_findbuiltin(const void *name, const void *b) {
+	return strcmp(name, ((const struct builtin *)b)->name);
+}
+
 /*
- * Iterrate through all builtins and if the first element of the cmd buffer
- * is equal to a builtin name, execute the function.
+ * Search the builtin named like the first element of the cmd buffer and
+ * execute its function.
+ * The builtin gets a fresh nsh_arena, reset when it returns.
  */
 static void nsh_execcmd() {
-	int n = sizeof(builtin) / sizeof(struct builtin);
+	struct builtin *cmd;
+	struct arena_mark mark;
+
 	if (nsh_cmd[0] == NULL)
 		return;
-	for (int i = 0; i < n; i++) {
-		if (strcmp(nsh_cmd[0], builtin[i].name) == 0) {
-			builtin[i].exec(nsh_cmdnarg, (char **)nsh_cmd);
-			return;
-		}
+	cmd = bsearch(nsh_cmd[0], builtin, NSH_NBUILTINS, sizeof(struct builtin), nsh_findbuiltin);
+	if (cmd == NULL) {
+		kprintf("nsh: %s: command not found\n", nsh_cmd[0]);
+		return;
 	}
-	kprintf("nsh: %s: command not found\n", nsh_cmd[0]);
+	mark = arena_mark(&nsh_arena);
+	cmd->exec(nsh_cmdnarg, (char **)nsh_cmd);
+	arena_reset(&nsh_arena, mark);
+}
+
+/*
+ * Returns the terminal of the function key @key, Alt+F1 showing the
+ * first one, or -1
+ */
+static int nsh_fkey(enum kbd_keycode key) {
+	if (key >= KEY_F1 && key <= KEY_F10)
+		return key - KEY_F1;
+	if (key == KEY_F11 || key == KEY_F12)
+		return 10 + key - KEY_F11;
+	return -1;
+}
+
+/*
+ * Shows the terminal @n, opening it if needed, with a new prompt
+ */
+static void nsh_switchvt(int n) {
+	if (n == vt_current())
+		return;
+	if (vt_get(n) == NULL && vt_open(n, VT_DFL_LINES) < 0)
+		return;
+	vt_switch(n);
+	if (sb_current->cursor_offset != 0)
+		kprintf("\n");
+	nsh_newline();
 }
 
 /*
  * Handle non character input
  */
 static void nsh_shortcut(struct kbd_event *evt) {
+	if (kbd_st.modifiers.lalt && nsh_fkey(evt->key) >= 0) {
+		nsh_switchvt(nsh_fkey(evt->key));
+		return;
+	}
 	switch (evt->key) {
 		case KEY_CURSOR_UP:
 			sb_scroll(sb_current, -1);
@@ -186,6 +236,7 @@ void nsh() {
 	struct kbd_event evt;
 	char c;
 
+	qsort(builtin, NSH_NBUILTINS, sizeof(struct builtin), nsh_cmpbuiltin);
 	nsh_newline();
 	while (1) {
 		KBD_geteventbytype(&evt, KEY_PRESSED);
@@ -6,7 +6,7 @@
  * Implements some functions to print format strings
  *
  * created: 2022/10/15 - lfalkau <lfalkau@student.42.fr>
- * updated: 2022/12/09 - xlmod <glafond-@student.42.fr>
+ * updated: 2026/10/19 - agent <agent@local>
  */
 
 #include <stdarg.h>
@@ -15,7 +15,6 @@
 
 #define BUFSIZE 4096
 
-extern struct screenbuf sb[];
 extern struct screenbuf *sb_current;
 
 /*
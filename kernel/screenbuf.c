@@ -4,13 +4,52 @@
  * graphic information, and keep track of several metadata
  * (cursor, color, current view window...)
  *
+ * The visible lines of the loaded screenbuf are a window of the VGA text
+ * memory, starting at the line vga_origin. Scrolling moves the window
+ * and the CRTC start address along, only the lines coming into view are
+ * written. The window is copied back to the other end of the text memory
+ * when it reaches one.
+ *
+ * The lines of a screenbuf are a ring in a virtual area, backed by page
+ * frames from kpm as the cursor reaches them: the first screen is backed
+ * by sb_init, the lines after it on demand. When no frame is left, the
+ * ring ends at the last line backed.
+ *
+ * Changes to the VGA memory are recorded as dirty lines of the viewport
+ * and lines it scrolled, flushed right away or, in the deferred mode, by
+ * the timer interrupt. Writers disable interrupts while they update the
+ * screenbuf.
+ *
  * created: 2022/10/19 - xlmod <glafond-@student.42.fr>
- * updated: 2022/10/19 - xlmod <glafond-@student.42.fr>
+ * updated: 2026/10/19 - agent <agent@local>
  */
 
 #include <kernel/port.h>
 #include <kernel/screenbuf.h>
 #include <kernel/string.h>
+#include <kernel/cpu.h>
+#include <kernel/timer.h>
+#include <kernel/kpm.h>
+#include <kernel/vmm.h>
+#include <kernel/tlb.h>
+
+int sb_hwscroll = 1;
+int sb_deferred;
+
+// Line of the VGA text memory shown at the top of the screen
+static unsigned int vga_origin;
+
+// Position of the hardware cursor in the VGA text memory
+#define VGA_CURSOR_HIDDEN	0xffffffff
+#define VGA_CURSOR_UNKNOWN	0xfffffffe
+static uint32_t vga_cursor = VGA_CURSOR_UNKNOWN;
+
+// Loaded screenbuf, and the changes of its viewport not in VGA memory yet
+#define VGA_DIRTY_ALL	((1U << VGA_HEIGHT) - 1)
+#define SB_FLUSH_TICKS	(TIMER_HZ / SB_FLUSH_HZ)
+static struct screenbuf *vga_sb;
+static uint32_t vga_dirty;
+static int vga_scroll;
 
 /*
  * TODO: Move this function to stdlib 
@@ -42,19 +81,48 @@ static void cursor_disable() {
 
 /*
  * Enable or disable the cursor weither or not the
- * cursor position is into the VGA buffer area, and
- * set it's position to @pos
+ * cursor position is into the visible window, and
+ * set it's position to @pos in it
+ * The ports are only written when the cursor changed.
  */
 static void cursor_update(uint32_t pos) {
-	if (pos < VGA_WIDTH * SB_HEIGHT) {
-		cursor_enable();
+	uint32_t cursor = VGA_CURSOR_HIDDEN;
+
+	if (pos < VGA_WIDTH * VGA_HEIGHT)
+		cursor = pos + vga_origin * VGA_WIDTH;
+	if (cursor == vga_cursor)
+		return;
+	if (cursor == VGA_CURSOR_HIDDEN) {
+		cursor_disable();
+	} else {
+		if (vga_cursor == VGA_CURSOR_HIDDEN || vga_cursor == VGA_CURSOR_UNKNOWN)
+			cursor_enable();
 		port_write_u8(SB_CURSOR_PORT1, 0x0f);
-		port_write_u8(SB_CURSOR_PORT2, (uint8_t)(pos & 0xff));
+		port_write_u8(SB_CURSOR_PORT2, (uint8_t)(cursor & 0xff));
 		port_write_u8(SB_CURSOR_PORT1, 0x0e);
-		port_write_u8(SB_CURSOR_PORT2, (uint8_t)((pos >> 8) & 0xff));
-	} else {
-		cursor_disable();
+		port_write_u8(SB_CURSOR_PORT2, (uint8_t)((cursor >> 8) & 0xff));
 	}
+	vga_cursor = cursor;
+}
+
+/*
+ * Returns the address of the line @line of the VGA text memory
+ */
+static inline uint16_t *vga_line(unsigned int line) {
+	return VGA_PTR + line * VGA_WIDTH;
+}
+
+/*
+ * Shows the VGA text memory from the line @origin
+ */
+static void vga_set_origin(unsigned int origin) {
+	uint16_t start = origin * VGA_WIDTH;
+
+	vga_origin = origin;
+	port_write_u8(SB_CURSOR_PORT1, SB_CRTC_START_HIGH);
+	port_write_u8(SB_CURSOR_PORT2, (uint8_t)(start >> 8));
+	port_write_u8(SB_CURSOR_PORT1, SB_CRTC_START_LOW);
+	port_write_u8(SB_CURSOR_PORT2, (uint8_t)(start & 0xff));
 }
 
 /*
@@ -100,47 +168,213 @@ static uint16_t *sb_addline(struct screenbuf *sb, uint16_t *a, int n) {
 }
 
 /*
- * Inits the given screenbuf
+ * Backs the lines of the given screenbuf up to @end with page frames
+ * Returns 0 on success, -1 when out of memory
+ */
+static int sb_grow(struct screenbuf *sb, uint16_t *end) {
+	uint8_t *va = (uint8_t *)sb->buf + sb->mapped;
+	kpm_chunk_t chunk;
+
+	for (; va < (uint8_t *)end; va += PAGE_SIZE) {
+		if (kpm_alloc(&chunk, PAGE_SIZE) < 0)
+			return -1;
+		if (vmm_map(va, chunk.addr, VMM_WRITE) < 0) {
+			kpm_free(&chunk);
+			return -1;
+		}
+		sb->mapped += PAGE_SIZE;
+	}
+	return 0;
+}
+
+/*
+ * Gives the frames backing the given screenbuf after its first @size
+ * bytes back to kpm
  */
-void sb_init(struct screenbuf *sb) {
+static void sb_shrink(struct screenbuf *sb, size_t size) {
+	struct tlb_gather tlb;
+
+	if (sb->mapped <= size)
+		return;
+	tlb_gather_init(&tlb);
+	vmm_zap(&tlb, (uint8_t *)sb->buf + size, sb->mapped - size);
+	tlb_finish(&tlb);
+	sb->mapped = size;
+}
+
+/*
+ * Empties the given screenbuf, keeping the frames of its first screen
+ */
+static void sb_reset(struct screenbuf *sb) {
+	sb_shrink(sb, ALIGNNEXT(VGA_WIDTH * SB_MIN_LINES * 2, PAGE_SIZE));
 	sb->top = sb->buf;
 	sb->viewport = sb->buf;
 	sb->cursor = sb->buf;
 	sb->cursor_offset = 0;
-	sb_memset(sb->buf, SB_WHITESPACE, VGA_WIDTH * SB_HEIGHT);
+	sb->endbuf = sb->buf + VGA_WIDTH * sb->nlines;
+	sb_memset(sb->buf, SB_WHITESPACE, VGA_WIDTH * SB_MIN_LINES);
+}
+
+/*
+ * Inits the given screenbuf, with a ring of @nlines lines at @buf
+ */
+int sb_init(struct screenbuf *sb, uint16_t *buf, size_t nlines) {
+	if (nlines <= SB_MIN_LINES)
+		return -1;
+	sb->buf = buf;
+	sb->nlines = nlines;
+	sb->mapped = 0;
 	sb->color = SB_DFL_COLOR;
-	sb->endbuf = sb->buf + (VGA_WIDTH * SB_HEIGHT);
 	sb->loaded = 0;
-	sb_memset(sb->buf, SB_WHITESPACE, VGA_WIDTH * SB_HEIGHT);
+	if (sb_grow(sb, buf + VGA_WIDTH * SB_MIN_LINES) < 0) {
+		sb_shrink(sb, 0);
+		return -1;
+	}
+	sb_reset(sb);
+	return 0;
+}
+
+void sb_destroy(struct screenbuf *sb) {
+	sb_shrink(sb, 0);
+}
+
+/*
+ * Brings the VGA text memory up to date with the loaded screenbuf: the
+ * window moves by the lines the viewport scrolled, then the dirty lines
+ * are copied. The window is copied whole when it can't move.
+ */
+static void vga_flush(struct screenbuf *sb) {
+	int origin = (int)vga_origin + vga_scroll;
+
+	if (!sb_hwscroll) {
+		origin = 0;
+		if (vga_scroll || vga_origin)
+			vga_dirty = VGA_DIRTY_ALL;
+	} else if (abs(vga_scroll) >= VGA_HEIGHT) {
+		origin = vga_origin;
+		vga_dirty = VGA_DIRTY_ALL;
+	} else if (origin < 0) {
+		// Out of the text memory, start again from its other end
+		origin = VGA_MEM_LINES - VGA_HEIGHT;
+		vga_dirty = VGA_DIRTY_ALL;
+	} else if (origin > VGA_MEM_LINES - VGA_HEIGHT) {
+		origin = 0;
+		vga_dirty = VGA_DIRTY_ALL;
+	}
+	for (int i = 0; vga_dirty; i++) {
+		if (vga_dirty & (1U << i))
+			memcpy(vga_line(origin + i), sb_addline(sb, sb->viewport, i), VGA_WIDTH * 2);
+		vga_dirty &= ~(1U << i);
+	}
+	if ((unsigned int)origin != vga_origin)
+		vga_set_origin(origin);
+	vga_scroll = 0;
 }
 
 /*
  * Synchronize the VGA buffer content with the given screenbuf if loaded
  */
 static void sb_sync(struct screenbuf *sb) {
-	uint32_t pos;
+	if (!sb->loaded)
+		return;
+	vga_dirty = VGA_DIRTY_ALL;
+	if (!sb_deferred)
+		vga_flush(sb);
+}
 
-	if (sb->loaded) {
-		for (uint16_t i = 0; i < VGA_HEIGHT; i++)
-			memcpy(VGA_PTR + (i * VGA_WIDTH), sb_addline(sb, sb->viewport, i), VGA_WIDTH * 2);
-		pos = sb_diff(sb, sb->viewport, sb->cursor) + sb->cursor_offset;
-		cursor_update(pos);
+/*
+ * Synchronize the VGA buffer content with the given screenbuf if loaded,
+ * after its viewport moved @n lines: the window moves @n lines in the VGA
+ * text memory, and only the lines coming into view are copied.
+ */
+static void sb_sync_scroll(struct screenbuf *sb, int n) {
+	if (!sb->loaded)
+		return;
+	vga_scroll += n;
+	if (abs(n) >= VGA_HEIGHT)
+		vga_dirty = VGA_DIRTY_ALL;
+	else if (n > 0)
+		vga_dirty = (vga_dirty >> n) | (VGA_DIRTY_ALL & ~(VGA_DIRTY_ALL >> n));
+	else
+		vga_dirty = ((vga_dirty << -n) & VGA_DIRTY_ALL) | ((1U << -n) - 1);
+	if (!sb_deferred)
+		vga_flush(sb);
+}
+
+/*
+ * Writes the @n words at @cell, at the offset @offset of the line @line of
+ * the viewport of the given screenbuf, to the VGA buffer if loaded and
+ * visible, or marks the line dirty when writes are deferred.
+ */
+static void sb_sync_cells(struct screenbuf *sb, ptrdiff_t line, int offset,
+		uint16_t *cell, size_t n) {
+	if (!sb->loaded || line >= VGA_HEIGHT)
+		return;
+	if (sb_deferred)
+		vga_dirty |= 1U << line;
+	else
+		memcpy(vga_line(vga_origin + line) + offset, cell, n * 2);
+}
+
+/*
+ * Moves the hardware cursor to the cursor of the given screenbuf if loaded
+ * The VGA buffer is synchronized without it, it is moved once at the end of
+ * each operation.
+ */
+static void sb_sync_cursor(struct screenbuf *sb) {
+	if (sb->loaded && !sb_deferred)
+		cursor_update(sb_diff(sb, sb->viewport, sb->cursor) + sb->cursor_offset);
+}
+
+void sb_flush_tick() {
+	struct screenbuf *sb = vga_sb;
+
+	if (sb == NULL || timer_ticks % SB_FLUSH_TICKS)
+		return;
+	vga_flush(sb);
+	cursor_update(sb_diff(sb, sb->viewport, sb->cursor) + sb->cursor_offset);
+}
+
+/*
+ * Turns deferred writes on or off. The lines left dirty are flushed when
+ * writes go back to VGA memory right away.
+ */
+void sb_set_deferred(int on) {
+	struct screenbuf *sb = vga_sb;
+	uint32_t flags = cpu_irq_save();
+
+	sb_deferred = on;
+	if (!on && sb != NULL) {
+		vga_flush(sb);
+		cursor_update(sb_diff(sb, sb->viewport, sb->cursor) + sb->cursor_offset);
 	}
+	cpu_irq_restore(flags);
 }
 
 /*
  * Loads the given screenbuf to the VGA buffer
  */
 void sb_load(struct screenbuf *sb) {
+	uint32_t flags = cpu_irq_save();
+
 	sb->loaded = 1;
+	vga_sb = sb;
+	vga_scroll = 0;
 	sb_sync(sb);
+	sb_sync_cursor(sb);
+	cpu_irq_restore(flags);
 }
 
 /*
  * Unloads a screenbuffer
  */
 void sb_unload(struct screenbuf *sb) {
+	uint32_t flags = cpu_irq_save();
+
 	sb->loaded = 0;
+	if (vga_sb == sb)
+		vga_sb = NULL;
+	cpu_irq_restore(flags);
 }
 
 /*
@@ -173,13 +407,33 @@ uint8_t sb_get_color(struct screenbuf *sb) {
 }
 
 /*
- * Makes the screenbuf scrolls @n line up or down and
- * updates the VGA buffer accordingly.
- * The buffer won't scroll upper than the first line of the
- * circular buffer, and won't scroll lower than the cursor
- * position.
+ * Moves the viewport to the top of the given circular buffer,
+ * without the hardware cursor
  */
-void sb_scroll(struct screenbuf *sb, int n) {
+static void sb_view_top(struct screenbuf *sb) {
+	int n = sb_ldiff(sb, sb->top, sb->viewport);
+
+	sb->viewport = sb->top;
+	sb_sync_scroll(sb, -n);
+}
+
+/*
+ * Moves the viewport to the bottom of the given circular buffer,
+ * without the hardware cursor
+ */
+static void sb_view_down(struct screenbuf *sb) {
+	int n = sb_ldiff(sb, sb->viewport, sb->cursor) - (VGA_HEIGHT - 1);
+
+	if (n > 1) {
+		sb->viewport = sb_addline(sb, sb->cursor, -(VGA_HEIGHT - 1));
+		sb_sync_scroll(sb, n);
+	}
+}
+
+/*
+ * Moves the viewport @n lines up or down, without the hardware cursor
+ */
+static void sb_view_scroll(struct screenbuf *sb, int n) {
 	int lines_room;
 
 	lines_room = n < 0 ?
@@ -188,31 +442,50 @@ void sb_scroll(struct screenbuf *sb, int n) {
 
 	if (lines_room >= abs(n)) {
 		sb->viewport = sb_addline(sb, sb->viewport, n);
-		sb_sync(sb);
+		sb_sync_scroll(sb, n);
 	} else {
 		if (n < 0)
-			sb_scroll_top(sb);
+			sb_view_top(sb);
 		else 
-			sb_scroll_down(sb);
+			sb_view_down(sb);
 	}
 }
 
+/*
+ * Makes the screenbuf scrolls @n line up or down and
+ * updates the VGA buffer accordingly.
+ * The buffer won't scroll upper than the first line of the
+ * circular buffer, and won't scroll lower than the cursor
+ * position.
+ */
+void sb_scroll(struct screenbuf *sb, int n) {
+	uint32_t flags = cpu_irq_save();
+
+	sb_view_scroll(sb, n);
+	sb_sync_cursor(sb);
+	cpu_irq_restore(flags);
+}
+
 /*
  * Scrolls to the top of the given circular buffer
  */
 void sb_scroll_top(struct screenbuf *sb) {
-	sb->viewport = sb->top;
-	sb_sync(sb);
+	uint32_t flags = cpu_irq_save();
+
+	sb_view_top(sb);
+	sb_sync_cursor(sb);
+	cpu_irq_restore(flags);
 }
 
 /*
  * Scrolls to the bottom of the given circular buffer
  */
 void sb_scroll_down(struct screenbuf *sb) {
-	if (sb_ldiff(sb, sb->viewport, sb->cursor) > VGA_HEIGHT) {
-		sb->viewport = sb->cursor - (VGA_WIDTH * (VGA_HEIGHT - 1));
-		sb_sync(sb);
-	}
+	uint32_t flags = cpu_irq_save();
+
+	sb_view_down(sb);
+	sb_sync_cursor(sb);
+	cpu_irq_restore(flags);
 }
 
 /*
@@ -221,14 +494,10 @@ void sb_scroll_down(struct screenbuf *sb) {
  * if the written word is in the visible window
  */
 static void sb_write_word(struct screenbuf *sb, uint16_t word) {
-	ptrdiff_t diff;
+	uint16_t *cell = sb->cursor + sb->cursor_offset;
 
-	*(sb->cursor + sb->cursor_offset) = word;
-	if (sb->loaded) {
-		diff = sb_diff(sb, sb->viewport, sb->cursor);
-		if (diff / VGA_WIDTH < VGA_HEIGHT)
-			*(VGA_PTR + diff + sb->cursor_offset) = word;
-	}
+	*cell = word;
+	sb_sync_cells(sb, sb_ldiff(sb, sb->viewport, sb->cursor), sb->cursor_offset, cell, 1);
 }
 
 /*
@@ -240,17 +509,22 @@ static void sb_write_word(struct screenbuf *sb, uint16_t word) {
 static void sb_crlf(struct screenbuf *sb) {
 	sb->cursor_offset = 0;
 	sb->cursor = sb_addline(sb, sb->cursor, 1);
+	// Out of memory, the ring ends at the last line backed
+	if (sb_grow(sb, sb->cursor + VGA_WIDTH) < 0) {
+		sb->endbuf = sb->cursor;
+		sb->cursor = sb->buf;
+	}
 	sb_memset(sb->cursor, SB_WHITESPACE, VGA_WIDTH);
 
 	if (sb->cursor == sb->top) {
 		if (sb->viewport == sb->top) {
 			sb->viewport = sb_addline(sb, sb->top, 1);
-			sb_sync(sb);
+			sb_sync_scroll(sb, 1);
 		}
 		sb->top = sb_addline(sb, sb->top, 1);
 	}
 	if (sb_ldiff(sb, sb->viewport, sb->cursor) == VGA_HEIGHT)
-		sb_scroll(sb, 1);
+		sb_view_scroll(sb, 1);
 }
 
 /*
@@ -261,7 +535,7 @@ static void sb_backspace(struct screenbuf *sb) {
 		if (sb->cursor == sb->top)
 			return;
 		if (sb->viewport == sb->cursor)
-			sb_scroll(sb, -1);
+			sb_view_scroll(sb, -1);
 		sb->cursor_offset = 0;
 		sb->cursor = sb_addline(sb, sb->cursor, -1);
 		while (sb->cursor_offset < VGA_WIDTH && sb->cursor[sb->cursor_offset] != SB_WHITESPACE)
@@ -287,45 +561,78 @@ static void sb_tabulation(struct screenbuf *sb) {
 }
 
 /*
- * Writes a printable character onto the screenbuf, at the
- * cursor position, and on the VGA buffer if loaded
- * Updates the cursor positon
+ * Returns 1 if @c is written as is, 0 if it is a special character
  */
-static void sb_regular(struct screenbuf *sb, char c) {
-	ptrdiff_t diff;
+static inline int sb_isregular(char c) {
+	return c != '\n' && c != '\t' && c != '\b';
+}
 
-	sb->cursor[sb->cursor_offset++] = (uint16_t)(c) | (uint16_t)(sb->color << 8);
-	if (sb->loaded) {
-		diff = sb_diff(sb, sb->viewport, sb->cursor);
-		memcpy(VGA_PTR + diff + sb->cursor_offset - 1, sb->cursor + sb->cursor_offset - 1, 2);
-	}
+/*
+ * Writes the @n printable characters of @s onto the screenbuf, at the
+ * cursor position, and on the VGA buffer if loaded and visible
+ * The characters must fit on the cursor line.
+ * Updates the cursor positon
+ */
+static void sb_regular(struct screenbuf *sb, const char *s, size_t n) {
+	uint16_t *cell = sb->cursor + sb->cursor_offset;
+	uint16_t color = (uint16_t)(sb->color << 8);
+
+	for (size_t i = 0; i < n; i++)
+		cell[i] = (uint8_t)s[i] | color;
+	sb_sync_cells(sb, sb_ldiff(sb, sb->viewport, sb->cursor), sb->cursor_offset, cell, n);
+	sb->cursor_offset += n;
 	if (sb->cursor_offset == VGA_WIDTH)
 		sb_crlf(sb);
 }
 
+/*
+ * Writes the @len characters of @buf to the given screenbuf
+ * This function handles special characters
+ * The characters between them are written a line at most at a time, and
+ * the hardware cursor is moved once at the end.
+ */
+void sb_write(struct screenbuf *sb, const char *buf, size_t len) {
+	uint32_t flags = cpu_irq_save();
+	size_t room;
+	size_t n;
+
+	// Changes left behind by the deferred mode
+	if (sb->loaded && !sb_deferred && (vga_dirty || vga_scroll))
+		vga_flush(sb);
+	while (len) {
+		n = 0;
+		room = VGA_WIDTH - sb->cursor_offset;
+		while (n < len && n < room && sb_isregular(buf[n]))
+			n++;
+		if (n) {
+			sb_regular(sb, buf, n);
+		} else {
+			switch (*buf) {
+				case '\n':
+					sb_crlf(sb);
+					break;
+				case '\t':
+					sb_tabulation(sb);
+					break;
+				case '\b':
+					sb_backspace(sb);
+					break;
+			}
+			n = 1;
+		}
+		buf += n;
+		len -= n;
+	}
+	sb_sync_cursor(sb);
+	cpu_irq_restore(flags);
+}
+
 /*
  * Writes the character @c to the given screenbuf
  * This function handles special characters
  */
 void sb_putchar(struct screenbuf *sb, char c) {
-	int newpos;
-
-	switch (c) {
-		case '\n':
-			sb_crlf(sb);
-			break;
-		case '\t':
-			sb_tabulation(sb);
-			break;
-		case '\b':
-			sb_backspace(sb);
-			break;
-		default:
-			sb_regular(sb, c);
-			break;
-	}
-	newpos = sb_diff(sb, sb->viewport, sb->cursor) + sb->cursor_offset;
-	cursor_update(newpos);
+	sb_write(sb, &c, 1);
 }
 
 /*
@@ -333,19 +640,19 @@ void sb_putchar(struct screenbuf *sb, char c) {
  * This function handles special characters
  */
 void sb_putstr(struct screenbuf *sb, char *s) {
-	while (*s)
-		sb_putchar(sb, *s++);
+	sb_write(sb, s, strlen(s));
 }
 
 /*
  * Clears the screenbuf's content and update the VGA buffer
  * if @sb is loaded.
+ * The frames of its history are given back to kpm.
  */
 void sb_clear(struct screenbuf *sb) {
-	sb->top = sb->buf;
-	sb->viewport = sb->buf;
-	sb->cursor = sb->buf;
-	sb->cursor_offset = 0;
-	sb_memset(sb->buf, SB_WHITESPACE, VGA_WIDTH * SB_HEIGHT);
+	uint32_t flags = cpu_irq_save();
+
+	sb_reset(sb);
 	sb_sync(sb);
+	sb_sync_cursor(sb);
+	cpu_irq_restore(flags);
 }
@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* sse.s
+ *
+ * SSE2 page copy, zeroing and checksum, to call between kernel_fpu_begin
+ * and kernel_fpu_end
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+.set PAGE_SIZE, 4096
+
+.section .text
+
+/* void sse2_copy_page(void *dst, const void *src) */
+.global sse2_copy_page
+sse2_copy_page:
+	mov 4(%esp), %edx
+	mov 8(%esp), %eax
+	mov $(PAGE_SIZE >> 6), %ecx
+1:
+	prefetchnta 256(%eax)
+	movdqa (%eax), %xmm0
+	movdqa 16(%eax), %xmm1
+	movdqa 32(%eax), %xmm2
+	movdqa 48(%eax), %xmm3
+	movdqa %xmm0, (%edx)
+	movdqa %xmm1, 16(%edx)
+	movdqa %xmm2, 32(%edx)
+	movdqa %xmm3, 48(%edx)
+	add $64, %eax
+	add $64, %edx
+	dec %ecx
+	jnz 1b
+	ret
+
+/* void sse2_clear_page(void *page) */
+.global sse2_clear_page
+sse2_clear_page:
+	mov 4(%esp), %eax
+	mov $(PAGE_SIZE >> 6), %ecx
+	pxor %xmm0, %xmm0
+1:
+	movntdq %xmm0, (%eax)
+	movntdq %xmm0, 16(%eax)
+	movntdq %xmm0, 32(%eax)
+	movntdq %xmm0, 48(%eax)
+	add $64, %eax
+	dec %ecx
+	jnz 1b
+	/* Non-temporal stores are weakly ordered */
+	sfence
+	ret
+
+/*
+ * uint32_t sse2_csum(const void *buf, size_t nblocks)
+ *
+ * Words are widened to 32 bits and summed in the four lanes of %xmm6,
+ * which are added together at the end.
+ */
+.global sse2_csum
+sse2_csum:
+	mov 4(%esp), %eax
+	mov 8(%esp), %ecx
+	pxor %xmm7, %xmm7
+	pxor %xmm6, %xmm6
+	test %ecx, %ecx
+	jz 2f
+1:
+	movdqu (%eax), %xmm0
+	movdqu 16(%eax), %xmm2
+	movdqa %xmm0, %xmm1
+	movdqa %xmm2, %xmm3
+	punpcklwd %xmm7, %xmm0
+	punpckhwd %xmm7, %xmm1
+	punpcklwd %xmm7, %xmm2
+	punpckhwd %xmm7, %xmm3
+	paddd %xmm0, %xmm6
+	paddd %xmm1, %xmm6
+	paddd %xmm2, %xmm6
+	paddd %xmm3, %xmm6
+	movdqu 32(%eax), %xmm0
+	movdqu 48(%eax), %xmm2
+	movdqa %xmm0, %xmm1
+	movdqa %xmm2, %xmm3
+	punpcklwd %xmm7, %xmm0
+	punpckhwd %xmm7, %xmm1
+	punpcklwd %xmm7, %xmm2
+	punpckhwd %xmm7, %xmm3
+	paddd %xmm0, %xmm6
+	paddd %xmm1, %xmm6
+	paddd %xmm2, %xmm6
+	paddd %xmm3, %xmm6
+	add $64, %eax
+	dec %ecx
+	jnz 1b
+2:
+	pshufd $0x4e, %xmm6, %xmm0
+	paddd %xmm0, %xmm6
+	pshufd $0xb1, %xmm6, %xmm0
+	paddd %xmm0, %xmm6
+	movd %xmm6, %eax
+	ret
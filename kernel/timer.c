@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* kernel/timer.c
+ *
+ * Programmable interval timer and periodic kernel work
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/timer.h>
+#include <kernel/port.h>
+
+volatile uint32_t timer_ticks;
+
+static struct timer_work timer_works[TIMER_NWORKS];
+static int timer_nworks;
+
+void timer_init() {
+	uint16_t divisor = PIT_FREQUENCY / TIMER_HZ;
+
+	port_write_u8(PIT_COMMAND, PIT_MODE3);
+	port_write_u8(PIT_CHANNEL0, divisor & 0xff);
+	port_write_u8(PIT_CHANNEL0, divisor >> 8);
+}
+
+void timer_tick() {
+	timer_ticks++;
+}
+
+int timer_register(void (*fn)(), uint32_t period) {
+	if (timer_nworks == TIMER_NWORKS || period == 0)
+		return -1;
+	timer_works[timer_nworks].fn = fn;
+	timer_works[timer_nworks].period = period;
+	timer_works[timer_nworks].next = timer_ticks + period;
+	timer_nworks++;
+	return 0;
+}
+
+/*
+ * Only timer_run writes @next, the interrupt handler only moves
+ * timer_ticks forward, so no locking is needed.
+ * A work that fell behind runs once, not once per missed period.
+ */
+void timer_run() {
+	struct timer_work *work;
+	uint32_t now = timer_ticks;
+
+	for (int i = 0; i < timer_nworks; i++) {
+		work = timer_works + i;
+		if ((int32_t)(now - work->next) < 0)
+			continue;
+		work->next = now + work->period;
+		work->fn();
+	}
+}
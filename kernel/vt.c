@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* vt.c
+ *
+ * Virtual terminals, opened on demand with their scrollback backed by kpm
+ * as it fills
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/vt.h>
+#include <kernel/bitmap.h>
+
+#define VT_WELCOME	"Welcome to nulix-2.0.1\n"
+
+struct screenbuf *sb_current;
+
+static struct screenbuf vt_sb[VT_MAX];
+static bitmap_t vt_opened[BITMAP_WORDS(VT_MAX)];
+static int vt_shown;
+
+/*
+ * Halts with @msg written straight to the text memory, no terminal being
+ * there to print it
+ */
+static void vt_fail(const char *msg) {
+	uint16_t *vga = VGA_PTR;
+
+	while (*msg)
+		*vga++ = (uint16_t)(SB_DFL_COLOR << 8) | (uint8_t)*msg++;
+	while (1)
+		__asm__ volatile ("cli\n\thlt");
+}
+
+void vt_init() {
+	if (vt_open(0, VT_DFL_LINES) < 0)
+		vt_fail("vt: cannot open the first terminal");
+	vt_shown = 0;
+	sb_current = vt_sb;
+	sb_load(sb_current);
+}
+
+int vt_open(int n, size_t nlines) {
+	if (n < 0)
+		n = bitmap_find_first_zero(vt_opened, VT_MAX);
+	if (n < 0 || n >= VT_MAX || bitmap_test_bit(vt_opened, n))
+		return -1;
+	if (nlines < VT_MIN_LINES || nlines > VT_MAX_LINES)
+		return -1;
+	if (sb_init(vt_sb + n, (uint16_t *)(VT_AREA + n * VT_SLOT_SIZE), nlines) < 0)
+		return -1;
+	bitmap_set_bit(vt_opened, n);
+	sb_putstr(vt_sb + n, VT_WELCOME);
+	return n;
+}
+
+int vt_close(int n) {
+	if (vt_get(n) == NULL || n == vt_shown)
+		return -1;
+	sb_destroy(vt_sb + n);
+	bitmap_clear_bit(vt_opened, n);
+	return 0;
+}
+
+int vt_switch(int n) {
+	if (vt_get(n) == NULL)
+		return -1;
+	if (n == vt_shown)
+		return 0;
+	sb_unload(sb_current);
+	vt_shown = n;
+	sb_current = vt_sb + n;
+	sb_load(sb_current);
+	return 0;
+}
+
+int vt_current() {
+	return vt_shown;
+}
+
+int vt_next(int n, int step) {
+	int next;
+
+	for (int i = 1; i < VT_MAX; i++) {
+		next = (n + VT_MAX + step * i) % VT_MAX;
+		if (bitmap_test_bit(vt_opened, next))
+			return next;
+	}
+	return n;
+}
+
+struct screenbuf *vt_get(int n) {
+	if (n < 0 || n >= VT_MAX || !bitmap_test_bit(vt_opened, n))
+		return NULL;
+	return vt_sb + n;
+}
@@ -0,0 +1,133 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* lib/bench.h
+ *
+ * Host benchmark harness of the libraries, used by their bench.c
+ *
+ * Each measure is reported as a line of the table printed on stdout and,
+ * when the benchmark is given a file name, as a line of a CSV file:
+ * lib,function,variant,size,align,ns_per_op,cycles_per_op,bytes_per_cycle
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#ifndef LIB_BENCH_H
+#define LIB_BENCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <x86intrin.h>
+
+// Bytes each measure goes through, bounding its number of operations
+#define BENCH_BYTES		(32 * 1024 * 1024)
+#define BENCH_MIN_OPS	64
+#define BENCH_MAX_OPS	(2 * 1024 * 1024)
+
+struct bench_time {
+	struct timespec ts;
+	unsigned long long tsc;
+};
+
+static const char *bench_lib;
+static FILE *bench_csv;
+
+/*
+ * Starts the benchmark of the library @lib, opening the CSV file named
+ * by the first argument if any.
+ */
+static inline void bench_init(const char *lib, int argc, char **argv) {
+	bench_lib = lib;
+	if (argc > 1) {
+		bench_csv = fopen(argv[1], "w");
+		if (bench_csv == NULL) {
+			perror(argv[1]);
+			exit(1);
+		}
+		fprintf(bench_csv, "lib,function,variant,size,align,ns_per_op,cycles_per_op,bytes_per_cycle\n");
+	}
+	printf("%-10s %-8s %8s %5s %12s %12s %12s\n", "function", "variant", "size", "align", "ns/op", "cycles/op", "bytes/cycle");
+}
+
+static inline void bench_fini() {
+	if (bench_csv)
+		fclose(bench_csv);
+}
+
+/*
+ * Number of operations to time on @bytes bytes each
+ */
+static inline size_t bench_ops(size_t bytes) {
+	size_t ops = BENCH_BYTES / (bytes ? bytes : 1);
+
+	if (ops < BENCH_MIN_OPS)
+		return BENCH_MIN_OPS;
+	return ops > BENCH_MAX_OPS ? BENCH_MAX_OPS : ops;
+}
+
+static inline void bench_start(struct bench_time *t) {
+	clock_gettime(CLOCK_MONOTONIC, &t->ts);
+	t->tsc = __rdtsc();
+}
+
+/*
+ * Time summed over the laps of a measure whose setup is not timed
+ */
+struct bench_total {
+	double ns;
+	unsigned long long cycles;
+};
+
+/*
+ * Adds the time elapsed since @start to @total
+ */
+static inline void bench_lap(struct bench_total *total, const struct bench_time *start) {
+	struct bench_time end;
+
+	end.tsc = __rdtsc();
+	clock_gettime(CLOCK_MONOTONIC, &end.ts);
+	total->ns += (end.ts.tv_sec - start->ts.tv_sec) * 1e9 + (end.ts.tv_nsec - start->ts.tv_nsec);
+	total->cycles += end.tsc - start->tsc;
+}
+
+/*
+ * Reports the @ops operations on @bytes bytes each that took @total, of
+ * @function on @size elements at the alignment @align
+ */
+static inline void bench_report_total(const struct bench_total *total, const char *function, const char *variant,
+		size_t size, size_t align, size_t ops, size_t bytes) {
+	double ns = total->ns / ops;
+	double cycles = (double)total->cycles / ops;
+
+	printf("%-10s %-8s %8zu %5zu %12.2f %12.2f %12.3f\n", function, variant, size, align, ns, cycles, bytes / cycles);
+	if (bench_csv)
+		fprintf(bench_csv, "%s,%s,%s,%zu,%zu,%.2f,%.2f,%.3f\n", bench_lib, function, variant, size, align, ns, cycles, bytes / cycles);
+}
+
+/*
+ * Reports the @ops operations on @bytes bytes each timed since @start, of
+ * @function on @size elements at the alignment @align
+ */
+static inline void bench_report(const struct bench_time *start, const char *function, const char *variant,
+		size_t size, size_t align, size_t ops, size_t bytes) {
+	struct bench_total total = {0, 0};
+
+	bench_lap(&total, start);
+	bench_report_total(&total, function, variant, size, align, ops, bytes);
+}
+
+/*
+ * Times @ops runs of the statement @body, which may use the variable i
+ */
+#define BENCH_RUN(function, variant, size, align, ops, bytes, body) do { \
+	struct bench_time __start; \
+	bench_start(&__start); \
+	for (size_t i = 0; i < (ops); i++) { \
+		body; \
+	} \
+	bench_report(&__start, function, variant, size, align, ops, bytes); \
+} while (0)
+
+#endif
@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* bench.c
+ *
+ * Host benchmark of the bitmap searches, against the byte loops they
+ * replace in kpm, run by make bench
+ *
+ * cc -O2 -fno-builtin -I../../include -o bench bench.c bitmap.c && ./bench [file.csv]
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/bitmap.h>
+#include <string.h>
+#include "../bench.h"
+
+#define MAX_BITS	(1 << 20)
+
+static const size_t sizes[] = {256, 4096, 65536, MAX_BITS};
+
+static bitmap_t map[BITMAP_WORDS(MAX_BITS)];
+static volatile size_t sink;
+
+/*
+ * bitmap_ffu of kpm: a byte at a time
+ */
+static int byte_find_first_zero(const bitmap_t *map, size_t nbits) {
+	const uint8_t *bytes = (const uint8_t *)map;
+	int ffu;
+
+	for (size_t i = 0; i < nbits / 8; i++) {
+		ffu = __builtin_ffs((uint8_t)~bytes[i]);
+		if (ffu)
+			return ffu + (i * 8) - 1;
+	}
+	return -1;
+}
+
+static void bit_set_range(bitmap_t *map, size_t nbits) {
+	for (size_t i = 0; i < nbits; i++)
+		bitmap_set_bit(map, i);
+}
+
+static int bit_weight(const bitmap_t *map, size_t nbits) {
+	int n = 0;
+
+	for (size_t i = 0; i < nbits; i++)
+		n += bitmap_test_bit(map, i);
+	return n;
+}
+
+/*
+ * The searches and counts over a bitmap of @n bits, all set but the last
+ * one, then the fill of the whole bitmap. The "byte" and "bit" variants
+ * are the loops of kpm, "word" the bitmap functions.
+ */
+static void bench_bits(size_t n) {
+	size_t bytes = n / 8;
+	size_t ops = bench_ops(bytes);
+
+	memset(map, 0xFF, sizeof(map));
+	bitmap_clear_bit(map, n - 1);
+	BENCH_RUN("find_zero", "byte", n, 0, ops, bytes, sink = byte_find_first_zero(map, n));
+	BENCH_RUN("find_zero", "word", n, 0, ops, bytes, sink = bitmap_find_first_zero(map, n));
+	BENCH_RUN("weight", "bit", n, 0, ops, bytes, sink = bit_weight(map, n));
+	BENCH_RUN("weight", "word", n, 0, ops, bytes, sink = bitmap_weight(map, n));
+	BENCH_RUN("set", "bit", n, 0, ops, bytes, bit_set_range(map, n));
+	BENCH_RUN("set", "word", n, 0, ops, bytes, bitmap_set(map, 0, n));
+}
+
+int main(int argc, char **argv) {
+	bench_init("bitmap", argc, argv);
+	for (size_t i = 0; i < sizeof(sizes) / sizeof(*sizes); i++)
+		bench_bits(sizes[i]);
+	bench_fini();
+	return 0;
+}
@@ -0,0 +1,159 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* bitmap.c
+ *
+ * Bitmaps of 32-bit words
+ *
+ * Searches skip the words with no bit of interest and find the bit in the
+ * first one that has some with one bsf, or bsr for the last bit set.
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/bitmap.h>
+
+// Mask of the bits from @bit % 32 to the end of its word
+#define BITMAP_FIRST_MASK(bit)	(~(bitmap_t)0 << ((bit) % BITMAP_WORD_BITS))
+// Mask of the bits of the word of @nbits - 1 up to it
+#define BITMAP_LAST_MASK(nbits)	(~(bitmap_t)0 >> (-(nbits) % BITMAP_WORD_BITS))
+
+/*
+ * Returns the index of the lowest bit set in @x, which must not be 0
+ */
+static inline unsigned int bitmap_bsf(bitmap_t x) {
+	unsigned int bit;
+
+	__asm__ ("bsf %1, %0" : "=r" (bit) : "rm" (x));
+	return bit;
+}
+
+/*
+ * Returns the index of the highest bit set in @x, which must not be 0
+ */
+static inline unsigned int bitmap_bsr(bitmap_t x) {
+	unsigned int bit;
+
+	__asm__ ("bsr %1, %0" : "=r" (bit) : "rm" (x));
+	return bit;
+}
+
+/*
+ * Returns the number of bits set in @x, without the popcnt instruction
+ * which the i686 does not have.
+ */
+static inline unsigned int bitmap_popcount(bitmap_t x) {
+	x -= (x >> 1) & 0x55555555;
+	x = (x & 0x33333333) + ((x >> 2) & 0x33333333);
+	x = (x + (x >> 4)) & 0x0F0F0F0F;
+	return (x * 0x01010101) >> 24;
+}
+
+void bitmap_set(bitmap_t *map, size_t start, size_t len) {
+	bitmap_t *p = map + BITMAP_WORD(start);
+	bitmap_t mask = BITMAP_FIRST_MASK(start);
+	size_t bits = BITMAP_WORD_BITS - start % BITMAP_WORD_BITS;
+	size_t end = start + len;
+
+	if (len == 0)
+		return;
+	while (len >= bits) {
+		*p++ |= mask;
+		len -= bits;
+		bits = BITMAP_WORD_BITS;
+		mask = ~(bitmap_t)0;
+	}
+	if (len)
+		*p |= mask & BITMAP_LAST_MASK(end);
+}
+
+void bitmap_clear(bitmap_t *map, size_t start, size_t len) {
+	bitmap_t *p = map + BITMAP_WORD(start);
+	bitmap_t mask = BITMAP_FIRST_MASK(start);
+	size_t bits = BITMAP_WORD_BITS - start % BITMAP_WORD_BITS;
+	size_t end = start + len;
+
+	if (len == 0)
+		return;
+	while (len >= bits) {
+		*p++ &= ~mask;
+		len -= bits;
+		bits = BITMAP_WORD_BITS;
+		mask = ~(bitmap_t)0;
+	}
+	if (len)
+		*p &= ~(mask & BITMAP_LAST_MASK(end));
+}
+
+/*
+ * Returns the first bit from @start in the @nbits bits of @map that is
+ * set, or clear if @invert is all ones.
+ */
+static inline int bitmap_find_next(const bitmap_t *map, size_t nbits, size_t start, bitmap_t invert) {
+	size_t i = BITMAP_WORD(start);
+	bitmap_t word;
+	size_t bit;
+
+	if (start >= nbits)
+		return -1;
+	word = (map[i] ^ invert) & BITMAP_FIRST_MASK(start);
+	while (word == 0) {
+		if (++i >= BITMAP_WORDS(nbits))
+			return -1;
+		word = map[i] ^ invert;
+	}
+	bit = i * BITMAP_WORD_BITS + bitmap_bsf(word);
+	return bit < nbits ? (int)bit : -1;
+}
+
+int bitmap_find_next_bit(const bitmap_t *map, size_t nbits, size_t start) {
+	return bitmap_find_next(map, nbits, start, 0);
+}
+
+int bitmap_find_next_zero(const bitmap_t *map, size_t nbits, size_t start) {
+	return bitmap_find_next(map, nbits, start, ~(bitmap_t)0);
+}
+
+int bitmap_find_last_bit(const bitmap_t *map, size_t nbits) {
+	size_t i = BITMAP_WORDS(nbits);
+	bitmap_t word;
+
+	if (nbits == 0)
+		return -1;
+	word = map[--i] & BITMAP_LAST_MASK(nbits);
+	while (word == 0) {
+		if (i == 0)
+			return -1;
+		word = map[--i];
+	}
+	return i * BITMAP_WORD_BITS + bitmap_bsr(word);
+}
+
+int bitmap_find_next_zero_area(const bitmap_t *map, size_t nbits, size_t start, size_t len, size_t align) {
+	int index, set;
+
+	index = bitmap_find_next_zero(map, nbits, start);
+	while (index >= 0) {
+		index = (index + align - 1) & ~(align - 1);
+		if (index + len > nbits)
+			return -1;
+		// The first bit set in the area, the next one starts after it
+		set = bitmap_find_next_bit(map, index + len, index);
+		if (set < 0)
+			return index;
+		index = bitmap_find_next_zero(map, nbits, set + 1);
+	}
+	return -1;
+}
+
+size_t bitmap_weight(const bitmap_t *map, size_t nbits) {
+	size_t n = 0;
+	size_t i;
+
+	for (i = 0; i < nbits / BITMAP_WORD_BITS; i++)
+		n += bitmap_popcount(map[i]);
+	if (nbits % BITMAP_WORD_BITS)
+		n += bitmap_popcount(map[i] & BITMAP_LAST_MASK(nbits));
+	return n;
+}
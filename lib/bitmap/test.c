@@ -0,0 +1,228 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* test.c
+ *
+ * Unit tests of the bitmap library, against bit by bit versions
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/bitmap.h>
+#include <stdio.h>
+#include <string.h>
+
+#define ASSERT(x)\
+test_count += 1;\
+if(!(x)) {\
+	printf("[\033[31mKO\033[0m]: %s l.%d\n", __func__, __LINE__);\
+	failed_tests += 1;\
+}
+
+#define NBITS		300
+#define NWORDS		BITMAP_WORDS(NBITS)
+
+int test_count = 0;
+int failed_tests = 0;
+
+static bitmap_t map[NWORDS];
+static char ref[NBITS];
+
+static unsigned int seed = 42;
+
+static unsigned int test_rand() {
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+/*
+ * Fills @map and @ref with random runs of bits, set with @density out of
+ * 16
+ */
+static void fill_random(int density) {
+	size_t i = 0, run;
+	int bit;
+
+	while (i < NBITS) {
+		bit = (int)(test_rand() % 16) < density;
+		run = 1 + test_rand() % 40;
+		for (; run > 0 && i < NBITS; run--, i++) {
+			ref[i] = bit;
+			if (bit)
+				bitmap_set_bit(map, i);
+			else
+				bitmap_clear_bit(map, i);
+		}
+	}
+}
+
+static int ref_next(size_t nbits, size_t start, int value) {
+	for (size_t i = start; i < nbits; i++)
+		if (ref[i] == value)
+			return i;
+	return -1;
+}
+
+static int ref_area(size_t nbits, size_t start, size_t len, size_t align) {
+	size_t i, j;
+
+	for (i = (start + align - 1) & ~(align - 1); i + len <= nbits; i += align) {
+		for (j = 0; j < len && !ref[i + j]; j++)
+			;
+		if (j == len)
+			return i;
+	}
+	return -1;
+}
+
+static int same() {
+	for (size_t i = 0; i < NBITS; i++)
+		if (bitmap_test_bit(map, i) != ref[i])
+			return 0;
+	return 1;
+}
+
+static int test_bits() {
+	memset(map, 0, sizeof(map));
+	bitmap_set_bit(map, 0);
+	bitmap_set_bit(map, 33);
+	bitmap_set_bit(map, 299);
+	ASSERT(map[0] == 1 && map[1] == 2 && map[9] == 1U << 11);
+	ASSERT(bitmap_test_bit(map, 33) && !bitmap_test_bit(map, 32));
+	bitmap_clear_bit(map, 33);
+	ASSERT(map[1] == 0);
+	// Same layout as a byte bitmap
+	ASSERT(((unsigned char *)map)[299 / 8] == 1 << (299 % 8));
+	return 0;
+}
+
+static int test_ranges() {
+	int ok = 1;
+
+	memset(map, 0, sizeof(map));
+	memset(ref, 0, sizeof(ref));
+	for (int n = 0; n < 2000; n++) {
+		size_t start = test_rand() % NBITS;
+		size_t len = test_rand() % (NBITS - start + 1);
+		int set = test_rand() & 1;
+
+		if (set)
+			bitmap_set(map, start, len);
+		else
+			bitmap_clear(map, start, len);
+		memset(ref + start, set, len);
+		ok &= same();
+	}
+	ASSERT(ok);
+
+	// Whole words, and nothing past the range
+	memset(map, 0, sizeof(map));
+	bitmap_set(map, 32, 64);
+	ASSERT(map[0] == 0 && map[1] == ~0U && map[2] == ~0U && map[3] == 0);
+	bitmap_clear(map, 40, 0);
+	ASSERT(map[1] == ~0U);
+	bitmap_set(map, 3, 2);
+	ASSERT(map[0] == 0x18);
+	return 0;
+}
+
+static int test_find() {
+	int ok = 1;
+
+	for (int density = 0; density <= 16; density++) {
+		fill_random(density);
+		for (size_t nbits = 0; nbits <= NBITS; nbits += 1 + nbits / 8) {
+			for (size_t start = 0; start <= nbits + 1; start++) {
+				ok &= bitmap_find_next_bit(map, nbits, start) == ref_next(nbits, start, 1);
+				ok &= bitmap_find_next_zero(map, nbits, start) == ref_next(nbits, start, 0);
+			}
+		}
+	}
+	ASSERT(ok);
+
+	memset(map, 0xFF, sizeof(map));
+	ASSERT(bitmap_find_first_zero(map, NBITS) == -1);
+	ASSERT(bitmap_find_first_bit(map, NBITS) == 0);
+	bitmap_clear_bit(map, 299);
+	ASSERT(bitmap_find_first_zero(map, NBITS) == 299);
+	ASSERT(bitmap_find_first_zero(map, 299) == -1);
+	memset(map, 0, sizeof(map));
+	ASSERT(bitmap_find_first_bit(map, NBITS) == -1);
+	return 0;
+}
+
+static int test_last() {
+	int ok = 1;
+	int last;
+
+	for (int density = 0; density <= 16; density += 2) {
+		fill_random(density);
+		for (size_t nbits = 0; nbits <= NBITS; nbits++) {
+			last = -1;
+			for (size_t i = 0; i < nbits; i++)
+				if (ref[i])
+					last = i;
+			ok &= bitmap_find_last_bit(map, nbits) == last;
+		}
+	}
+	ASSERT(ok);
+	return 0;
+}
+
+static int test_area() {
+	static const size_t aligns[] = {1, 2, 8, 32, 64};
+	int ok = 1;
+
+	for (int density = 0; density <= 16; density += 2) {
+		fill_random(density);
+		for (size_t a = 0; a < sizeof(aligns) / sizeof(*aligns); a++)
+			for (size_t len = 1; len <= 70; len += 3)
+				for (size_t start = 0; start < NBITS; start += 7)
+					ok &= bitmap_find_next_zero_area(map, NBITS, start, len, aligns[a]) == ref_area(NBITS, start, len, aligns[a]);
+	}
+	ASSERT(ok);
+
+	memset(map, 0, sizeof(map));
+	ASSERT(bitmap_find_next_zero_area(map, NBITS, 0, NBITS, 1) == 0);
+	ASSERT(bitmap_find_next_zero_area(map, NBITS, 1, NBITS, 1) == -1);
+	bitmap_set_bit(map, 31);
+	ASSERT(bitmap_find_next_zero_area(map, NBITS, 0, 32, 32) == 32);
+	ASSERT(bitmap_find_next_zero_area(map, NBITS, 0, 31, 1) == 0);
+	return 0;
+}
+
+static int test_weight() {
+	int ok = 1;
+	size_t n;
+
+	for (int density = 0; density <= 16; density++) {
+		fill_random(density);
+		for (size_t nbits = 0; nbits <= NBITS; nbits++) {
+			n = 0;
+			for (size_t i = 0; i < nbits; i++)
+				n += ref[i];
+			ok &= bitmap_weight(map, nbits) == n;
+		}
+	}
+	ASSERT(ok);
+	return 0;
+}
+
+int main() {
+	printf("-- Running test suite --\n");
+
+	test_bits();
+	test_ranges();
+	test_find();
+	test_last();
+	test_area();
+	test_weight();
+
+	if (failed_tests == 0) {
+		printf("-- All %d tests passed --\n", test_count);
+	} else {
+		printf("-- %d/%d tests passed --\n", test_count - failed_tests, test_count);
+	}
+	return 0;
+}
@@ -0,0 +1,181 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* bench.c
+ *
+ * Host benchmark of insert, lookup and delete in the containers, run by
+ * make bench
+ *
+ * cc -O2 -fno-builtin -I../../include -o bench bench.c htable.c rbtree.c && ./bench [file.csv]
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/list.h>
+#include <kernel/rbtree.h>
+#include <kernel/htable.h>
+#include "../bench.h"
+
+#define MAX_SIZE	65536
+// Lookups in lists are linear, they are only timed up to LIST_MAX_SIZE
+#define LIST_MAX_SIZE	4096
+// Operations timed for each size, in rounds of one per element
+#define ROUND_OPS	65536
+
+static const size_t sizes[] = {16, 256, 4096, 65536};
+
+struct item {
+	uint32_t key;
+	struct list_head list;
+	struct rb_node rb;
+};
+
+static struct item items[MAX_SIZE];
+static uint32_t order[MAX_SIZE];
+static struct htable_slot slots[2 * MAX_SIZE];
+static volatile size_t sink;
+
+static unsigned int seed = 42;
+
+static unsigned int bench_rand() {
+	seed = seed * 1103515245 + 12345;
+	return seed ^ (seed >> 16);
+}
+
+static int item_cmp(const struct item *a, const struct item *b) {
+	return (a->key > b->key) - (a->key < b->key);
+}
+
+static const uint32_t *item_key(const struct item *item) {
+	return &item->key;
+}
+
+static uint32_t item_hash(const uint32_t *key) {
+	return hash_u32(*key);
+}
+
+static int item_equal(const uint32_t *a, const uint32_t *b) {
+	return *a == *b;
+}
+
+LIST_DEFINE(item_list, struct item, list)
+RB_DEFINE(item_tree, struct item, rb, item_cmp)
+HTABLE_DEFINE(item_table, struct item, uint32_t, item_key, item_hash, item_equal)
+
+enum op {
+	OP_INSERT,
+	OP_LOOKUP,
+	OP_DELETE,
+	OP_COUNT,
+};
+
+static const char *op_names[] = {"insert", "lookup", "delete"};
+
+static struct item *list_find(struct list_head *head, uint32_t key) {
+	struct item *item;
+
+	for (item = item_list_first(head); item; item = item_list_next(head, item))
+		if (item->key == key)
+			return item;
+	return NULL;
+}
+
+/*
+ * Adds to @total the time taken by @n inserts, lookups and deletes in a
+ * list, a tree and a hash table, lookups and deletes being done in random
+ * order
+ */
+static void run(size_t n, struct bench_total total[3][OP_COUNT]) {
+	struct list_head head = LIST_HEAD_INIT(head);
+	struct rb_root root = RB_ROOT_INIT;
+	struct htable table;
+	struct item key;
+	struct bench_time start;
+	size_t nslots = 2;
+
+	while (nslots < 2 * n)
+		nslots *= 2;
+	for (size_t i = 0; i < n; i++) {
+		items[i].key = bench_rand();
+		order[i] = i;
+	}
+	for (size_t i = n; i-- > 1;) {
+		size_t j = bench_rand() % (i + 1);
+		uint32_t tmp = order[i];
+
+		order[i] = order[j];
+		order[j] = tmp;
+	}
+
+	if (n <= LIST_MAX_SIZE) {
+		bench_start(&start);
+		for (size_t i = 0; i < n; i++)
+			item_list_add(&head, &items[i]);
+		bench_lap(&total[0][OP_INSERT], &start);
+		bench_start(&start);
+		for (size_t i = 0; i < n; i++)
+			sink = (size_t)list_find(&head, items[order[i]].key);
+		bench_lap(&total[0][OP_LOOKUP], &start);
+		bench_start(&start);
+		for (size_t i = 0; i < n; i++)
+			item_list_del(&items[order[i]]);
+		bench_lap(&total[0][OP_DELETE], &start);
+	}
+
+	bench_start(&start);
+	for (size_t i = 0; i < n; i++)
+		item_tree_insert(&root, &items[i]);
+	bench_lap(&total[1][OP_INSERT], &start);
+	bench_start(&start);
+	for (size_t i = 0; i < n; i++) {
+		key.key = items[order[i]].key;
+		sink = (size_t)item_tree_find(&root, &key);
+	}
+	bench_lap(&total[1][OP_LOOKUP], &start);
+	bench_start(&start);
+	for (size_t i = 0; i < n; i++)
+		item_tree_erase(&root, &items[order[i]]);
+	bench_lap(&total[1][OP_DELETE], &start);
+
+	item_table_init(&table, slots, nslots);
+	bench_start(&start);
+	for (size_t i = 0; i < n; i++)
+		item_table_insert(&table, &items[i]);
+	bench_lap(&total[2][OP_INSERT], &start);
+	bench_start(&start);
+	for (size_t i = 0; i < n; i++)
+		sink = (size_t)item_table_find(&table, &items[order[i]].key);
+	bench_lap(&total[2][OP_LOOKUP], &start);
+	bench_start(&start);
+	for (size_t i = 0; i < n; i++)
+		item_table_remove(&table, &items[order[i]].key);
+	bench_lap(&total[2][OP_DELETE], &start);
+}
+
+/*
+ * Reports each operation of each container on @n elements, the container
+ * being the variant
+ */
+static void bench_size(size_t n) {
+	static const char *names[] = {"list", "rbtree", "htable"};
+	struct bench_total total[3][OP_COUNT] = {0};
+	size_t rounds = ROUND_OPS / n;
+
+	for (size_t r = 0; r < rounds; r++)
+		run(n, total);
+	for (int c = 0; c < 3; c++) {
+		if (c == 0 && n > LIST_MAX_SIZE)
+			continue;
+		for (int op = 0; op < OP_COUNT; op++)
+			bench_report_total(&total[c][op], op_names[op], names[c], n, 0, rounds * n, 0);
+	}
+}
+
+int main(int argc, char **argv) {
+	bench_init("container", argc, argv);
+	for (size_t s = 0; s < sizeof(sizes) / sizeof(*sizes); s++)
+		bench_size(sizes[s]);
+	bench_fini();
+	return 0;
+}
@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* htable.c
+ *
+ * Open addressing hash tables with linear probing
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/htable.h>
+
+void htable_init(struct htable *table, struct htable_slot *slots, size_t nslots, int (*match)(const void *, const void *)) {
+	table->slots = slots;
+	table->mask = nslots - 1;
+	table->count = 0;
+	table->match = match;
+	for (size_t i = 0; i < nslots; i++)
+		slots[i].elem = NULL;
+}
+
+/*
+ * Returns the index of the slot holding @key, or of the empty slot ending
+ * its probe sequence.
+ */
+static size_t htable_probe(const struct htable *table, const void *key, uint32_t hash) {
+	const struct htable_slot *slot;
+	size_t i = hash & table->mask;
+
+	// The table always has an empty slot
+	while (1) {
+		slot = &table->slots[i];
+		if (slot->elem == NULL || (slot->hash == hash && table->match(slot->elem, key)))
+			return i;
+		i = (i + 1) & table->mask;
+	}
+}
+
+int htable_insert(struct htable *table, void *elem, const void *key, uint32_t hash) {
+	size_t i;
+
+	// At most 7/8 of the slots, tables under 8 slots still keeping one
+	// empty to end the probes
+	if (table->count + 1 > table->mask - table->mask / 8)
+		return -1;
+	i = htable_probe(table, key, hash);
+	if (table->slots[i].elem)
+		return -1;
+	table->slots[i].elem = elem;
+	table->slots[i].hash = hash;
+	table->count++;
+	return 0;
+}
+
+void *htable_find(const struct htable *table, const void *key, uint32_t hash) {
+	return table->slots[htable_probe(table, key, hash)].elem;
+}
+
+void *htable_remove(struct htable *table, const void *key, uint32_t hash) {
+	struct htable_slot *slots = table->slots;
+	size_t mask = table->mask;
+	size_t hole, i, home;
+	void *elem;
+
+	hole = htable_probe(table, key, hash);
+	elem = slots[hole].elem;
+	if (elem == NULL)
+		return NULL;
+
+	// Move back the elements that probed past the hole
+	for (i = (hole + 1) & mask; slots[i].elem; i = (i + 1) & mask) {
+		home = slots[i].hash & mask;
+		// The element stays if its home slot is in (hole, i]
+		if (((i - home) & mask) < ((i - hole) & mask))
+			continue;
+		slots[hole] = slots[i];
+		hole = i;
+	}
+	slots[hole].elem = NULL;
+	table->count--;
+	return elem;
+}
@@ -0,0 +1,263 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* rbtree.c
+ *
+ * Red-black tree rebalancing
+ *
+ * Rotations only change the subtrees of the two nodes they rotate, which
+ * are the only ones updated. Insertions and removals change the subtrees
+ * of the ancestors of the node linked or unlinked, which are updated up
+ * to the root before rebalancing.
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/rbtree.h>
+
+static inline int rb_is_black(const struct rb_node *node) {
+	// Null leaves are black
+	return node == NULL || node->color == RB_BLACK;
+}
+
+/*
+ * Puts @new in place of @old in the child pointer of its parent, or at
+ * the root.
+ */
+static void rb_replace(struct rb_root *root, struct rb_node *old, struct rb_node *new) {
+	struct rb_node *parent = old->parent;
+
+	if (parent == NULL)
+		root->node = new;
+	else if (parent->left == old)
+		parent->left = new;
+	else
+		parent->right = new;
+	if (new)
+		new->parent = parent;
+}
+
+static void rb_rotate_left(struct rb_root *root, struct rb_node *node, rb_update_t update) {
+	struct rb_node *right = node->right;
+
+	node->right = right->left;
+	if (right->left)
+		right->left->parent = node;
+	rb_replace(root, node, right);
+	right->left = node;
+	node->parent = right;
+	if (update) {
+		update(node);
+		update(right);
+	}
+}
+
+static void rb_rotate_right(struct rb_root *root, struct rb_node *node, rb_update_t update) {
+	struct rb_node *left = node->left;
+
+	node->left = left->right;
+	if (left->right)
+		left->right->parent = node;
+	rb_replace(root, node, left);
+	left->right = node;
+	node->parent = left;
+	if (update) {
+		update(node);
+		update(left);
+	}
+}
+
+static void rb_propagate(struct rb_node *node, rb_update_t update) {
+	if (update)
+		for (; node; node = node->parent)
+			update(node);
+}
+
+void rb_insert(struct rb_root *root, struct rb_node *node, rb_update_t update) {
+	struct rb_node *parent, *gparent, *uncle;
+
+	rb_propagate(node, update);
+	// A red node may not have a red parent
+	while ((parent = node->parent) && parent->color == RB_RED) {
+		// The parent is red, so it is not the root
+		gparent = parent->parent;
+		if (parent == gparent->left) {
+			uncle = gparent->right;
+			if (!rb_is_black(uncle)) {
+				parent->color = RB_BLACK;
+				uncle->color = RB_BLACK;
+				gparent->color = RB_RED;
+				node = gparent;
+				continue;
+			}
+			if (node == parent->right) {
+				rb_rotate_left(root, parent, update);
+				node = parent;
+				parent = node->parent;
+			}
+			parent->color = RB_BLACK;
+			gparent->color = RB_RED;
+			rb_rotate_right(root, gparent, update);
+		} else {
+			uncle = gparent->left;
+			if (!rb_is_black(uncle)) {
+				parent->color = RB_BLACK;
+				uncle->color = RB_BLACK;
+				gparent->color = RB_RED;
+				node = gparent;
+				continue;
+			}
+			if (node == parent->left) {
+				rb_rotate_right(root, parent, update);
+				node = parent;
+				parent = node->parent;
+			}
+			parent->color = RB_BLACK;
+			gparent->color = RB_RED;
+			rb_rotate_left(root, gparent, update);
+		}
+	}
+	root->node->color = RB_BLACK;
+}
+
+/*
+ * Restores the black heights after a black node was removed above
+ * @node, the child of @parent, @node being possibly a null leaf.
+ */
+static void rb_erase_fixup(struct rb_root *root, struct rb_node *node, struct rb_node *parent, rb_update_t update) {
+	struct rb_node *sibling;
+
+	while (node != root->node && rb_is_black(node)) {
+		// The subtree of @node misses a black node, so its sibling exists
+		if (node == parent->left) {
+			sibling = parent->right;
+			if (sibling->color == RB_RED) {
+				sibling->color = RB_BLACK;
+				parent->color = RB_RED;
+				rb_rotate_left(root, parent, update);
+				sibling = parent->right;
+			}
+			if (rb_is_black(sibling->left) && rb_is_black(sibling->right)) {
+				sibling->color = RB_RED;
+				node = parent;
+				parent = node->parent;
+				continue;
+			}
+			if (rb_is_black(sibling->right)) {
+				sibling->left->color = RB_BLACK;
+				sibling->color = RB_RED;
+				rb_rotate_right(root, sibling, update);
+				sibling = parent->right;
+			}
+			sibling->color = parent->color;
+			parent->color = RB_BLACK;
+			sibling->right->color = RB_BLACK;
+			rb_rotate_left(root, parent, update);
+		} else {
+			sibling = parent->left;
+			if (sibling->color == RB_RED) {
+				sibling->color = RB_BLACK;
+				parent->color = RB_RED;
+				rb_rotate_right(root, parent, update);
+				sibling = parent->left;
+			}
+			if (rb_is_black(sibling->left) && rb_is_black(sibling->right)) {
+				sibling->color = RB_RED;
+				node = parent;
+				parent = node->parent;
+				continue;
+			}
+			if (rb_is_black(sibling->left)) {
+				sibling->right->color = RB_BLACK;
+				sibling->color = RB_RED;
+				rb_rotate_left(root, sibling, update);
+				sibling = parent->left;
+			}
+			sibling->color = parent->color;
+			parent->color = RB_BLACK;
+			sibling->left->color = RB_BLACK;
+			rb_rotate_right(root, parent, update);
+		}
+		node = root->node;
+	}
+	if (node)
+		node->color = RB_BLACK;
+}
+
+void rb_erase(struct rb_root *root, struct rb_node *node, rb_update_t update) {
+	struct rb_node *child, *parent, *next;
+	int color = node->color;
+
+	if (node->left == NULL || node->right == NULL) {
+		child = node->left ? node->left : node->right;
+		parent = node->parent;
+		rb_replace(root, node, child);
+	} else {
+		// Put the successor of @node, which has no left child, in its place
+		next = node->right;
+		while (next->left)
+			next = next->left;
+		color = next->color;
+		child = next->right;
+		if (next->parent == node) {
+			parent = next;
+		} else {
+			parent = next->parent;
+			rb_replace(root, next, child);
+			next->right = node->right;
+			next->right->parent = next;
+		}
+		rb_replace(root, node, next);
+		next->left = node->left;
+		next->left->parent = next;
+		next->color = node->color;
+	}
+
+	rb_propagate(parent, update);
+	if (color == RB_BLACK)
+		rb_erase_fixup(root, child, parent, update);
+}
+
+struct rb_node *rb_first(const struct rb_root *root) {
+	struct rb_node *node = root->node;
+
+	if (node)
+		while (node->left)
+			node = node->left;
+	return node;
+}
+
+struct rb_node *rb_last(const struct rb_root *root) {
+	struct rb_node *node = root->node;
+
+	if (node)
+		while (node->right)
+			node = node->right;
+	return node;
+}
+
+struct rb_node *rb_next(const struct rb_node *node) {
+	if (node->right) {
+		node = node->right;
+		while (node->left)
+			node = node->left;
+		return (struct rb_node *)node;
+	}
+	// Go up until coming from a left child
+	while (node->parent && node == node->parent->right)
+		node = node->parent;
+	return node->parent;
+}
+
+struct rb_node *rb_prev(const struct rb_node *node) {
+	if (node->left) {
+		node = node->left;
+		while (node->right)
+			node = node->right;
+		return (struct rb_node *)node;
+	}
+	while (node->parent && node == node->parent->left)
+		node = node->parent;
+	return node->parent;
+}
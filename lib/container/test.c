@@ -0,0 +1,375 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* test.c
+ *
+ * Unit tests of the container library
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/list.h>
+#include <kernel/rbtree.h>
+#include <kernel/htable.h>
+#include <stdio.h>
+
+#define ASSERT(x)\
+test_count += 1;\
+if(!(x)) {\
+	printf("[\033[31mKO\033[0m]: %s l.%d\n", __func__, __LINE__);\
+	failed_tests += 1;\
+}
+
+#define NITEMS		2000
+#define NSLOTS		4096
+
+int test_count = 0;
+int failed_tests = 0;
+
+static unsigned int seed = 42;
+
+static unsigned int test_rand() {
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+struct item {
+	uint32_t key;
+	int in;
+	struct list_head list;
+	struct rb_node rb;
+	// Size and largest key of the subtree of the item, for augmented trees
+	uint32_t size;
+	uint32_t max;
+};
+
+static struct item items[NITEMS];
+
+LIST_DEFINE(item_list, struct item, list)
+
+static int item_cmp(const struct item *a, const struct item *b) {
+	return (a->key > b->key) - (a->key < b->key);
+}
+
+RB_DEFINE(item_tree, struct item, rb, item_cmp)
+
+static void item_update(struct item *item) {
+	struct item *left = item_tree_entry(item->rb.left);
+	struct item *right = item_tree_entry(item->rb.right);
+
+	item->size = 1 + (left ? left->size : 0) + (right ? right->size : 0);
+	item->max = item->key;
+	if (left && left->max > item->max)
+		item->max = left->max;
+	if (right && right->max > item->max)
+		item->max = right->max;
+}
+
+RB_DEFINE_AUGMENTED(item_aug, struct item, rb, item_cmp, item_update)
+
+static const uint32_t *item_key(const struct item *item) {
+	return &item->key;
+}
+
+static uint32_t item_hash(const uint32_t *key) {
+	return hash_u32(*key);
+}
+
+// Puts all the keys in 4 probe sequences, from the last 4 slots of a 256 slot table
+static uint32_t item_badhash(const uint32_t *key) {
+	return 0xFC | (*key & 3);
+}
+
+static int item_equal(const uint32_t *a, const uint32_t *b) {
+	return *a == *b;
+}
+
+HTABLE_DEFINE(item_table, struct item, uint32_t, item_key, item_hash, item_equal)
+HTABLE_DEFINE(item_badtable, struct item, uint32_t, item_key, item_badhash, item_equal)
+
+static struct htable_slot slots[NSLOTS];
+
+/*
+ * Gives the items distinct random keys
+ */
+static void items_init() {
+	for (int i = 0; i < NITEMS; i++) {
+		items[i].key = (test_rand() & ~0x7FFU) | i;
+		items[i].in = 0;
+	}
+}
+
+static int test_list() {
+	struct list_head head = LIST_HEAD_INIT(head);
+	struct list_head *pos, *tmp;
+	struct item *item;
+	int i, ok;
+
+	ASSERT(list_empty(&head));
+	ASSERT(item_list_first(&head) == NULL);
+	for (i = 0; i < 10; i++) {
+		items[i].key = i;
+		item_list_add_tail(&head, &items[i]);
+	}
+	item_list_add(&head, &items[10]);
+	items[10].key = 100;
+	ASSERT(item_list_first(&head) == &items[10]);
+	ASSERT(item_list_last(&head) == &items[9]);
+
+	// 100 0 1 .. 9
+	ok = item_list_next(&head, &items[10]) == &items[0];
+	for (i = 0, item = item_list_next(&head, &items[10]); item; item = item_list_next(&head, item), i++)
+		ok &= item->key == (uint32_t)i;
+	ASSERT(ok && i == 10);
+	ASSERT(item_list_prev(&head, &items[10]) == NULL);
+
+	// Remove the odd keys while iterating
+	list_for_each_safe(pos, tmp, &head)
+		if (container_of(pos, struct item, list)->key & 1)
+			list_del(pos);
+	i = 0;
+	ok = 1;
+	list_for_each(pos, &head) {
+		ok &= (container_of(pos, struct item, list)->key & 1) == 0;
+		i++;
+	}
+	ASSERT(ok && i == 6);
+
+	// Removing twice does nothing
+	item_list_del(&items[0]);
+	item_list_del(&items[0]);
+	ASSERT(item_list_next(&head, &items[10]) == &items[2]);
+	while ((item = item_list_first(&head)))
+		item_list_del(item);
+	ASSERT(list_empty(&head));
+	return 0;
+}
+
+/*
+ * Returns the black height of @node, or -1 if the subtree breaks a
+ * red-black or search tree property
+ */
+static int rb_check(const struct rb_node *node, const struct rb_node *parent, int augmented) {
+	const struct item *item, *left, *right;
+	int lh, rh;
+
+	if (node == NULL)
+		return 0;
+	item = item_tree_entry(node);
+	left = item_tree_entry(node->left);
+	right = item_tree_entry(node->right);
+	if (node->parent != parent)
+		return -1;
+	if (node->color == RB_RED && ((left && left->rb.color == RB_RED) || (right && right->rb.color == RB_RED)))
+		return -1;
+	if ((left && left->key >= item->key) || (right && right->key <= item->key))
+		return -1;
+	lh = rb_check(node->left, node, augmented);
+	rh = rb_check(node->right, node, augmented);
+	if (lh < 0 || lh != rh)
+		return -1;
+	if (augmented) {
+		uint32_t size = item->size, max = item->max;
+
+		item_update((struct item *)item);
+		if (size != item->size || max != item->max)
+			return -1;
+	}
+	return lh + (node->color == RB_BLACK);
+}
+
+static int rb_valid(const struct rb_root *root, int augmented) {
+	if (root->node && root->node->color != RB_BLACK)
+		return 0;
+	return rb_check(root->node, NULL, augmented) >= 0;
+}
+
+static int test_rbtree() {
+	struct rb_root root = RB_ROOT_INIT;
+	struct item key, *item;
+	int ok, n;
+
+	items_init();
+	ASSERT(item_tree_first(&root) == NULL);
+	for (int i = 0; i < NITEMS; i++)
+		item_tree_insert(&root, &items[i]);
+	ASSERT(rb_valid(&root, 0));
+	key = items[5];
+	ASSERT(item_tree_insert(&root, &key) == &items[5]);
+
+	ok = 1;
+	for (int i = 0; i < NITEMS; i++) {
+		key.key = items[i].key;
+		ok &= item_tree_find(&root, &key) == &items[i];
+		key.key ^= 0x400;
+		ok &= item_tree_find(&root, &key) == NULL;
+	}
+	ASSERT(ok);
+
+	// In order traversal
+	n = 0;
+	ok = 1;
+	for (item = item_tree_first(&root); item; item = item_tree_next(item), n++)
+		ok &= item_tree_next(item) == NULL || item_tree_next(item)->key > item->key;
+	ASSERT(ok && n == NITEMS);
+	ASSERT(rb_prev(rb_first(&root)) == NULL);
+	ASSERT(rb_next(rb_last(&root)) == NULL);
+	ASSERT(item_tree_entry(rb_prev(rb_last(&root)))->key < item_tree_entry(rb_last(&root))->key);
+
+	// Erase every other item, then the rest
+	for (int i = 0; i < NITEMS; i += 2)
+		item_tree_erase(&root, &items[i]);
+	ASSERT(rb_valid(&root, 0));
+	ok = 1;
+	for (int i = 0; i < NITEMS; i++) {
+		key.key = items[i].key;
+		ok &= item_tree_find(&root, &key) == (i & 1 ? &items[i] : NULL);
+	}
+	ASSERT(ok);
+	for (int i = 1; i < NITEMS; i += 2)
+		item_tree_erase(&root, &items[i]);
+	ASSERT(root.node == NULL);
+	return 0;
+}
+
+static int test_rbtree_augmented() {
+	struct rb_root root = RB_ROOT_INIT;
+	int ok = 1, count = 0;
+	uint32_t max;
+	int i;
+
+	items_init();
+	// Random inserts and erases, checking the tree every 64 operations
+	for (int op = 0; op < 20000; op++) {
+		i = test_rand() % NITEMS;
+		if (items[i].in) {
+			item_aug_erase(&root, &items[i]);
+			count--;
+		} else {
+			item_aug_insert(&root, &items[i]);
+			count++;
+		}
+		items[i].in ^= 1;
+		if (op % 64 == 0) {
+			ok &= rb_valid(&root, 1);
+			ok &= root.node == NULL || item_aug_entry(root.node)->size == (uint32_t)count;
+		}
+	}
+	ASSERT(ok);
+
+	max = 0;
+	for (i = 0; i < NITEMS; i++)
+		if (items[i].in && items[i].key > max)
+			max = items[i].key;
+	ASSERT(root.node && item_aug_entry(root.node)->max == max);
+	return 0;
+}
+
+static int test_htable() {
+	struct htable table;
+	uint32_t key;
+	int ok;
+
+	items_init();
+	item_table_init(&table, slots, NSLOTS);
+	key = 1;
+	ASSERT(item_table_find(&table, &key) == NULL);
+	ASSERT(item_table_remove(&table, &key) == NULL);
+
+	ok = 1;
+	for (int i = 0; i < NITEMS; i++)
+		ok &= item_table_insert(&table, &items[i]) == 0;
+	ASSERT(ok && table.count == NITEMS);
+	ASSERT(item_table_insert(&table, &items[7]) == -1);
+
+	ok = 1;
+	for (int i = 0; i < NITEMS; i++) {
+		key = items[i].key;
+		ok &= item_table_find(&table, &key) == &items[i];
+		key ^= 0x400;
+		ok &= item_table_find(&table, &key) == NULL;
+	}
+	ASSERT(ok);
+
+	ok = 1;
+	for (int i = 0; i < NITEMS; i += 2) {
+		key = items[i].key;
+		ok &= item_table_remove(&table, &key) == &items[i];
+	}
+	for (int i = 0; i < NITEMS; i++) {
+		key = items[i].key;
+		ok &= item_table_find(&table, &key) == (i & 1 ? &items[i] : NULL);
+	}
+	ASSERT(ok && table.count == NITEMS / 2);
+	return 0;
+}
+
+static int test_htable_full() {
+	struct htable table;
+	uint32_t key;
+	int n = 0, ok;
+
+	items_init();
+	item_table_init(&table, slots, 64);
+	while (n < NITEMS && item_table_insert(&table, &items[n]) == 0)
+		n++;
+	// 7/8 of the slots
+	ok = n == 56;
+	// Tables smaller than 8 slots still keep one empty
+	item_table_init(&table, slots, 4);
+	n = 0;
+	while (n < NITEMS && item_table_insert(&table, &items[n]) == 0)
+		n++;
+	key = items[NITEMS - 1].key;
+	ASSERT(ok && n == 3 && item_table_find(&table, &key) == NULL);
+	return 0;
+}
+
+/*
+ * Collisions and wrap around: removals must keep the following elements
+ * of the probe sequences reachable
+ */
+static int test_htable_collisions() {
+	struct htable table;
+	uint32_t key;
+	int i, ok = 1;
+
+	items_init();
+	item_badtable_init(&table, slots, 256);
+	for (int op = 0; op < 20000; op++) {
+		i = test_rand() % 200;
+		key = items[i].key;
+		if (items[i].in) {
+			ok &= item_badtable_remove(&table, &key) == &items[i];
+		} else {
+			ok &= item_badtable_insert(&table, &items[i]) == 0;
+		}
+		items[i].in ^= 1;
+		if (op % 128 == 0)
+			for (int j = 0; j < 200; j++) {
+				key = items[j].key;
+				ok &= item_badtable_find(&table, &key) == (items[j].in ? &items[j] : NULL);
+			}
+	}
+	ASSERT(ok);
+	return 0;
+}
+
+int main() {
+	printf("-- Running test suite --\n");
+
+	test_list();
+	test_rbtree();
+	test_rbtree_augmented();
+	test_htable();
+	test_htable_full();
+	test_htable_collisions();
+
+	if (failed_tests == 0) {
+		printf("-- All %d tests passed --\n", test_count);
+	} else {
+		printf("-- %d/%d tests passed --\n", test_count - failed_tests, test_count);
+	}
+	return 0;
+}
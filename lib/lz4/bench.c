@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* bench.c
+ *
+ * Host benchmark of the lz4 library, page by page as zram uses it, run by
+ * make bench
+ *
+ * cc -O2 -fno-builtin -I../../include -o bench bench.c lz4.c && ./bench [file.csv]
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/lz4.h>
+#include <string.h>
+#include "../bench.h"
+
+#define PAGE_SIZE	4096
+#define NPAGES		256
+
+static struct lz4_state state;
+static uint8_t pages[NPAGES][PAGE_SIZE];
+static uint8_t cmp[NPAGES][LZ4_BOUND(PAGE_SIZE)];
+static size_t clen[NPAGES];
+static uint8_t out[PAGE_SIZE];
+
+static void fill_zeroes(uint8_t *page, size_t n) {
+	memset(page, 0, PAGE_SIZE);
+	page[n % PAGE_SIZE] = n;
+}
+
+static void fill_text(uint8_t *page, size_t n) {
+	const char *words[] = {"page ", "frame ", "table ", "kernel ", "fault ", "zram ", "swap ", "\n"};
+
+	(void)n;
+	for (size_t len = 0; len < PAGE_SIZE; len++)
+		page[len] = 0;
+	for (size_t len = 0; len < PAGE_SIZE;) {
+		const char *w = words[rand() % 8];
+		for (; *w && len < PAGE_SIZE; w++)
+			page[len++] = *w;
+	}
+}
+
+/* Arrays of small structures: counters, flags and kernel pointers */
+static void fill_structs(uint8_t *page, size_t n) {
+	uint32_t *words = (uint32_t *)page;
+
+	for (size_t i = 0; i < PAGE_SIZE / 4; i += 4) {
+		words[i] = 0xC0100000 + (rand() % 4096) * 16;
+		words[i + 1] = n + i;
+		words[i + 2] = rand() % 8;
+		words[i + 3] = 0;
+	}
+}
+
+static void fill_random(uint8_t *page, size_t n) {
+	(void)n;
+	for (size_t i = 0; i < PAGE_SIZE; i++)
+		page[i] = rand();
+}
+
+/*
+ * Compresses and decompresses NPAGES pages filled by @fill, under the
+ * variant @name, then checks the round trip
+ */
+static int run(const char *name, void (*fill)(uint8_t *, size_t)) {
+	size_t ops = bench_ops(PAGE_SIZE);
+	size_t total = 0;
+
+	srand(42);
+	for (size_t i = 0; i < NPAGES; i++)
+		fill(pages[i], i);
+
+	BENCH_RUN("compress", name, PAGE_SIZE, 0, ops, PAGE_SIZE,
+		clen[i % NPAGES] = lz4_compress(&state, pages[i % NPAGES], PAGE_SIZE, cmp[i % NPAGES], LZ4_BOUND(PAGE_SIZE)));
+	BENCH_RUN("decompress", name, PAGE_SIZE, 0, ops, PAGE_SIZE,
+		lz4_decompress(cmp[i % NPAGES], clen[i % NPAGES], out, sizeof(out)));
+
+	for (size_t i = 0; i < NPAGES; i++) {
+		if (lz4_decompress(cmp[i], clen[i], out, sizeof(out)) != PAGE_SIZE
+			|| memcmp(out, pages[i], PAGE_SIZE)) {
+			printf("%-10s round trip failed on page %zu\n", name, i);
+			return -1;
+		}
+		total += clen[i];
+	}
+	printf("%-10s %-8s %8.2f\n", "ratio", name, (double)NPAGES * PAGE_SIZE / total);
+	return 0;
+}
+
+int main(int argc, char **argv) {
+	int ret = 0;
+
+	bench_init("lz4", argc, argv);
+	ret |= run("zeroes", fill_zeroes);
+	ret |= run("text", fill_text);
+	ret |= run("structs", fill_structs);
+	ret |= run("random", fill_random);
+	bench_fini();
+	return ret ? 1 : 0;
+}
@@ -0,0 +1,211 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* lib/lz4/lz4.c
+ *
+ * LZ4 block format compressor and decompressor
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/lz4.h>
+
+#define LZ4_MINMATCH		4
+#define LZ4_LASTLITERALS	5	// the last 5 bytes are always literals
+#define LZ4_MFLIMIT			12	// no match may start in the last 12 bytes
+#define LZ4_MAX_OFFSET		65535
+#define LZ4_SKIP_TRIGGER	6	// search step grows every 2^6 misses
+
+/* x86 tolerates unaligned accesses */
+typedef uint32_t __attribute__((may_alias, aligned(1))) lz4_u32_t;
+
+static inline uint32_t lz4_read32(const uint8_t *p) {
+	return *(const lz4_u32_t *)p;
+}
+
+static inline uint32_t lz4_hash(uint32_t v) {
+	return (v * 2654435761U) >> (32 - LZ4_HASHLOG);
+}
+
+/*
+ * Copies @n bytes from @src to @dst, four at a time. Overlapping copies
+ * forward are fine as long as @dst - @src is at least 4.
+ */
+static inline void lz4_copy(uint8_t *dst, const uint8_t *src, size_t n) {
+	while (n >= 4) {
+		*(lz4_u32_t *)dst = lz4_read32(src);
+		dst += 4;
+		src += 4;
+		n -= 4;
+	}
+	while (n--)
+		*dst++ = *src++;
+}
+
+/*
+ * Writes the extra bytes of a length that does not fit in a token nibble.
+ */
+static inline uint8_t *lz4_write_length(uint8_t *op, size_t len) {
+	while (len >= 255) {
+		*op++ = 255;
+		len -= 255;
+	}
+	*op++ = len;
+	return op;
+}
+
+size_t lz4_compress(struct lz4_state *state, const void *src, size_t len, void *dst, size_t cap) {
+	const uint8_t *base = src;
+	const uint8_t *ip = base;
+	const uint8_t *anchor = base;
+	const uint8_t *iend = base + len;
+	const uint8_t *mflimit;
+	const uint8_t *matchlimit;
+	const uint8_t *ref;
+	const uint8_t *mend;
+	uint8_t *op = dst;
+	uint8_t *oend = op + cap;
+	uint8_t *token;
+	size_t literals;
+	size_t mlen;
+	uint32_t misses = 0;
+	uint32_t h;
+
+	if (len > LZ4_MAX_INPUT)
+		return 0;
+	for (size_t i = 0; i < (1 << LZ4_HASHLOG); i++)
+		state->table[i] = 0;
+
+	if (len > LZ4_MFLIMIT) {
+		mflimit = iend - LZ4_MFLIMIT;
+		matchlimit = iend - LZ4_LASTLITERALS;
+		ip++;
+		while (ip < mflimit) {
+			h = lz4_hash(lz4_read32(ip));
+			ref = base + state->table[h];
+			state->table[h] = ip - base;
+			if (ref >= ip || ip - ref > LZ4_MAX_OFFSET || lz4_read32(ref) != lz4_read32(ip)) {
+				ip += 1 + (misses++ >> LZ4_SKIP_TRIGGER);
+				continue;
+			}
+			misses = 0;
+
+			while (ip > anchor && ref > base && ip[-1] == ref[-1]) {
+				ip--;
+				ref--;
+			}
+			mend = ip + LZ4_MINMATCH;
+			for (const uint8_t *r = ref + LZ4_MINMATCH; mend < matchlimit && *mend == *r; r++)
+				mend++;
+
+			literals = ip - anchor;
+			mlen = mend - ip - LZ4_MINMATCH;
+			if ((size_t)(oend - op) < 1 + literals + literals / 255 + 1 + 2 + mlen / 255 + 1)
+				return 0;
+
+			token = op++;
+			if (literals >= 15) {
+				*token = 15 << 4;
+				op = lz4_write_length(op, literals - 15);
+			} else {
+				*token = literals << 4;
+			}
+			lz4_copy(op, anchor, literals);
+			op += literals;
+
+			*op++ = (ip - ref) & 0xff;
+			*op++ = (ip - ref) >> 8;
+			if (mlen >= 15) {
+				*token |= 15;
+				op = lz4_write_length(op, mlen - 15);
+			} else {
+				*token |= mlen;
+			}
+
+			// Positions inside the match are worth remembering too
+			state->table[lz4_hash(lz4_read32(mend - 2))] = mend - 2 - base;
+			ip = anchor = mend;
+		}
+	}
+
+	literals = iend - anchor;
+	if ((size_t)(oend - op) < 1 + literals + literals / 255 + 1)
+		return 0;
+	if (literals >= 15) {
+		*op++ = 15 << 4;
+		op = lz4_write_length(op, literals - 15);
+	} else {
+		*op++ = literals << 4;
+	}
+	lz4_copy(op, anchor, literals);
+	op += literals;
+	return op - (uint8_t *)dst;
+}
+
+/*
+ * Reads the extra bytes of a length whose token nibble was 15.
+ * Returns the decoded length, or -1 if the input ends first.
+ */
+static inline int lz4_read_length(const uint8_t **ip, const uint8_t *iend, size_t *len) {
+	uint8_t b;
+
+	do {
+		if (*ip >= iend)
+			return -1;
+		b = *(*ip)++;
+		*len += b;
+	} while (b == 255);
+	return 0;
+}
+
+int lz4_decompress(const void *src, size_t len, void *dst, size_t cap) {
+	const uint8_t *ip = src;
+	const uint8_t *iend = ip + len;
+	uint8_t *op = dst;
+	uint8_t *oend = op + cap;
+	const uint8_t *match;
+	size_t literals;
+	size_t mlen;
+	size_t offset;
+	uint8_t token;
+
+	while (ip < iend) {
+		token = *ip++;
+		literals = token >> 4;
+		if (literals == 15 && lz4_read_length(&ip, iend, &literals) < 0)
+			return -1;
+		if (literals > (size_t)(iend - ip) || literals > (size_t)(oend - op))
+			return -1;
+		lz4_copy(op, ip, literals);
+		ip += literals;
+		op += literals;
+
+		// The last sequence has no match
+		if (ip == iend)
+			break;
+
+		if (iend - ip < 2)
+			return -1;
+		offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if (offset == 0 || offset > (size_t)(op - (uint8_t *)dst))
+			return -1;
+		mlen = token & 15;
+		if (mlen == 15 && lz4_read_length(&ip, iend, &mlen) < 0)
+			return -1;
+		mlen += LZ4_MINMATCH;
+		if (mlen > (size_t)(oend - op))
+			return -1;
+
+		match = op - offset;
+		if (offset >= 4) {
+			lz4_copy(op, match, mlen);
+			op += mlen;
+		} else {
+			while (mlen--)
+				*op++ = *match++;
+		}
+	}
+	return op - (uint8_t *)dst;
+}
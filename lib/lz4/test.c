@@ -0,0 +1,160 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* test.c
+ *
+ * Unit tests of the lz4 library
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/lz4.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ASSERT(x)\
+test_count += 1;\
+if(!(x)) {\
+	printf("[\033[31mKO\033[0m]: %s l.%d\n", __func__, __LINE__);\
+	failed_tests += 1;\
+}
+
+int test_count = 0;
+int failed_tests = 0;
+
+static struct lz4_state state;
+static uint8_t src[8192];
+static uint8_t cmp[LZ4_BOUND(8192)];
+static uint8_t out[8192];
+
+/*
+ * Compresses then decompresses the @len first bytes of src.
+ * Returns 1 if the data survived the round trip.
+ */
+static int roundtrip(size_t len, size_t *clen) {
+	int dlen;
+
+	*clen = lz4_compress(&state, src, len, cmp, sizeof(cmp));
+	if (*clen == 0)
+		return 0;
+	dlen = lz4_decompress(cmp, *clen, out, sizeof(out));
+	return dlen == (int)len && memcmp(src, out, len) == 0;
+}
+
+static int test_small() {
+	size_t clen;
+
+	ASSERT(roundtrip(0, &clen));
+	ASSERT(clen == 1);
+	memcpy(src, "abc", 3);
+	ASSERT(roundtrip(3, &clen));
+	memcpy(src, "hello hello hello", 17);
+	ASSERT(roundtrip(17, &clen));
+
+	return 0;
+}
+
+static int test_zeroes() {
+	size_t clen;
+
+	memset(src, 0, 4096);
+	ASSERT(roundtrip(4096, &clen));
+	ASSERT(clen < 64);
+
+	return 0;
+}
+
+static int test_text() {
+	const char *words[] = {"page ", "frame ", "table ", "kernel ", "fault ", "\n"};
+	size_t clen;
+	size_t len = 0;
+
+	srand(42);
+	while (len < 4096) {
+		const char *w = words[rand() % 6];
+		size_t n = strlen(w);
+		if (len + n > 4096)
+			n = 4096 - len;
+		memcpy(src + len, w, n);
+		len += n;
+	}
+	ASSERT(roundtrip(4096, &clen));
+	ASSERT(clen < 4096 / 2);
+
+	return 0;
+}
+
+static int test_random() {
+	size_t clen;
+
+	srand(42);
+	for (size_t i = 0; i < sizeof(src); i++)
+		src[i] = rand();
+	ASSERT(roundtrip(sizeof(src), &clen));
+	ASSERT(clen <= LZ4_BOUND(sizeof(src)));
+	// Does not fit
+	ASSERT(lz4_compress(&state, src, 4096, cmp, 4096) == 0);
+
+	return 0;
+}
+
+static int test_overlap() {
+	size_t clen;
+
+	// Offsets smaller than 4 are copied byte by byte
+	for (size_t i = 0; i < 4096; i++)
+		src[i] = "ab"[i % 2];
+	ASSERT(roundtrip(4096, &clen));
+	for (size_t i = 0; i < 4096; i++)
+		src[i] = "xyz"[i % 3];
+	ASSERT(roundtrip(4096, &clen));
+	ASSERT(clen < 64);
+
+	return 0;
+}
+
+static int test_malformed() {
+	size_t clen;
+
+	memset(src, 'a', 4096);
+	clen = lz4_compress(&state, src, 4096, cmp, sizeof(cmp));
+	// Output buffer too small
+	ASSERT(lz4_decompress(cmp, clen, out, 4095) == -1);
+	// Truncated input
+	ASSERT(lz4_decompress(cmp, clen - 1, out, sizeof(out)) != 4096);
+	// Offset before the start of the output
+	cmp[0] = 0x10;
+	cmp[1] = 'a';
+	cmp[2] = 0x10;
+	cmp[3] = 0x00;
+	ASSERT(lz4_decompress(cmp, 4, out, sizeof(out)) == -1);
+	// Null offset
+	cmp[2] = 0x00;
+	ASSERT(lz4_decompress(cmp, 4, out, sizeof(out)) == -1);
+	// Literal length past the end of the input
+	cmp[0] = 0xf0;
+	cmp[1] = 0xff;
+	ASSERT(lz4_decompress(cmp, 2, out, sizeof(out)) == -1);
+
+	return 0;
+}
+
+int main() {
+	printf("-- Running test suite --\n");
+
+	test_small();
+	test_zeroes();
+	test_text();
+	test_random();
+	test_overlap();
+	test_malformed();
+
+	if (failed_tests == 0) {
+		printf("-- All %d tests passed --\n", test_count);
+	} else {
+		printf("-- %d/%d tests passed --\n", test_count - failed_tests, test_count);
+	}
+	return 0;
+}
@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* bench.c
+ *
+ * Host benchmark of the conversion, search and sort functions, run by
+ * make bench
+ *
+ * cc -O2 -fno-builtin -I../../include -o bench bench.c *.c && ./bench [file.csv]
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/stdlib.h>
+#include <string.h>
+#include "../bench.h"
+
+#define MAX_SIZE	65536
+
+static const size_t sizes[] = {16, 256, 4096, MAX_SIZE};
+// Digits of the numbers converted, the largest ones only fit long longs
+static const size_t digits[] = {1, 5, 9, 18};
+
+static unsigned int keys[MAX_SIZE];
+static unsigned int sorted_keys[MAX_SIZE];
+static unsigned int work[MAX_SIZE];
+static unsigned int tmp[MAX_SIZE];
+static struct radix_state radix_state;
+static volatile size_t sink;
+
+static unsigned int seed = 42;
+
+static unsigned int bench_rand() {
+	seed = seed * 1103515245 + 12345;
+	return seed ^ (seed >> 16);
+}
+
+static int cmp_uint(const void *a, const void *b) {
+	unsigned int x = *(const unsigned int *)a;
+	unsigned int y = *(const unsigned int *)b;
+
+	return (x > y) - (x < y);
+}
+
+/*
+ * The conversions of a number of @n digits, in base 10 and 16
+ */
+static void bench_strto(size_t n) {
+	size_t ops = bench_ops(n);
+	char dec[32], hex[32];
+	char *end;
+
+	for (size_t i = 0; i < n; i++) {
+		dec[i] = '1' + i % 9;
+		hex[i] = "1a2b3c4d5e6f789"[i % 15];
+	}
+	dec[n] = hex[n] = '\0';
+	if (n < 10)
+		BENCH_RUN("atoi", "10", n, 0, ops, n, sink = atoi(dec));
+	if (n < 10) {
+		BENCH_RUN("strtol", "10", n, 0, ops, n, sink = strtol(dec, &end, 10));
+		BENCH_RUN("strtoul", "10", n, 0, ops, n, sink = strtoul(dec, &end, 10));
+	}
+	BENCH_RUN("strtoll", "10", n, 0, ops, n, sink = strtoll(dec, &end, 10));
+	BENCH_RUN("strtoull", "10", n, 0, ops, n, sink = strtoull(dec, &end, 10));
+	if (n < 8) {
+		BENCH_RUN("strtol", "16", n, 0, ops, n, sink = strtol(hex, &end, 16));
+		BENCH_RUN("strtoul", "16", n, 0, ops, n, sink = strtoul(hex, &end, 16));
+	}
+	if (n < 16) {
+		BENCH_RUN("strtoll", "16", n, 0, ops, n, sink = strtoll(hex, &end, 16));
+		BENCH_RUN("strtoull", "16", n, 0, ops, n, sink = strtoull(hex, &end, 16));
+	}
+}
+
+/*
+ * Lookups of random keys present in a sorted array of @n keys
+ */
+static void bench_bsearch(size_t n) {
+	size_t ops = bench_ops(64);
+	unsigned int key;
+
+	for (size_t i = 0; i < n; i++)
+		work[i] = 2 * i;
+	BENCH_RUN("bsearch", "hit", n, 0, ops, 0,
+		(key = 2 * (bench_rand() % n), sink = (size_t)bsearch(&key, work, n, sizeof(*work), cmp_uint)));
+	BENCH_RUN("bsearch", "miss", n, 0, ops, 0,
+		(key = 2 * (bench_rand() % n) + 1, sink = (size_t)bsearch(&key, work, n, sizeof(*work), cmp_uint)));
+}
+
+/*
+ * Sorts of @n keys, random or already sorted. The copy of the keys to
+ * sort is part of the time measured.
+ */
+static void bench_sort(size_t n) {
+	size_t bytes = n * sizeof(*work);
+	size_t ops = bench_ops(bytes * 16);
+
+	BENCH_RUN("qsort", "random", n, 0, ops, bytes,
+		(memcpy(work, keys, bytes), qsort(work, n, sizeof(*work), cmp_uint)));
+	BENCH_RUN("qsort", "sorted", n, 0, ops, bytes,
+		(memcpy(work, sorted_keys, bytes), qsort(work, n, sizeof(*work), cmp_uint)));
+	BENCH_RUN("radix", "random", n, 0, ops, bytes,
+		(memcpy(work, keys, bytes), radix_sort(&radix_state, work, tmp, n)));
+	BENCH_RUN("radix", "sorted", n, 0, ops, bytes,
+		(memcpy(work, sorted_keys, bytes), radix_sort(&radix_state, work, tmp, n)));
+}
+
+int main(int argc, char **argv) {
+	bench_init("std", argc, argv);
+	for (size_t i = 0; i < MAX_SIZE; i++) {
+		keys[i] = bench_rand();
+		sorted_keys[i] = i * 65536;
+	}
+	for (size_t i = 0; i < sizeof(digits) / sizeof(*digits); i++)
+		bench_strto(digits[i]);
+	for (size_t i = 0; i < sizeof(sizes) / sizeof(*sizes); i++)
+		bench_bsearch(sizes[i]);
+	for (size_t i = 0; i < sizeof(sizes) / sizeof(*sizes); i++)
+		bench_sort(sizes[i]);
+	bench_fini();
+	return 0;
+}
@@ -3,21 +3,33 @@
 
 /* lib/std/bsearch.c
  *
- * Search in a array.
+ * Search in a sorted array.
  *
  * created: 2022/12/09 - xlmod <glafond-@student.42.fr>
- * updated: 2022/12/09 - xlmod <glafond-@student.42.fr>
+ * updated: 2026/10/19 - agent <agent@local>
  */
 
 #include <stddef.h>
 
+/*
+ * Return an element of the @nitems elements of @size bytes at @base equal
+ * to @key, or NULL. The array is sorted in the order of @compar.
+ */
 void *bsearch(const void *key, const void *base, size_t nitems, size_t size, int (*compar)(const void *, const void *)) {
-	const void *ptr;
+	const char *ptr;
+	int cmp;
 
-	for (size_t i = 0; i < nitems; i++) {
-		ptr = base + (i * size);
-		if (compar(key, ptr) == 0) {
+	while (nitems > 0) {
+		ptr = (const char *)base + (nitems / 2) * size;
+		cmp = compar(key, ptr);
+		if (cmp == 0)
 			return (void *)ptr;
+		if (cmp > 0) {
+			// The key is after the middle element
+			base = ptr + size;
+			nitems = nitems - nitems / 2 - 1;
+		} else {
+			nitems /= 2;
 		}
 	}
 	return NULL;
@@ -0,0 +1,158 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* lib/std/qsort.c
+ *
+ * Sort an array.
+ *
+ * Introsort: quicksort with a median of three pivot, which falls back to
+ * heapsort when the partitions get too unbalanced, and leaves the small
+ * ones to insertion sort. Not stable.
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int (*qsort_cmp_t)(const void *, const void *);
+
+// Partitions of at most QSORT_SMALL elements are insertion sorted
+#define QSORT_SMALL		16
+
+/*
+ * Swap the elements of @size bytes at @a and @b, a word at a time when
+ * they are word aligned.
+ */
+static inline void qsort_swap(char *a, char *b, size_t size) {
+	uint32_t w;
+	char c;
+
+	if ((((uintptr_t)a | (uintptr_t)b | size) & (sizeof(uint32_t) - 1)) == 0) {
+		for (; size > 0; size -= sizeof(uint32_t), a += sizeof(uint32_t), b += sizeof(uint32_t)) {
+			w = *(uint32_t *)a;
+			*(uint32_t *)a = *(uint32_t *)b;
+			*(uint32_t *)b = w;
+		}
+		return;
+	}
+	for (; size > 0; size--, a++, b++) {
+		c = *a;
+		*a = *b;
+		*b = c;
+	}
+}
+
+static void qsort_insertion(char *base, size_t nitems, size_t size, qsort_cmp_t compar) {
+	char *end = base + nitems * size;
+
+	for (char *i = base + size; i < end; i += size)
+		for (char *j = i; j > base && compar(j - size, j) > 0; j -= size)
+			qsort_swap(j - size, j, size);
+}
+
+/*
+ * Move the element @root of the heap of @nitems elements at @base down to
+ * its place.
+ */
+static void qsort_sift(char *base, size_t root, size_t nitems, size_t size, qsort_cmp_t compar) {
+	size_t child;
+
+	while ((child = 2 * root + 1) < nitems) {
+		if (child + 1 < nitems && compar(base + child * size, base + (child + 1) * size) < 0)
+			child++;
+		if (compar(base + root * size, base + child * size) >= 0)
+			return;
+		qsort_swap(base + root * size, base + child * size, size);
+		root = child;
+	}
+}
+
+static void qsort_heap(char *base, size_t nitems, size_t size, qsort_cmp_t compar) {
+	for (size_t i = nitems / 2; i-- > 0;)
+		qsort_sift(base, i, nitems, size, compar);
+	for (size_t i = nitems - 1; i > 0; i--) {
+		qsort_swap(base, base + i * size, size);
+		qsort_sift(base, 0, i, size, compar);
+	}
+}
+
+/*
+ * Partition the @nitems elements at @base around the median of the first,
+ * middle and last ones. Return the final index of the pivot: the elements
+ * before it are not greater, the elements after it are not smaller.
+ */
+static size_t qsort_partition(char *base, size_t nitems, size_t size, qsort_cmp_t compar) {
+	char *mid = base + (nitems / 2) * size;
+	char *last = base + (nitems - 1) * size;
+	char *i, *j;
+
+	if (compar(mid, base) < 0)
+		qsort_swap(mid, base, size);
+	if (compar(last, mid) < 0) {
+		qsort_swap(last, mid, size);
+		if (compar(mid, base) < 0)
+			qsort_swap(mid, base, size);
+	}
+
+	// The pivot is kept first, the last element stops the first scan
+	qsort_swap(base, mid, size);
+	i = base + size;
+	j = last;
+	while (1) {
+		// Both scans stop on equal elements, keeping duplicates balanced
+		while (compar(i, base) < 0)
+			i += size;
+		while (compar(base, j) < 0)
+			j -= size;
+		if (i >= j)
+			break;
+		qsort_swap(i, j, size);
+		i += size;
+		j -= size;
+	}
+	qsort_swap(base, j, size);
+	return (j - base) / size;
+}
+
+/*
+ * Sort the @nitems elements at @base, heapsorting the partitions found
+ * more than @depth levels deep.
+ */
+static void qsort_intro(char *base, size_t nitems, size_t size, qsort_cmp_t compar, int depth) {
+	size_t pivot;
+
+	while (nitems > QSORT_SMALL) {
+		if (depth-- == 0) {
+			qsort_heap(base, nitems, size, compar);
+			return;
+		}
+		pivot = qsort_partition(base, nitems, size, compar);
+		// Recurse into the smaller side, so the stack stays logarithmic
+		if (pivot < nitems - pivot - 1) {
+			qsort_intro(base, pivot, size, compar, depth);
+			base += (pivot + 1) * size;
+			nitems -= pivot + 1;
+		} else {
+			qsort_intro(base + (pivot + 1) * size, nitems - pivot - 1, size, compar, depth);
+			nitems = pivot;
+		}
+	}
+	qsort_insertion(base, nitems, size, compar);
+}
+
+/*
+ * Sort the @nitems elements of @size bytes at @base in the order of
+ * @compar.
+ */
+void qsort(void *base, size_t nitems, size_t size, int (*compar)(const void *, const void *)) {
+	int depth = 0;
+
+	if (size == 0)
+		return;
+	// Allow 2 * log2(nitems) levels of partitions before heapsort
+	for (size_t n = nitems; n > 1; n >>= 1)
+		depth += 2;
+	qsort_intro(base, nitems, size, compar, depth);
+}
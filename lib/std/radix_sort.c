@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* lib/std/radix_sort.c
+ *
+ * Sort unsigned 32-bit keys.
+ *
+ * LSD radix sort, one byte per pass: the counts of the four passes are
+ * taken in a single read of the keys, and the passes on a byte all the
+ * keys share are skipped.
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/stdlib.h>
+
+void radix_sort(struct radix_state *state, uint32_t *keys, uint32_t *tmp, size_t n) {
+	uint32_t *src = keys;
+	uint32_t *dst = tmp;
+	uint32_t *swap;
+	size_t *count;
+	size_t sum, c;
+
+	for (int pass = 0; pass < RADIX_PASSES; pass++)
+		for (int b = 0; b < RADIX_BUCKETS; b++)
+			state->count[pass][b] = 0;
+	for (size_t i = 0; i < n; i++)
+		for (int pass = 0; pass < RADIX_PASSES; pass++)
+			state->count[pass][(keys[i] >> (pass * 8)) & 0xFF]++;
+
+	for (int pass = 0; pass < RADIX_PASSES; pass++) {
+		count = state->count[pass];
+		if (n == 0 || count[(keys[0] >> (pass * 8)) & 0xFF] == n)
+			continue;
+		// Turn the counts into the first index of each bucket
+		sum = 0;
+		for (int b = 0; b < RADIX_BUCKETS; b++) {
+			c = count[b];
+			count[b] = sum;
+			sum += c;
+		}
+		for (size_t i = 0; i < n; i++)
+			dst[count[(src[i] >> (pass * 8)) & 0xFF]++] = src[i];
+		swap = src;
+		src = dst;
+		dst = swap;
+	}
+
+	if (src != keys)
+		for (size_t i = 0; i < n; i++)
+			keys[i] = src[i];
+}
@@ -24,6 +24,89 @@ TEST_STRUCT2(abs, int, int);
 TEST_STRUCT4(strtol, char *, int, char, int);
 TEST_STRUCT2(atoi, char *, int);
 
+#define SORT_MAX	10000
+
+static unsigned int seed = 42;
+
+static unsigned int test_rand() {
+	seed = seed * 1103515245 + 12345;
+	return seed;
+}
+
+static int cmp_int(const void *a, const void *b) {
+	int x = *(const int *)a;
+	int y = *(const int *)b;
+
+	return (x > y) - (x < y);
+}
+
+struct test_rgb {
+	unsigned char r, g, b;
+};
+
+static int cmp_rgb(const void *a, const void *b) {
+	return ((const struct test_rgb *)a)->r - ((const struct test_rgb *)b)->r;
+}
+
+enum test_pattern {
+	PATTERN_RANDOM,
+	PATTERN_SORTED,
+	PATTERN_REVERSED,
+	PATTERN_EQUAL,
+	PATTERN_ORGAN,
+	PATTERN_FEW,
+	PATTERN_COUNT,
+};
+
+static const char *pattern_names[] = {"random", "sorted", "reversed", "equal", "organ pipe", "few values"};
+
+static void fill_pattern(int *t, int n, enum test_pattern pattern) {
+	for (int i = 0; i < n; i++) {
+		switch (pattern) {
+		case PATTERN_RANDOM:
+			t[i] = (int)test_rand();
+			break;
+		case PATTERN_SORTED:
+			t[i] = i;
+			break;
+		case PATTERN_REVERSED:
+			t[i] = n - i;
+			break;
+		case PATTERN_EQUAL:
+			t[i] = 7;
+			break;
+		case PATTERN_ORGAN:
+			t[i] = i < n / 2 ? i : n - i;
+			break;
+		default:
+			t[i] = test_rand() % 4;
+			break;
+		}
+	}
+}
+
+/*
+ * Return 1 if @t is sorted and holds the same values as @ref, by sum and
+ * xor.
+ */
+static int check_sorted(const int *t, const int *ref, int n) {
+	unsigned int sum = 0, xor = 0;
+
+	for (int i = 0; i < n; i++) {
+		if (i > 0 && t[i - 1] > t[i])
+			return 0;
+		sum += (unsigned int)t[i] - (unsigned int)ref[i];
+		xor ^= t[i] ^ ref[i];
+	}
+	return sum == 0 && xor == 0;
+}
+
+static int sort_t[SORT_MAX];
+static int sort_ref[SORT_MAX];
+static unsigned int radix_keys[SORT_MAX];
+static unsigned int radix_tmp[SORT_MAX];
+static struct radix_state radix_state;
+
 int main() {
 
 	printf("abs\n");
@@ -81,6 +164,78 @@ int main() {
 	}
 	printf("END\n\n");
 
+	printf("bsearch\n");
+	int even[100];
+	int key, *found;
+	int ok = 1;
+	for (int i = 0; i < 100; i++)
+		even[i] = 2 * i;
+	printf("TEST:\n");
+	for (int n = 0; n <= 100; n++) {
+		for (key = -1; key <= 2 * n; key++) {
+			found = bsearch(&key, even, n, sizeof(int), cmp_int);
+			if (key % 2 == 0 && key >= 0 && key < 2 * n)
+				ok &= found == &even[key / 2];
+			else
+				ok &= found == NULL;
+		}
+	}
+	printf("0: %-20s\t[ %s ]\n", "every key, n <= 100", TEST(ok));
+	printf("END\n\n");
+
+	printf("qsort\n");
+	static const int sizes[] = {0, 1, 2, 3, 16, 17, 100, 1000, SORT_MAX};
+	printf("TEST:\n");
+	for (int p = 0; p < PATTERN_COUNT; p++) {
+		ok = 1;
+		for (int i = 0; i < sizeof(sizes) / sizeof(*sizes); i++) {
+			fill_pattern(sort_t, sizes[i], p);
+			for (int j = 0; j < sizes[i]; j++)
+				sort_ref[j] = sort_t[j];
+			qsort(sort_t, sizes[i], sizeof(int), cmp_int);
+			ok &= check_sorted(sort_t, sort_ref, sizes[i]);
+		}
+		printf("%d: %-20s\t[ %s ]\n", p, pattern_names[p], TEST(ok));
+	}
+	struct test_rgb rgb[257];
+	ok = 1;
+	for (int i = 0; i < 257; i++) {
+		rgb[i].r = test_rand() >> 8;
+		rgb[i].g = rgb[i].r ^ 0x55;
+		rgb[i].b = ~rgb[i].r;
+	}
+	qsort(rgb, 257, sizeof(*rgb), cmp_rgb);
+	for (int i = 0; i < 257; i++) {
+		ok &= rgb[i].g == (rgb[i].r ^ 0x55) && rgb[i].b == (unsigned char)~rgb[i].r;
+		ok &= i == 0 || rgb[i - 1].r <= rgb[i].r;
+	}
+	printf("%d: %-20s\t[ %s ]\n", PATTERN_COUNT, "3 byte elements", TEST(ok));
+	printf("END\n\n");
+
+	printf("radix_sort\n");
+	printf("TEST:\n");
+	for (int p = 0; p < PATTERN_COUNT; p++) {
+		ok = 1;
+		for (int i = 0; i < sizeof(sizes) / sizeof(*sizes); i++) {
+			unsigned int sum = 0, xor = 0;
+			fill_pattern(sort_t, sizes[i], p);
+			for (int j = 0; j < sizes[i]; j++) {
+				radix_keys[j] = sort_t[j];
+				sum += radix_keys[j];
+				xor ^= radix_keys[j];
+			}
+			radix_sort(&radix_state, radix_keys, radix_tmp, sizes[i]);
+			for (int j = 0; j < sizes[i]; j++) {
+				ok &= j == 0 || radix_keys[j - 1] <= radix_keys[j];
+				sum -= radix_keys[j];
+				xor ^= radix_keys[j];
+			}
+			ok &= sum == 0 && xor == 0;
+		}
+		printf("%d: %-20s\t[ %s ]\n", p, pattern_names[p], TEST(ok));
+	}
+	printf("END\n\n");
+
 	printf("UL: %lx LMAX: %lx LMIN: %lx\n", ULONG_MAX, LONG_MAX, LONG_MIN);
 
 }
@@ -0,0 +1,205 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* bench.c
+ *
+ * Host benchmark of the memory and string functions, over sizes and
+ * alignments and against byte loops, run by make bench
+ *
+ * cc -O2 -fno-builtin -I../../include -o bench bench.c mem.c str.c && ./bench [file.csv]
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/string.h>
+#include "../bench.h"
+
+#define MAX_SIZE	65536
+// Room for the alignment offsets and the overlapping memmove
+#define BUF_SIZE	(MAX_SIZE + 64)
+
+static const size_t sizes[] = {8, 64, 512, 4096, MAX_SIZE};
+// Offset of the first operand from a 64 byte boundary, the second is aligned
+static const size_t aligns[] = {0, 1, 3};
+
+static char buf1[BUF_SIZE] __attribute__((aligned(64)));
+static char buf2[BUF_SIZE] __attribute__((aligned(64)));
+static char dst[BUF_SIZE] __attribute__((aligned(64)));
+static volatile size_t sink;
+
+/*
+ * Fills @s with @n 'a' and a terminating 0
+ */
+static void fill_string(char *s, size_t n) {
+	memset(s, 'a', n);
+	s[n] = '\0';
+}
+
+/*
+ * Byte loops, the baselines of the "byte" variant. The volatile accesses
+ * and the empty asm statements keep the compiler from turning them into
+ * calls to the library functions.
+ */
+static void byte_copy(void *d, const void *s, size_t n) {
+	volatile unsigned char *dc = d;
+	const volatile unsigned char *sc = s;
+
+	while (n--)
+		*dc++ = *sc++;
+}
+
+static void byte_move(void *d, const void *s, size_t n) {
+	volatile unsigned char *dc = d;
+	const volatile unsigned char *sc = s;
+
+	while (n--)
+		dc[n] = sc[n];
+}
+
+static void byte_fill(void *d, size_t n) {
+	volatile unsigned char *dc = d;
+
+	while (n--)
+		*dc++ = 0;
+}
+
+static size_t byte_strlen(const char *s) {
+	size_t n = 0;
+
+	while (s[n]) {
+		n++;
+		__asm__ ("");
+	}
+	return n;
+}
+
+static size_t byte_strchr(const char *s) {
+	while (*s && *s != '!') {
+		s++;
+		__asm__ ("");
+	}
+	return (size_t)s;
+}
+
+static size_t byte_strcmp(const char *s1, const char *s2) {
+	while (*s1 && *s1 == *s2) {
+		s1++, s2++;
+		__asm__ ("");
+	}
+	return *s1 - *s2;
+}
+
+static size_t byte_memchr(const char *s, size_t n) {
+	for (size_t i = 0; i < n; i++) {
+		if (s[i] == '!')
+			return i;
+		__asm__ ("");
+	}
+	return n;
+}
+
+static size_t byte_memcmp(const char *s1, const char *s2, size_t n) {
+	for (size_t i = 0; i < n; i++) {
+		if (s1[i] != s2[i])
+			return i;
+		__asm__ ("");
+	}
+	return n;
+}
+
+/*
+ * The byte loops, under the names of the functions they stand for
+ */
+static void bench_byte(size_t n, size_t align) {
+	size_t ops = bench_ops(n);
+	char *d = dst + align;
+	char *s1 = buf1 + align;
+	char *s2 = buf2;
+
+	fill_string(buf1, BUF_SIZE - 1);
+	BENCH_RUN("memcpy", "byte", n, align, ops, n, byte_copy(d, buf2, n));
+	BENCH_RUN("memmove", "byte-bw", n, align, ops, n, byte_move(s1 + 8, s1, n));
+	BENCH_RUN("memset", "byte", n, align, ops, n, byte_fill(d, n));
+	fill_string(s1, n);
+	fill_string(s2, n);
+	BENCH_RUN("strlen", "byte", n, align, ops, n, sink = byte_strlen(s1));
+	BENCH_RUN("strchr", "byte", n, align, ops, n, sink = byte_strchr(s1));
+	BENCH_RUN("strcmp", "byte", n, align, ops, n, sink = byte_strcmp(s1, s2));
+	BENCH_RUN("memchr", "byte", n, align, ops, n, sink = byte_memchr(s1, n));
+	BENCH_RUN("memcmp", "byte", n, align, ops, n, sink = byte_memcmp(s1, s2, n));
+}
+
+/*
+ * The memory functions, with the variant of mem_erms
+ */
+static void bench_mem(const char *variant, size_t n, size_t align) {
+	size_t ops = bench_ops(n);
+	char *d = dst + align;
+	char *s1 = buf1 + align;
+	char backward[16];
+
+	snprintf(backward, sizeof(backward), "%s-bw", variant);
+	fill_string(buf1, BUF_SIZE - 1);
+	BENCH_RUN("memcpy", variant, n, align, ops, n, memcpy(d, buf2, n));
+	BENCH_RUN("memmove", variant, n, align, ops, n, memmove(d, buf2, n));
+	// Overlapping the end of the source: copied backward
+	BENCH_RUN("memmove", backward, n, align, ops, n, memmove(s1 + 8, s1, n));
+	BENCH_RUN("memset", variant, n, align, ops, n, memset(d, 0, n));
+}
+
+/*
+ * The search and compare functions, which all go through the @n bytes of
+ * their first operand
+ */
+static void bench_str(size_t n, size_t align) {
+	size_t ops = bench_ops(n);
+	char *s1 = buf1 + align;
+	char *s2 = buf2;
+	char *d = dst;
+
+	fill_string(s1, n);
+	fill_string(s2, n);
+	BENCH_RUN("strlen", "-", n, align, ops, n, sink = strlen(s1));
+	BENCH_RUN("strchr", "-", n, align, ops, n, sink = (size_t)strchr(s1, '!'));
+	BENCH_RUN("strrchr", "-", n, align, ops, n, sink = (size_t)strrchr(s1, '!'));
+	BENCH_RUN("strcmp", "-", n, align, ops, n, sink = strcmp(s1, s2));
+	BENCH_RUN("strncmp", "-", n, align, ops, n, sink = strncmp(s1, s2, n));
+	BENCH_RUN("strspn", "-", n, align, ops, n, sink = strspn(s1, "a"));
+	BENCH_RUN("strcspn", "-", n, align, ops, n, sink = strcspn(s1, "!,"));
+	BENCH_RUN("strpbrk", "-", n, align, ops, n, sink = (size_t)strpbrk(s1, "!,"));
+	BENCH_RUN("strstr", "-", n, align, ops, n, sink = (size_t)strstr(s1, "aab"));
+	// Without delimiters strtok does not write to the string
+	BENCH_RUN("strtok", "-", n, align, ops, n, sink = (size_t)strtok(s1, ","));
+	BENCH_RUN("strcpy", "-", n, align, ops, n, strcpy(d, s1));
+	BENCH_RUN("strncpy", "-", n, align, ops, n, strncpy(d, s1, n));
+	BENCH_RUN("strcat", "-", n, align, ops, n, (d[0] = '\0', strcat(d, s1)));
+	BENCH_RUN("strncat", "-", n, align, ops, n, (d[0] = '\0', strncat(d, s1, n)));
+	BENCH_RUN("memchr", "-", n, align, ops, n, sink = (size_t)memchr(s1, '!', n));
+	BENCH_RUN("memrchr", "-", n, align, ops, n, sink = (size_t)memrchr(s1, '!', n));
+	BENCH_RUN("memcmp", "-", n, align, ops, n, sink = memcmp(s1, s2, n));
+}
+
+int main(int argc, char **argv) {
+	int erms;
+
+	bench_init("string", argc, argv);
+	// The first call reads cpuid
+	memset(dst, 0, 1);
+	erms = mem_erms;
+	for (size_t i = 0; i < sizeof(sizes) / sizeof(*sizes); i++) {
+		for (size_t j = 0; j < sizeof(aligns) / sizeof(*aligns); j++) {
+			mem_erms = 0;
+			bench_mem("dword", sizes[i], aligns[j]);
+			if (erms) {
+				mem_erms = 1;
+				bench_mem("erms", sizes[i], aligns[j]);
+			}
+			mem_erms = erms;
+			bench_str(sizes[i], aligns[j]);
+			bench_byte(sizes[i], aligns[j]);
+		}
+	}
+	bench_fini();
+	return 0;
+}
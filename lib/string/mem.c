@@ -5,20 +5,61 @@
  *
  * memory related functions of the string library
  *
+ * Copies and fills use the string instructions: rep movsb/stosb alone when
+ * the cpu has fast short string operations (ERMS or FSRM), otherwise rep
+ * movsd/stosd on a dword aligned destination, with the unaligned head and
+ * the tail done by rep movsb/stosb. Small sizes are done by byte loops, as
+ * string instructions take tens of cycles to start; an empty asm statement
+ * in their body keeps the compiler from turning them back into calls to
+ * these functions.
+ *
+ * memchr and memcmp go a word at a time once aligned, see
+ * string_internal.h. They never read outside of the @n bytes.
+ *
  * created: 2022/10/12 - lfalkau <lfalkau@student.42.fr>
- * updated: 2022/11/18 - lfalkau <lfalkau@student.42.fr>
+ * updated: 2026/10/19 - agent <agent@local>
  */
 
 #include <stddef.h>
 #include <stdint.h>
 
+#include <kernel/cpu.h>
+
+#include "string_internal.h"
+
+/* Below this size, byte loops are faster than string instructions */
+#define MEM_SMALL	32
+
+int mem_erms = -1;
+
+static int mem_fast_strings() {
+	uint32_t regs[4];
+
+	if (mem_erms < 0) {
+		mem_erms = 0;
+		cpuid(0, regs);
+		if (regs[0] >= 7) {
+			cpuid(7, regs);
+			mem_erms = (regs[1] & CPUID_7_EBX_ERMS) || (regs[3] & CPUID_7_EDX_FSRM);
+		}
+	}
+	return mem_erms;
+}
+
 void *memchr(const void *s, int c, size_t n) {
-	unsigned char *sc = (unsigned char *)s;
+	const unsigned char *p = s;
+	uint32_t mask = STR_REPEAT(c);
+	const str_word_t *w;
 
-	while (n--) {
-		if (*sc == c)
-			return (void *)sc;
-		sc++;
+	for (; n > 0 && !STR_ALIGNED(p); p++, n--) {
+		if (*p == (unsigned char)c)
+			return (void *)p;
+	}
+	for (w = (const str_word_t *)p; n >= STR_WORD_SIZE && !STR_HASZERO(*w ^ mask); w++)
+		n -= STR_WORD_SIZE;
+	for (p = (const unsigned char *)w; n > 0; p++, n--) {
+		if (*p == (unsigned char)c)
+			return (void *)p;
 	}
 	return NULL;
 }
@@ -36,47 +77,111 @@ void *memrchr(const void *s, int c, size_t n) {
 }
 
 int  memcmp(const void *s1, const void *s2, size_t n) {
-	unsigned char *sc1 = (unsigned char *)s1;
-	unsigned char *sc2 = (unsigned char *)s2;
+	const unsigned char *p1 = s1;
+	const unsigned char *p2 = s2;
+
+	// @s1 is aligned, @s2 is loaded unaligned
+	for (; n > 0 && !STR_ALIGNED(p1); p1++, p2++, n--) {
+		if (*p1 != *p2)
+			return *p1 - *p2;
+	}
+	for (; n >= STR_WORD_SIZE; p1 += STR_WORD_SIZE, p2 += STR_WORD_SIZE, n -= STR_WORD_SIZE) {
+		if (*(const str_word_t *)p1 != *(const str_uword_t *)p2)
+			break;
+	}
+	for (; n > 0; p1++, p2++, n--) {
+		if (*p1 != *p2)
+			return *p1 - *p2;
+	}
+	return 0;
+}
 
-	while (n > 0 && *sc1 == *sc2) {
-		sc1++, sc2++, n--;
+/*
+ * Copies @n bytes forward, or backward if @back is set, one at a time.
+ */
+static inline void mem_copy_bytes(unsigned char *d, const unsigned char *s, size_t n, int back) {
+	for (size_t i = 0; i < n; i++) {
+		if (back)
+			d[n - 1 - i] = s[n - 1 - i];
+		else
+			d[i] = s[i];
+		__asm__ ("");
 	}
-	return n == 0 ? 0 : *sc1 - *sc2;
 }
 
 void *memcpy(void *dst, const void *src, size_t n) {
-	void *ptr = dst;
+	void *d = dst;
+	size_t head, words;
 
-	while (n--) {
-		*(unsigned char *)dst = *(unsigned char *)src;
-		dst++, src++;
+	if (n < MEM_SMALL) {
+		mem_copy_bytes(dst, src, n, 0);
+		return dst;
 	}
-	return ptr;
+	if (mem_fast_strings()) {
+		__asm__ volatile ("rep movsb" : "+D" (d), "+S" (src), "+c" (n) :: "memory");
+		return dst;
+	}
+	head = -(uintptr_t)d & 3;
+	mem_copy_bytes(d, src, head, 0);
+	d += head;
+	src += head;
+	words = (n - head) / 4;
+	__asm__ volatile ("rep movsl" : "+D" (d), "+S" (src), "+c" (words) :: "memory");
+	mem_copy_bytes(d, src, (n - head) & 3, 0);
+	return dst;
 }
 
 void *memmove(void *dst, const void *src, size_t n) {
-	unsigned char *dstc = dst;
-	const unsigned char *srcc = src;
-	void *ptr = dst;
+	size_t tail, words;
+	void *d;
+	const void *s;
 
-	while (n--) {
-		if (dstc > srcc) {
-			*(dstc + n) = *(srcc + n);
-		} else {
-			*dstc = *srcc;
-			dstc++, srcc++;
-		}
+	// A forward copy only overwrites source bytes it has already read when
+	// @dst is before @src or after its end
+	if ((uintptr_t)dst - (uintptr_t)src >= n)
+		return memcpy(dst, src, n);
+	if (n < MEM_SMALL) {
+		mem_copy_bytes(dst, src, n, 1);
+		return dst;
 	}
-	return ptr;
+
+	// Backward from the end, which is aligned first. The direction flag is
+	// cleared again before returning.
+	tail = (uintptr_t)(dst + n) & 3;
+	n -= tail;
+	mem_copy_bytes(dst + n, src + n, tail, 1);
+	words = n / 4;
+	n &= 3;
+	d = dst + n + (words - 1) * 4;
+	s = src + n + (words - 1) * 4;
+	__asm__ volatile ("std\n\trep movsl\n\tcld" : "+D" (d), "+S" (s), "+c" (words) :: "memory");
+	mem_copy_bytes(dst, src, n, 1);
+	return dst;
 }
 
 void *memset(void *s, int c, size_t n) {
-	unsigned char *sc = s;
-	void *ptr = s;
+	uint32_t fill = (uint8_t)c * 0x01010101U;
+	unsigned char *d = s;
+	size_t head, words;
 
+	if (n >= MEM_SMALL && mem_fast_strings()) {
+		__asm__ volatile ("rep stosb" : "+D" (d), "+c" (n) : "a" (fill) : "memory");
+		return s;
+	}
+	if (n >= MEM_SMALL) {
+		head = -(uintptr_t)d & 3;
+		n -= head;
+		while (head--) {
+			*d++ = c;
+			__asm__ ("");
+		}
+		words = n / 4;
+		n &= 3;
+		__asm__ volatile ("rep stosl" : "+D" (d), "+c" (words) : "a" (fill) : "memory");
+	}
 	while (n--) {
-		*sc++ = c;
+		*d++ = c;
+		__asm__ ("");
 	}
-	return ptr;
+	return s;
 }
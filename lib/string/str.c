@@ -5,12 +5,17 @@
  *
  * string related functions for the string library
  *
+ * strlen, strchr and strcmp go a word at a time once aligned, see
+ * string_internal.h.
+ *
  * created: 2022/10/12 - lfalkau <lfalkau@student.42.fr>
- * updated: 2022/10/19 - lfalkau <lfalkau@student.42.fr>
+ * updated: 2026/10/19 - agent <agent@local>
  */
 
 #include <stddef.h>
 
+#include "string_internal.h"
+
 static int isof(int c, const char *charset) {
 	while (*charset) {
 		if (c == *charset)
@@ -21,18 +26,39 @@ static int isof(int c, const char *charset) {
 }
 
 size_t	strlen(const char *s) {
-	size_t i = 0;
+	const char *p = s;
+	const str_word_t *w;
 
-	while (*s++) {
-		i++;
+	for (; !STR_ALIGNED(p); p++) {
+		if (*p == '\0')
+			return p - s;
 	}
-	return i;
+	for (w = (const str_word_t *)p; !STR_HASZERO(*w); w++)
+		;
+	for (p = (const char *)w; *p; p++)
+		;
+	return p - s;
 }
 
 char *strchr(const char *s, int c) {
-	while (*s && *s != c)
-		s++;
-	return *s == c ? (char *)s : NULL;	
+	uint32_t mask = STR_REPEAT(c);
+	const str_word_t *w;
+	uint32_t v;
+
+	for (; !STR_ALIGNED(s); s++) {
+		if (*s == (char)c)
+			return (char *)s;
+		if (*s == '\0')
+			return NULL;
+	}
+	// Stops on the word holding the end of the string or @c
+	for (w = (const str_word_t *)s; v = *w, !STR_HASZERO(v) && !STR_HASZERO(v ^ mask); w++)
+		;
+	for (s = (const char *)w; *s != (char)c; s++) {
+		if (*s == '\0')
+			return NULL;
+	}
+	return (char *)s;
 }
 
 char *strrchr(const char *s, int c) {
@@ -45,17 +71,42 @@ char *strrchr(const char *s, int c) {
 }
 
 int strcmp(const char *s1, const char *s2) {
-	while (*s1 && *s2 && *s1 == *s2) {
-		s1++, s2++;
+	const unsigned char *p1 = (const unsigned char *)s1;
+	const unsigned char *p2 = (const unsigned char *)s2;
+	uint32_t w;
+
+	for (; !STR_ALIGNED(p1); p1++, p2++) {
+		if (*p1 != *p2 || *p1 == '\0')
+			return *p1 - *p2;
 	}
-	return *s1 - *s2;
+	// Words of @s1 are aligned, those of @s2 may not be: one crossing a page
+	// is compared byte by byte. The string ends at the first zero byte of
+	// @s1, or at a byte differing from it.
+	for (;;) {
+		if (STR_CROSSES_PAGE(p2)) {
+			for (size_t i = 0; i < STR_WORD_SIZE; i++, p1++, p2++) {
+				if (*p1 != *p2 || *p1 == '\0')
+					return *p1 - *p2;
+			}
+			continue;
+		}
+		w = *(const str_word_t *)p1;
+		if (w != *(const str_uword_t *)p2 || STR_HASZERO(w))
+			break;
+		p1 += STR_WORD_SIZE;
+		p2 += STR_WORD_SIZE;
+	}
+	while (*p1 == *p2 && *p1 != '\0')
+		p1++, p2++;
+	return *p1 - *p2;
 }
 
 int strncmp(const char *s1, const char *s2, size_t n) {
-	while (n-- && *s1 && *s2 && *s1 == *s2) {
-		s1++, s2++;
+	for (; n > 0; n--, s1++, s2++) {
+		if (*s1 != *s2 || *s1 == '\0')
+			return (unsigned char)*s1 - (unsigned char)*s2;
 	}
-	return n == 0 ? 0 : *s1 - *s2;
+	return 0;
 }
 
 char *strcpy(char *dst, const char *src) {
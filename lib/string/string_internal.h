@@ -0,0 +1,40 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* string_internal.h
+ *
+ * Word at a time helpers of the string library
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#ifndef STRING_INTERNAL_H
+#define STRING_INTERNAL_H
+
+#include <stdint.h>
+
+/*
+ * Strings are read 4 bytes at a time. Reading past the end of a string is
+ * only done by aligned loads, which never cross a page boundary, so they
+ * never touch a page the string is not in. Unaligned loads are only done
+ * when the word does not cross a page boundary.
+ */
+typedef uint32_t __attribute__((may_alias)) str_word_t;
+typedef uint32_t __attribute__((may_alias, aligned(1))) str_uword_t;
+
+#define STR_WORD_SIZE		sizeof(uint32_t)
+#define STR_ALIGNED(p)		(((uintptr_t)(p) & (STR_WORD_SIZE - 1)) == 0)
+#define STR_PAGE_SIZE		4096
+#define STR_CROSSES_PAGE(p)	(((uintptr_t)(p) & (STR_PAGE_SIZE - 1)) > STR_PAGE_SIZE - STR_WORD_SIZE)
+
+#define STR_ONES			0x01010101U
+#define STR_HIGHS			0x80808080U
+
+/* Non zero if one of the bytes of @w is 0 */
+#define STR_HASZERO(w)		(((w) - STR_ONES) & ~(w) & STR_HIGHS)
+
+/* Word with each byte set to @c */
+#define STR_REPEAT(c)		((uint8_t)(c) * STR_ONES)
+
+#endif
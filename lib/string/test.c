@@ -6,12 +6,13 @@
  * Unit tests of the string library
  *
  * created: 2022/10/12 - lfalkau <lfalkau@student.42.fr>
- * updated: 2022/10/19 - lfalkau <lfalkau@student.42.fr>
+ * updated: 2026/10/19 - agent <agent@local>
  */
 
 #include <kernel/string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/mman.h>
 
 #define ASSERT(x)\
 test_count += 1;\
@@ -103,6 +104,186 @@ static int test_strncmp() {
 	ASSERT(strncmp(s3, s4, 2) == 0);
 	ASSERT(strncmp(s3, s4, 9) != 0);
 	ASSERT(strncmp(s1, s4, 0) == 0); 
+
+	return 0;
+}
+
+/*
+ * Byte by byte references, through volatile pointers so that they are not
+ * turned into calls to the functions tested
+ */
+static void ref_copy(volatile unsigned char *dst, volatile unsigned char *src, size_t n) {
+	if (dst > src) {
+		while (n--)
+			dst[n] = src[n];
+	} else {
+		for (size_t i = 0; i < n; i++)
+			dst[i] = src[i];
+	}
+}
+
+static void ref_fill(volatile unsigned char *dst, int c, size_t n) {
+	for (size_t i = 0; i < n; i++)
+		dst[i] = c;
+}
+
+static unsigned char buf[256];
+static unsigned char ref[256];
+
+static void fill_pattern() {
+	for (size_t i = 0; i < sizeof(buf); i++) {
+		buf[i] = i * 7 + 1;
+		ref[i] = buf[i];
+	}
+}
+
+/*
+ * Every size up to 100 bytes from and to every alignment, with both the
+ * byte and dword paths
+ */
+static int test_memcpy() {
+	int ok = 1;
+
+	for (mem_erms = 0; mem_erms <= 1; mem_erms++) {
+		for (size_t n = 0; n <= 100; n++) {
+			for (size_t d = 0; d < 4; d++) {
+				for (size_t s = 0; s < 4; s++) {
+					fill_pattern();
+					ok &= memcpy(buf + d, buf + 128 + s, n) == buf + d;
+					ref_copy(ref + d, ref + 128 + s, n);
+					ok &= memcmp(buf, ref, sizeof(buf)) == 0;
+				}
+			}
+		}
+	}
+	ASSERT(ok);
+
+	return 0;
+}
+
+static int test_memmove() {
+	int ok = 1;
+
+	for (mem_erms = 0; mem_erms <= 1; mem_erms++) {
+		for (size_t n = 0; n <= 100; n++) {
+			for (size_t d = 0; d < 12; d++) {
+				for (size_t s = 0; s < 12; s++) {
+					fill_pattern();
+					ok &= memmove(buf + 64 + d, buf + 64 + s, n) == buf + 64 + d;
+					ref_copy(ref + 64 + d, ref + 64 + s, n);
+					ok &= memcmp(buf, ref, sizeof(buf)) == 0;
+				}
+			}
+		}
+	}
+	ASSERT(ok);
+
+	return 0;
+}
+
+static int test_memset() {
+	int ok = 1;
+
+	for (mem_erms = 0; mem_erms <= 1; mem_erms++) {
+		for (size_t n = 0; n <= 100; n++) {
+			for (size_t d = 0; d < 4; d++) {
+				fill_pattern();
+				ok &= memset(buf + d, 0x1a5, n) == buf + d;
+				ref_fill(ref + d, 0xa5, n);
+				ok &= memcmp(buf, ref, sizeof(buf)) == 0;
+			}
+		}
+	}
+	ASSERT(ok);
+
+	return 0;
+}
+
+static int ref_strcmp(const char *s1, const char *s2) {
+	while (*s1 && *s1 == *s2)
+		s1++, s2++;
+	return (unsigned char)*s1 - (unsigned char)*s2;
+}
+
+static int sign(int x) {
+	return (x > 0) - (x < 0);
+}
+
+/*
+ * Every length up to 64 bytes at every alignment, so that the end and the
+ * searched character fall in every byte of a word
+ */
+static int test_words() {
+	char a[128], b[128];
+	int ok = 1;
+
+	for (size_t off = 0; off < 4; off++) {
+		for (size_t len = 0; len < 64; len++) {
+			char *s = a + off;
+			for (size_t i = 0; i < len; i++)
+				s[i] = 'a' + i % 26;
+			s[len] = '\0';
+			ok &= strlen(s) == len;
+			ok &= strchr(s, '\0') == s + len;
+			ok &= strchr(s, 0x80) == NULL;
+			if (len > 0)
+				ok &= strchr(s, s[len - 1]) == s + (len - 1 < 26 ? len - 1 : (len - 1) % 26);
+			ok &= memchr(s, '\0', len + 1) == s + len;
+			ok &= memchr(s, '\0', len) == NULL;
+			for (size_t off2 = 0; off2 < 4; off2++) {
+				char *t = b + off2;
+				for (size_t i = 0; i <= len; i++)
+					t[i] = s[i];
+				ok &= strcmp(s, t) == 0;
+				ok &= memcmp(s, t, len) == 0;
+				if (len == 0)
+					continue;
+				t[len - 1] = '\xf0';
+				ok &= sign(strcmp(s, t)) == sign(ref_strcmp(s, t));
+				ok &= sign(memcmp(s, t, len)) < 0;
+				t[len - 1] = '\0';
+				ok &= strcmp(s, t) > 0 && strcmp(t, s) < 0;
+			}
+		}
+	}
+	ASSERT(ok);
+
+	return 0;
+}
+
+/*
+ * Strings ending at the last byte before an inaccessible page: a read
+ * past the end across the page boundary faults.
+ */
+static int test_page_boundary() {
+	char *page = mmap(NULL, 8192, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	char other[16];
+	int ok = 1;
+
+	if (page == MAP_FAILED || mprotect(page + 4096, 4096, PROT_NONE) < 0) {
+		ASSERT(0);
+		return 0;
+	}
+	for (size_t len = 0; len < 12; len++) {
+		char *s = page + 4096 - len - 1;
+		for (size_t i = 0; i < len; i++)
+			s[i] = 'x';
+		s[len] = '\0';
+		ok &= strlen(s) == len;
+		ok &= strchr(s, 'y') == NULL;
+		for (size_t off = 0; off < 4; off++) {
+			for (size_t i = 0; i <= len; i++)
+				other[off + i] = s[i];
+			ok &= strcmp(other + off, s) == 0;
+			ok &= strcmp(s, other + off) == 0;
+		}
+		ok &= memchr(s, 'y', len + 1) == NULL;
+		ok &= memcmp(s, page + 4096 - len - 1, len + 1) == 0;
+	}
+	munmap(page, 8192);
+	ASSERT(ok);
+
+	return 0;
 }
 
 int main() {
@@ -113,12 +294,17 @@ int main() {
 	test_strrchr();
 	test_strncmp();
 	test_strcmp();
+	test_memcpy();
+	test_memmove();
+	test_memset();
+	test_words();
+	test_page_boundary();
 
 	if (failed_tests == 0) {
 		printf("-- All %d tests passed --\n", test_count);
 	} else {
 		printf("-- %d/%d tests passed --\n", test_count - failed_tests, test_count);
 	}
-	printf("\033[33mWarning: Only 5 out of 20 functions are currently tested\033[0m\n");
+	printf("\033[33mWarning: Only 10 out of 20 functions are currently tested\033[0m\n");
 	return 0;
 }
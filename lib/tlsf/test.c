@@ -0,0 +1,175 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* test.c
+ *
+ * Unit tests of the tlsf library
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/tlsf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ASSERT(x)\
+test_count += 1;\
+if(!(x)) {\
+	printf("[\033[31mKO\033[0m]: %s l.%d\n", __func__, __LINE__);\
+	failed_tests += 1;\
+}
+
+#define POOL_SIZE	(256 * 1024)
+#define NSLOTS		512
+
+int test_count = 0;
+int failed_tests = 0;
+
+static struct tlsf t;
+static size_t pool_words[POOL_SIZE / sizeof(size_t)];
+static void *pool = pool_words;
+
+static struct {
+	unsigned char *ptr;
+	size_t size;
+} slots[NSLOTS];
+
+static int test_create() {
+	ASSERT(tlsf_create(&t, pool, 8) == -1);
+	ASSERT(tlsf_create(&t, pool + 1, POOL_SIZE) == -1);
+	ASSERT(tlsf_create(&t, pool, POOL_SIZE) == 0);
+	ASSERT(t.size > POOL_SIZE - 64 && t.size < POOL_SIZE);
+	ASSERT(tlsf_largest(&t) == t.size);
+	ASSERT(t.used == 0);
+
+	return 0;
+}
+
+static int test_simple() {
+	void *a, *b, *c;
+
+	tlsf_create(&t, pool, POOL_SIZE);
+	ASSERT(tlsf_malloc(&t, 0) == NULL);
+	ASSERT(tlsf_malloc(&t, POOL_SIZE) == NULL);
+	ASSERT(t.failures == 1);
+
+	a = tlsf_malloc(&t, 1);
+	b = tlsf_malloc(&t, 100);
+	c = tlsf_malloc(&t, 1000);
+	ASSERT(a && b && c);
+	ASSERT(((uintptr_t)a | (uintptr_t)b | (uintptr_t)c) % TLSF_ALIGN == 0);
+	ASSERT(a != b && b != c);
+	memset(a, 0xaa, 1);
+	memset(b, 0xbb, 100);
+	memset(c, 0xcc, 1000);
+	ASSERT(((unsigned char *)a)[0] == 0xaa);
+	ASSERT(((unsigned char *)b)[99] == 0xbb);
+
+	// The block in the middle is reused for a request of the same size
+	tlsf_free(&t, b);
+	ASSERT(tlsf_malloc(&t, 100) == b);
+
+	tlsf_free(&t, a);
+	tlsf_free(&t, b);
+	tlsf_free(&t, c);
+	tlsf_free(&t, NULL);
+	ASSERT(t.used == 0);
+	ASSERT(tlsf_largest(&t) == t.size);
+
+	return 0;
+}
+
+static int test_coalesce() {
+	void *p[8];
+
+	tlsf_create(&t, pool, POOL_SIZE);
+	for (int i = 0; i < 8; i++)
+		p[i] = tlsf_malloc(&t, 64);
+	// Frees every other block, then the ones between: each release merges
+	// with both neighbours
+	for (int i = 0; i < 8; i += 2)
+		tlsf_free(&t, p[i]);
+	ASSERT(tlsf_malloc(&t, 200) != p[0]);
+	tlsf_create(&t, pool, POOL_SIZE);
+	for (int i = 0; i < 8; i++)
+		p[i] = tlsf_malloc(&t, 64);
+	for (int i = 0; i < 8; i += 2)
+		tlsf_free(&t, p[i]);
+	for (int i = 1; i < 8; i += 2)
+		tlsf_free(&t, p[i]);
+	ASSERT(tlsf_largest(&t) == t.size);
+	// Requests are rounded up to the next list, the whole pool cannot be
+	// allocated at once but the blocks were merged back at its start
+	ASSERT(tlsf_malloc(&t, t.size) == NULL);
+	ASSERT(tlsf_malloc(&t, t.size / 2) == p[0]);
+
+	return 0;
+}
+
+static int test_exhaust() {
+	int n = 0;
+
+	tlsf_create(&t, pool, POOL_SIZE);
+	while (n < NSLOTS && (slots[n].ptr = tlsf_malloc(&t, 4096)) != NULL)
+		n++;
+	ASSERT(n == POOL_SIZE / 4096 - 1);
+	ASSERT(t.failures == 1);
+	for (int i = 0; i < n; i++)
+		tlsf_free(&t, slots[i].ptr);
+	ASSERT(t.used == 0);
+	ASSERT(tlsf_largest(&t) == t.size);
+
+	return 0;
+}
+
+static int test_random() {
+	int ok = 1;
+
+	tlsf_create(&t, pool, POOL_SIZE);
+	memset(slots, 0, sizeof(slots));
+	srand(42);
+	for (int round = 0; round < 200000; round++) {
+		int i = rand() % NSLOTS;
+		if (slots[i].ptr) {
+			for (size_t j = 0; j < slots[i].size; j++)
+				ok &= slots[i].ptr[j] == (unsigned char)(i + j);
+			tlsf_free(&t, slots[i].ptr);
+			slots[i].ptr = NULL;
+			continue;
+		}
+		slots[i].size = rand() % 4 ? rand() % 128 + 1 : rand() % 4096 + 1;
+		if ((slots[i].ptr = tlsf_malloc(&t, slots[i].size)) == NULL)
+			continue;
+		ok &= (uintptr_t)slots[i].ptr % TLSF_ALIGN == 0;
+		for (size_t j = 0; j < slots[i].size; j++)
+			slots[i].ptr[j] = i + j;
+	}
+	ASSERT(ok);
+	ASSERT(t.max_used <= t.size);
+	for (int i = 0; i < NSLOTS; i++)
+		tlsf_free(&t, slots[i].ptr);
+	ASSERT(t.used == 0);
+	ASSERT(t.allocs == t.frees);
+	ASSERT(tlsf_largest(&t) == t.size);
+
+	return 0;
+}
+
+int main() {
+	printf("-- Running test suite --\n");
+
+	test_create();
+	test_simple();
+	test_coalesce();
+	test_exhaust();
+	test_random();
+
+	if (failed_tests == 0) {
+		printf("-- All %d tests passed --\n", test_count);
+	} else {
+		printf("-- %d/%d tests passed --\n", test_count - failed_tests, test_count);
+	}
+	return 0;
+}
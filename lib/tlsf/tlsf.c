@@ -0,0 +1,244 @@
+// SPDX-FileCopyrightText: CGL-KFS
+// SPDX-License-Identifier: BSD-3-Clause
+
+/* lib/tlsf/tlsf.c
+ *
+ * Two-level segregated fit allocator
+ *
+ * A request is rounded up to the next second level range, so that any
+ * block of that list or of a later one fits: finding it takes one bsf on
+ * each bitmap, and never walks a list. Blocks are split on allocation and
+ * merged with their free neighbours on release, using the flags stored in
+ * the low bits of their size.
+ *
+ * created: 2026/10/19 - agent <agent@local>
+ * updated: 2026/10/19 - agent <agent@local>
+ */
+
+#include <kernel/tlsf.h>
+
+#define TLSF_FREE			(1 << 0)
+#define TLSF_PREV_FREE		(1 << 1)
+
+/* Bytes of a used block that are not given to the caller */
+#define TLSF_OVERHEAD		sizeof(size_t)
+
+/* Offset of the memory given to the caller in a block */
+#define TLSF_PAYLOAD		offsetof(struct tlsf_block, next_free)
+
+/* A free block holds its list links and the @prev_phys of the next one */
+#define TLSF_MIN_SIZE		(sizeof(struct tlsf_block) - sizeof(struct tlsf_block *))
+
+/*
+ * Returns the index of the lowest bit set in @x, which must not be 0
+ */
+static inline int tlsf_ffs(uint32_t x) {
+	int bit;
+
+	__asm__ ("bsf %1, %0" : "=r" (bit) : "rm" (x));
+	return bit;
+}
+
+/*
+ * Returns the index of the highest bit set in @x, which must not be 0
+ */
+static inline int tlsf_fls(uint32_t x) {
+	int bit;
+
+	__asm__ ("bsr %1, %0" : "=r" (bit) : "rm" (x));
+	return bit;
+}
+
+static inline size_t tlsf_size(struct tlsf_block *block) {
+	return block->size & ~(size_t)(TLSF_FREE | TLSF_PREV_FREE);
+}
+
+static inline struct tlsf_block *tlsf_next(struct tlsf_block *block) {
+	return (void *)block + TLSF_PAYLOAD + tlsf_size(block) - TLSF_OVERHEAD;
+}
+
+/*
+ * Gives the list of free blocks of @size bytes.
+ */
+static void tlsf_mapping(size_t size, int *fl, int *sl) {
+	int bit;
+
+	if (size < TLSF_SMALL_SIZE) {
+		*fl = 0;
+		*sl = size >> TLSF_ALIGN_LOG2;
+		return;
+	}
+	bit = tlsf_fls(size);
+	*sl = (size >> (bit - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT;
+	*fl = bit - TLSF_FL_SHIFT + 1;
+}
+
+static void tlsf_insert(struct tlsf *t, struct tlsf_block *block) {
+	int fl, sl;
+
+	tlsf_mapping(tlsf_size(block), &fl, &sl);
+	block->prev_free = NULL;
+	block->next_free = t->blocks[fl][sl];
+	if (block->next_free)
+		block->next_free->prev_free = block;
+	t->blocks[fl][sl] = block;
+	t->fl_bitmap |= 1U << fl;
+	t->sl_bitmap[fl] |= 1U << sl;
+}
+
+static void tlsf_remove(struct tlsf *t, struct tlsf_block *block) {
+	int fl, sl;
+
+	tlsf_mapping(tlsf_size(block), &fl, &sl);
+	if (block->next_free)
+		block->next_free->prev_free = block->prev_free;
+	if (block->prev_free) {
+		block->prev_free->next_free = block->next_free;
+		return;
+	}
+	t->blocks[fl][sl] = block->next_free;
+	if (block->next_free == NULL) {
+		t->sl_bitmap[fl] &= ~(1U << sl);
+		if (t->sl_bitmap[fl] == 0)
+			t->fl_bitmap &= ~(1U << fl);
+	}
+}
+
+/*
+ * Returns a free block of at least @size bytes, or NULL if there is none
+ */
+static struct tlsf_block *tlsf_find(struct tlsf *t, size_t size) {
+	uint32_t map;
+	int fl, sl;
+
+	// Every block of the list after the one of @size is big enough
+	if (size >= TLSF_SMALL_SIZE)
+		size += (1U << (tlsf_fls(size) - TLSF_SL_LOG2)) - 1;
+	tlsf_mapping(size, &fl, &sl);
+
+	map = t->sl_bitmap[fl] & (~0U << sl);
+	if (map == 0) {
+		map = t->fl_bitmap & (~0U << (fl + 1));
+		if (map == 0)
+			return NULL;
+		fl = tlsf_ffs(map);
+		map = t->sl_bitmap[fl];
+	}
+	sl = tlsf_ffs(map);
+	return t->blocks[fl][sl];
+}
+
+int tlsf_create(struct tlsf *t, void *mem, size_t size) {
+	struct tlsf_block *block, *end;
+	size_t bytes;
+
+	t->fl_bitmap = 0;
+	for (int fl = 0; fl < TLSF_FL_COUNT; fl++) {
+		t->sl_bitmap[fl] = 0;
+		for (int sl = 0; sl < TLSF_SL_COUNT; sl++)
+			t->blocks[fl][sl] = NULL;
+	}
+	t->size = 0;
+	t->used = 0;
+	t->max_used = 0;
+	t->allocs = 0;
+	t->frees = 0;
+	t->failures = 0;
+
+	// The pool is a single free block followed by an empty used one, which
+	// stops merges. The @prev_phys of the first block is before the pool,
+	// but never used.
+	size &= ~(size_t)(TLSF_ALIGN - 1);
+	if ((uintptr_t)mem & (TLSF_ALIGN - 1) || size < 2 * TLSF_OVERHEAD + TLSF_MIN_SIZE)
+		return -1;
+	bytes = size - 2 * TLSF_OVERHEAD;
+	if (bytes >= 1U << TLSF_FL_MAX)
+		return -1;
+	block = mem - TLSF_OVERHEAD;
+	block->size = bytes | TLSF_FREE;
+	end = tlsf_next(block);
+	end->prev_phys = block;
+	end->size = TLSF_PREV_FREE;
+	tlsf_insert(t, block);
+	t->size = bytes;
+	return 0;
+}
+
+void *tlsf_malloc(struct tlsf *t, size_t size) {
+	struct tlsf_block *block, *rest;
+
+	if (size == 0 || size > TLSF_MAX_SIZE)
+		return NULL;
+	size = (size + TLSF_ALIGN - 1) & ~(size_t)(TLSF_ALIGN - 1);
+	if (size < TLSF_MIN_SIZE)
+		size = TLSF_MIN_SIZE;
+	if ((block = tlsf_find(t, size)) == NULL) {
+		t->failures++;
+		return NULL;
+	}
+	tlsf_remove(t, block);
+
+	if (tlsf_size(block) >= size + sizeof(struct tlsf_block)) {
+		// The end of the block goes back to the lists, the block after it
+		// still has a free block before it
+		rest = (void *)block + TLSF_PAYLOAD + size - TLSF_OVERHEAD;
+		rest->size = (tlsf_size(block) - size - TLSF_OVERHEAD) | TLSF_FREE;
+		block->size = size | (block->size & TLSF_PREV_FREE);
+		tlsf_next(rest)->prev_phys = rest;
+		tlsf_insert(t, rest);
+	} else {
+		tlsf_next(block)->size &= ~(size_t)TLSF_PREV_FREE;
+	}
+	block->size &= ~(size_t)TLSF_FREE;
+
+	t->allocs++;
+	t->used += tlsf_size(block) + TLSF_OVERHEAD;
+	if (t->used > t->max_used)
+		t->max_used = t->used;
+	return (void *)block + TLSF_PAYLOAD;
+}
+
+void tlsf_free(struct tlsf *t, void *ptr) {
+	struct tlsf_block *block, *prev, *next;
+
+	if (ptr == NULL)
+		return;
+	block = ptr - TLSF_PAYLOAD;
+	if (block->size & TLSF_FREE)
+		return;
+	t->frees++;
+	t->used -= tlsf_size(block) + TLSF_OVERHEAD;
+
+	if (block->size & TLSF_PREV_FREE) {
+		prev = block->prev_phys;
+		tlsf_remove(t, prev);
+		prev->size += tlsf_size(block) + TLSF_OVERHEAD;
+		block = prev;
+	}
+	next = tlsf_next(block);
+	if (next->size & TLSF_FREE) {
+		tlsf_remove(t, next);
+		block->size += tlsf_size(next) + TLSF_OVERHEAD;
+		next = tlsf_next(block);
+	}
+	block->size |= TLSF_FREE;
+	next->prev_phys = block;
+	next->size |= TLSF_PREV_FREE;
+	tlsf_insert(t, block);
+}
+
+size_t tlsf_largest(struct tlsf *t) {
+	struct tlsf_block *block;
+	size_t largest = 0;
+	int fl, sl;
+
+	if (t->fl_bitmap == 0)
+		return 0;
+	fl = tlsf_fls(t->fl_bitmap);
+	sl = tlsf_fls(t->sl_bitmap[fl]);
+	for (block = t->blocks[fl][sl]; block; block = block->next_free) {
+		if (tlsf_size(block) > largest)
+			largest = tlsf_size(block);
+	}
+	return largest;
+}